@@ -0,0 +1,88 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <nanobench.h>
+
+#include "qiskit/addon/sqd/deduplication.hpp"
+
+#include "synthetic_shots.hpp"
+
+namespace
+{
+
+/// Sum the weights of duplicate shots in a `std::unordered_map`, as a
+/// baseline.
+std::pair<std::vector<boost::dynamic_bitset<>>, std::vector<double>>
+deduplicate_naively(const SyntheticShots &shots)
+{
+    std::unordered_map<boost::dynamic_bitset<>, std::size_t> index;
+    std::vector<boost::dynamic_bitset<>> bitstrings;
+    std::vector<double> weights;
+    for (std::size_t i = 0; i < shots.bitstrings.size(); ++i) {
+        const auto [it, inserted] = index.emplace(shots.bitstrings[i], weights.size());
+        if (inserted) {
+            bitstrings.push_back(shots.bitstrings[i]);
+            weights.push_back(0.0);
+        }
+        weights[it->second] += shots.probabilities[i];
+    }
+    return {std::move(bitstrings), std::move(weights)};
+}
+
+} // namespace
+
+void benchmark_deduplication(ankerl::nanobench::Bench &bench_in)
+{
+    auto bench = bench_in;
+    bench.epochs(3).minEpochIterations(1).warmup(0).unit("shot");
+
+    SyntheticShotOptions options;
+    for (const std::size_t norb : {30, 80}) {
+        options.norb = norb;
+        const auto shots = generate_synthetic_shots(options);
+        bench.title("Deduplicating raw shots, " + std::to_string(norb) + " orbitals");
+        bench.batch(options.num_shots);
+        bench.run("std::unordered_map", [&] {
+            ankerl::nanobench::doNotOptimizeAway(deduplicate_naively(shots));
+        });
+        for (const auto method : {Qiskit::addon::sqd::AggregationMethod::hash_map,
+                                  Qiskit::addon::sqd::AggregationMethod::sort_reduce}) {
+            const std::string name =
+                method == Qiskit::addon::sqd::AggregationMethod::hash_map
+                    ? "hash_map"
+                    : "sort_reduce";
+            bench.run("deduplicate_bitstrings (" + name + ")", [&] {
+                ankerl::nanobench::doNotOptimizeAway(
+                    Qiskit::addon::sqd::deduplicate_bitstrings(
+                        shots.bitstrings, shots.probabilities, method
+                    )
+                );
+            });
+            Qiskit::addon::sqd::ParallelOptions parallel_options;
+            parallel_options.num_threads = std::thread::hardware_concurrency();
+            bench.run("deduplicate_bitstrings (" + name + ", all threads)", [&] {
+                ankerl::nanobench::doNotOptimizeAway(
+                    Qiskit::addon::sqd::deduplicate_bitstrings(
+                        shots.bitstrings, shots.probabilities, parallel_options, method
+                    )
+                );
+            });
+        }
+    }
+}
@@ -14,10 +14,16 @@
 
 extern void benchmark_subsampling(ankerl::nanobench::Bench &bench);
 extern void benchmark_configuration_recovery(ankerl::nanobench::Bench &bench);
+extern void benchmark_pipeline(ankerl::nanobench::Bench &bench);
+extern void benchmark_parsing(ankerl::nanobench::Bench &bench);
+extern void benchmark_deduplication(ankerl::nanobench::Bench &bench);
 
 int main()
 {
     ankerl::nanobench::Bench bench;
     benchmark_subsampling(bench);
     benchmark_configuration_recovery(bench);
+    benchmark_pipeline(bench);
+    benchmark_parsing(bench);
+    benchmark_deduplication(bench);
 }
@@ -0,0 +1,87 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nanobench.h>
+
+#include "qiskit/addon/sqd/parsing.hpp"
+
+#include "synthetic_shots.hpp"
+
+namespace
+{
+
+/// Write shots as a JSON count dictionary, with a count of one each.
+std::string to_json(const SyntheticShots &shots)
+{
+    std::string text = "{";
+    std::string key;
+    for (const auto &bs : shots.bitstrings) {
+        boost::to_string(bs, key);
+        text += text.size() == 1 ? "\"" : ", \"";
+        text += key;
+        text += "\": 1";
+    }
+    text += "}";
+    return text;
+}
+
+/// Parse one character at a time, through `std::string` temporaries, as a
+/// baseline.
+std::vector<boost::dynamic_bitset<>> parse_naively(const std::string &text)
+{
+    std::vector<boost::dynamic_bitset<>> bitstrings;
+    std::size_t pos = 0;
+    while ((pos = text.find('"', pos)) != std::string::npos) {
+        const auto end = text.find('"', pos + 1);
+        bitstrings.emplace_back(text.substr(pos + 1, end - pos - 1));
+        pos = end + 1;
+    }
+    return bitstrings;
+}
+
+} // namespace
+
+void benchmark_parsing(ankerl::nanobench::Bench &bench_in)
+{
+    auto bench = bench_in;
+    bench.epochs(3).minEpochIterations(1).warmup(0).unit("shot");
+
+    SyntheticShotOptions options;
+    options.num_shots = 200000;
+    for (const std::size_t norb : {30, 80}) {
+        options.norb = norb;
+        const auto text = to_json(generate_synthetic_shots(options));
+        bench.title("Parsing a JSON count dictionary, " + std::to_string(norb) +
+                    " orbitals");
+        bench.batch(options.num_shots);
+        bench.run("std::string and boost::dynamic_bitset", [&] {
+            ankerl::nanobench::doNotOptimizeAway(parse_naively(text));
+        });
+        bench.run("parse_counts", [&] {
+            ankerl::nanobench::doNotOptimizeAway(
+                Qiskit::addon::sqd::parse_counts(text)
+            );
+        });
+        Qiskit::addon::sqd::ParallelOptions parallel_options;
+        parallel_options.num_threads = std::thread::hardware_concurrency();
+        bench.run("parse_counts (all threads)", [&] {
+            ankerl::nanobench::doNotOptimizeAway(
+                Qiskit::addon::sqd::parse_counts(text, 0, parallel_options)
+            );
+        });
+    }
+}
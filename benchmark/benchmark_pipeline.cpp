@@ -0,0 +1,206 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nanobench.h>
+
+#include "qiskit/addon/sqd/configuration_recovery.hpp"
+#include "qiskit/addon/sqd/fermion.hpp"
+#include "qiskit/addon/sqd/postselection.hpp"
+#include "qiskit/addon/sqd/random.hpp"
+#include "qiskit/addon/sqd/subsampling.hpp"
+
+#include "resource_usage.hpp"
+#include "synthetic_shots.hpp"
+
+// Benchmarks of the whole preprocessing pipeline, on shots as numerous as
+// those of a large experiment: configuration recovery, then post-selection on
+// the Hamming weights, then subsampling, then conversion to CI strings.
+
+namespace sqd = Qiskit::addon::sqd;
+
+using BitstringVector = std::vector<boost::dynamic_bitset<>>;
+using RNGType = sqd::Xoshiro256StarStar;
+
+namespace
+{
+
+constexpr unsigned int num_batches = 10;
+constexpr unsigned int max_samples_per_batch = 10000;
+
+/// Number of shots, which may be set by the `QKA_SQD_BENCHMARK_SHOTS`
+/// environment variable.
+std::size_t num_shots_from_environment()
+{
+    if (const char *value = std::getenv("QKA_SQD_BENCHMARK_SHOTS")) {
+        return std::strtoull(value, nullptr, 10);
+    }
+    return 1000000;
+}
+
+/// Time `op`, then run it once more to report its allocations and peak memory.
+template <typename FunctionType>
+void run_stage(
+    ankerl::nanobench::Bench &bench, const std::string &name, std::size_t num_inputs,
+    FunctionType &&op
+)
+{
+    bench.batch(std::max<std::size_t>(num_inputs, 1)).run(name, op);
+    const auto usage = measure_resource_usage(op);
+    std::printf(
+        "    %s: %llu allocations, %.1f MiB allocated, peak RSS %.1f MiB\n",
+        name.c_str(), static_cast<unsigned long long>(usage.allocations),
+        static_cast<double>(usage.allocated_bytes) / (1 << 20),
+        static_cast<double>(usage.peak_rss_bytes) / (1 << 20)
+    );
+}
+
+/// Benchmark each stage, and the whole pipeline, on the same shots.
+///
+/// `parallel_options` is either `nullptr`, to use the single-threaded
+/// overloads, or a `ParallelOptions`.  Post-selection has no parallel overload
+/// and always runs on one thread.
+template <typename ParallelType>
+void benchmark_stages(
+    ankerl::nanobench::Bench &bench, const SyntheticShotOptions &options,
+    const SyntheticShots &shots, const ParallelType &parallel_options,
+    const std::string &suffix
+)
+{
+    const auto num_elec = options.num_elec;
+    RNGType rng(options.seed);
+    const auto recover = [&] {
+        if constexpr (std::is_same_v<ParallelType, sqd::ParallelOptions>) {
+            return sqd::recover_configurations<RNGType>(
+                shots.bitstrings, shots.probabilities, shots.avg_occupancies,
+                num_elec, parallel_options
+            );
+        } else {
+            return sqd::recover_configurations(
+                shots.bitstrings, shots.probabilities, shots.avg_occupancies,
+                num_elec, rng
+            );
+        }
+    };
+    const auto postselect = [&](const auto &input) {
+        return sqd::postselect_bitstrings(
+            input.first, input.second,
+            sqd::MatchesRightLeftHamming(num_elec[0], num_elec[1])
+        );
+    };
+    const auto subsample = [&](const auto &input) {
+        const auto samples_per_batch = static_cast<unsigned int>(
+            std::min<std::size_t>(input.first.size(), max_samples_per_batch)
+        );
+        if constexpr (std::is_same_v<ParallelType, sqd::ParallelOptions>) {
+            return sqd::subsample_multiple_batches<RNGType>(
+                input.first, input.second, samples_per_batch, num_batches,
+                parallel_options
+            );
+        } else {
+            return sqd::subsample_multiple_batches(
+                input.first, input.second, samples_per_batch, num_batches, rng
+            );
+        }
+    };
+    const auto to_ci_strings = [&](const auto &batches) {
+        std::size_t num_ci_strings = 0;
+        for (const auto &batch : batches) {
+            if constexpr (std::is_same_v<ParallelType, sqd::ParallelOptions>) {
+                const auto ci_strings = sqd::bitstrings_to_ci_strings_symmetrize_spin(
+                    batch, parallel_options
+                );
+                num_ci_strings += ci_strings.size();
+            } else {
+                num_ci_strings +=
+                    sqd::bitstrings_to_ci_strings_symmetrize_spin(batch).size();
+            }
+        }
+        return num_ci_strings;
+    };
+
+    // The input of each stage, computed once outside of the timings
+    const auto recovered = recover();
+    const auto postselected = postselect(recovered);
+    const auto batches = subsample(postselected);
+    std::size_t num_samples = 0;
+    for (const auto &batch : batches) {
+        num_samples += batch.size();
+    }
+
+    const auto num_shots = shots.bitstrings.size();
+    run_stage(bench, "configuration_recovery" + suffix, num_shots, [&] {
+        ankerl::nanobench::doNotOptimizeAway(recover());
+    });
+    run_stage(bench, "postselection" + suffix, recovered.first.size(), [&] {
+        ankerl::nanobench::doNotOptimizeAway(postselect(recovered));
+    });
+    run_stage(bench, "subsampling" + suffix, postselected.first.size(), [&] {
+        ankerl::nanobench::doNotOptimizeAway(subsample(postselected));
+    });
+    run_stage(bench, "ci_strings" + suffix, num_samples, [&] {
+        ankerl::nanobench::doNotOptimizeAway(to_ci_strings(batches));
+    });
+    run_stage(bench, "pipeline" + suffix, num_shots, [&] {
+        ankerl::nanobench::doNotOptimizeAway(
+            to_ci_strings(subsample(postselect(recover())))
+        );
+    });
+}
+
+} // namespace
+
+void benchmark_pipeline(ankerl::nanobench::Bench &bench_in)
+{
+    // Each run takes seconds at full scale, so repeat only a few times
+    auto bench = bench_in;
+    bench.epochs(3).minEpochIterations(1).warmup(0).unit("shot");
+
+    SyntheticShotOptions options;
+    options.num_shots = num_shots_from_environment();
+
+    bench.title("Pipeline scaling with the number of orbitals, on one thread");
+    for (const std::size_t norb : {30, 50, 80}) {
+        options.norb = norb;
+        const auto shots = generate_synthetic_shots(options);
+        std::printf(
+            "  %zu shots with %zu orbitals\n", shots.bitstrings.size(), norb
+        );
+        benchmark_stages(
+            bench, options, shots, nullptr,
+            " (orbitals: " + std::to_string(norb) + ")"
+        );
+    }
+
+    bench.title("Pipeline scaling with the number of threads");
+    options.norb = 50;
+    const auto shots = generate_synthetic_shots(options);
+    const auto max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        sqd::ParallelOptions parallel_options;
+        parallel_options.seed = options.seed;
+        parallel_options.num_threads = num_threads;
+        benchmark_stages(
+            bench, options, shots, parallel_options,
+            " (threads: " + std::to_string(num_threads) + ")"
+        );
+    }
+}
@@ -0,0 +1,180 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "resource_usage.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#include <fstream>
+#include <string>
+#elif defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// The global allocation functions are replaced so that every allocation made
+// by the library, on any thread, is counted.
+
+namespace
+{
+
+std::atomic<std::uint64_t> allocation_count{0};
+std::atomic<std::uint64_t> allocation_bytes{0};
+
+void *counted_allocate(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *counted_allocate(std::size_t size, std::align_val_t alignment)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+    void *ptr = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    // std::aligned_alloc needs a nonzero multiple of the alignment
+    const auto padded = std::max<std::size_t>((size + align - 1) / align, 1) * align;
+    void *ptr = std::aligned_alloc(align, padded);
+#endif
+    if (ptr) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void free_aligned(void *ptr)
+{
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+std::uint64_t read_peak_rss_bytes()
+{
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stoull(line.substr(6)) * 1024;
+        }
+    }
+    return 0;
+#elif defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+    return 0;
+#endif
+}
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    return counted_allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return counted_allocate(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return counted_allocate(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return counted_allocate(size, alignment);
+}
+
+void operator delete(void *ptr, std::align_val_t /*alignment*/) noexcept
+{
+    free_aligned(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t /*alignment*/) noexcept
+{
+    free_aligned(ptr);
+}
+
+void operator delete(
+    void *ptr, std::size_t /*size*/, std::align_val_t /*alignment*/
+) noexcept
+{
+    free_aligned(ptr);
+}
+
+void operator delete[](
+    void *ptr, std::size_t /*size*/, std::align_val_t /*alignment*/
+) noexcept
+{
+    free_aligned(ptr);
+}
+
+void start_resource_usage()
+{
+#if defined(__linux__)
+    // Writing 5 resets the peak resident set size to the current one
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+    allocation_count = 0;
+    allocation_bytes = 0;
+}
+
+ResourceUsage stop_resource_usage()
+{
+    ResourceUsage usage;
+    usage.allocations = allocation_count;
+    usage.allocated_bytes = allocation_bytes;
+    usage.peak_rss_bytes = read_peak_rss_bytes();
+    return usage;
+}
@@ -0,0 +1,47 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_BENCHMARK_RESOURCE_USAGE_HPP_
+#define QISKIT_ADDON_SQD_BENCHMARK_RESOURCE_USAGE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+/// Allocations and memory use of the benchmark process over some interval.
+struct ResourceUsage {
+    /// Number of calls to the global `operator new`
+    std::uint64_t allocations = 0;
+    /// Total bytes requested from the global `operator new`
+    std::uint64_t allocated_bytes = 0;
+    /// Peak resident set size, in bytes, or 0 if it cannot be measured on this
+    /// platform.  On Linux, the peak is reset at the start of the interval;
+    /// elsewhere, it is the peak over the lifetime of the process.
+    std::uint64_t peak_rss_bytes = 0;
+};
+
+/// Start counting allocations, and reset the peak resident set size if the
+/// platform allows.
+void start_resource_usage();
+
+/// Return the usage since the last call to `start_resource_usage`.
+ResourceUsage stop_resource_usage();
+
+/// Run `op` once, and return its usage.
+template <typename FunctionType>
+ResourceUsage measure_resource_usage(FunctionType &&op)
+{
+    start_resource_usage();
+    op();
+    return stop_resource_usage();
+}
+
+#endif // QISKIT_ADDON_SQD_BENCHMARK_RESOURCE_USAGE_HPP_
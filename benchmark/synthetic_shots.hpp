@@ -0,0 +1,117 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_BENCHMARK_SYNTHETIC_SHOTS_HPP_
+#define QISKIT_ADDON_SQD_BENCHMARK_SYNTHETIC_SHOTS_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "qiskit/addon/sqd/random.hpp"
+
+/// Parameters of a synthetic set of measurement outcomes.
+///
+/// Each shot is drawn as a configuration with exactly `num_elec[s]` electrons in
+/// each spin sector, with orbital occupancies which fall smoothly from 1 to 0
+/// about the Fermi level.  A fraction `error_rate` of the shots is then
+/// corrupted by flipping bits at random, as hardware noise would, which changes
+/// their Hamming weights.
+struct SyntheticShotOptions {
+    std::size_t num_shots = 1000000;
+    /// Number of spatial orbitals, i.e. half the length of each bitstring.
+    std::size_t norb = 50;
+    /// Number of spin-up and spin-down electrons.
+    std::array<std::uint64_t, 2> num_elec{10, 10};
+    /// Width, in orbitals, of the fall of the occupancies about the Fermi level.
+    /// Narrower widths concentrate the shots on fewer configurations.
+    double fermi_width = 2.0;
+    /// Probability that a shot is corrupted.
+    double error_rate = 0.5;
+    /// Mean number of bits flipped in a corrupted shot, which is at least 1.
+    double mean_flips = 2.0;
+    std::uint64_t seed = 0;
+};
+
+struct SyntheticShots {
+    std::vector<boost::dynamic_bitset<>> bitstrings;
+    /// Uniform probabilities, one per shot.
+    std::vector<double> probabilities;
+    /// Occupancies of the model from which the shots were drawn.
+    std::array<std::vector<double>, 2> avg_occupancies;
+};
+
+/// Generate shots as described by `options`.  The result depends only on the
+/// options.
+inline SyntheticShots generate_synthetic_shots(const SyntheticShotOptions &options)
+{
+    using Qiskit::addon::sqd::uniform_below;
+    using Qiskit::addon::sqd::uniform_double;
+    const auto norb = options.norb;
+    Qiskit::addon::sqd::Xoshiro256StarStar rng(options.seed);
+
+    SyntheticShots shots;
+    // Odds of occupation, which weight the orbitals when drawing electrons
+    std::array<std::vector<double>, 2> odds;
+    for (std::size_t s = 0; s < 2; ++s) {
+        const auto fermi_level = static_cast<double>(options.num_elec[s]) - 0.5;
+        for (std::size_t i = 0; i < norb; ++i) {
+            const double occupancy =
+                1.0 / (1.0 + std::exp((i - fermi_level) / options.fermi_width));
+            shots.avg_occupancies[s].push_back(occupancy);
+            odds[s].push_back(occupancy / (1.0 - occupancy + 1e-12));
+        }
+    }
+
+    std::vector<std::pair<double, std::size_t>> keys(norb);
+    shots.bitstrings.reserve(options.num_shots);
+    for (std::size_t shot = 0; shot < options.num_shots; ++shot) {
+        boost::dynamic_bitset<> bitstring(2 * norb);
+        for (std::size_t s = 0; s < 2; ++s) {
+            // Draw the occupied orbitals without replacement, as those with the
+            // smallest exponential keys
+            for (std::size_t i = 0; i < norb; ++i) {
+                keys[i] = {-std::log(1.0 - uniform_double(rng)) / odds[s][i], i};
+            }
+            const auto num_elec = std::min<std::size_t>(options.num_elec[s], norb);
+            std::nth_element(keys.begin(), keys.begin() + num_elec, keys.end());
+            for (std::size_t j = 0; j < num_elec; ++j) {
+                bitstring.set(s * norb + keys[j].second);
+            }
+        }
+        if (uniform_double(rng) < options.error_rate) {
+            // One flip, plus a Poisson-distributed number more
+            std::size_t num_flips = 1;
+            const double threshold = std::exp(-(options.mean_flips - 1.0));
+            for (double product = uniform_double(rng); product > threshold;
+                 product *= uniform_double(rng)) {
+                ++num_flips;
+            }
+            for (std::size_t j = 0; j < num_flips; ++j) {
+                bitstring.flip(uniform_below(rng, 2 * norb));
+            }
+        }
+        shots.bitstrings.push_back(std::move(bitstring));
+    }
+    shots.probabilities.assign(
+        options.num_shots, 1.0 / static_cast<double>(options.num_shots)
+    );
+    return shots;
+}
+
+#endif // QISKIT_ADDON_SQD_BENCHMARK_SYNTHETIC_SHOTS_HPP_
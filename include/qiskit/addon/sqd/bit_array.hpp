@@ -0,0 +1,642 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_BIT_ARRAY_HPP_
+#define QISKIT_ADDON_SQD_BIT_ARRAY_HPP_
+
+/// Bitstrings in the byte-packed layout of Qiskit's `BitArray`, processed in
+/// place (requires `boost::dynamic_bitset`)
+
+#include "qiskit/addon/sqd/borrowing_vector.hpp"
+#include "qiskit/addon/sqd/internal/bitset_common.hpp"
+#include "qiskit/addon/sqd/internal/exception-macros.hpp"
+#include "qiskit/addon/sqd/internal/proxy-iterator.hpp"
+#include "qiskit/addon/sqd/support/boost_dynamic_bitset.hpp"
+
+#if __has_include(<boost/dynamic_bitset.hpp>)
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+namespace internal
+{
+
+/// Number of bytes needed to hold `num_bits` bits
+constexpr std::size_t bytes_for_bits(std::size_t num_bits)
+{
+    return (num_bits + 7) / 8;
+}
+
+/// Load word `i` of a big-endian bitstring of `num_bytes` bytes, that is, its
+/// bits `64 * i` to `64 * i + 63`.
+inline std::uint64_t
+load_big_endian_word(const std::uint8_t *bytes, std::size_t num_bytes, std::size_t i)
+{
+    // The least significant byte of the word is at `end - 1`
+    const auto end = num_bytes - 8 * i;
+    if (end >= 8) {
+        // Compilers fuse this into a single load and byte swap
+        const auto *p = bytes + end - 8;
+        return (std::uint64_t{p[0]} << 56) | (std::uint64_t{p[1]} << 48) |
+               (std::uint64_t{p[2]} << 40) | (std::uint64_t{p[3]} << 32) |
+               (std::uint64_t{p[4]} << 24) | (std::uint64_t{p[5]} << 16) |
+               (std::uint64_t{p[6]} << 8) | std::uint64_t{p[7]};
+    }
+    // The most significant word may be partial
+    std::uint64_t word = 0;
+    for (std::size_t b = 0; b < end; ++b) {
+        word = (word << 8) | bytes[b];
+    }
+    return word;
+}
+
+/// Store the `num_bytes` bytes of a big-endian bitstring from its words, least
+/// significant word first.
+inline void store_big_endian_bytes(
+    const std::uint64_t *words, std::size_t num_bytes, std::uint8_t *bytes
+)
+{
+    for (std::size_t j = 0; j < num_bytes; ++j) {
+        const auto word = words[j / 8];
+        bytes[num_bytes - 1 - j] = static_cast<std::uint8_t>(word >> (8 * (j % 8)));
+    }
+}
+
+} // namespace internal
+
+/// Read-only reference to a single bitstring stored in a `BitArrayVector`.
+class ConstBitArrayRef
+{
+  protected:
+    const std::uint8_t *bytes_;
+    std::size_t num_bits_;
+
+  public:
+    /// Type to which the referenced bitstring can be converted
+    using value_type = boost::dynamic_bitset<std::uint64_t>;
+
+    /// Constructor
+    ///
+    /// @param[in] bytes Pointer to the `internal::bytes_for_bits(num_bits)` bytes
+    ///     of the bitstring, most significant byte first.  Any bits beyond
+    ///     `num_bits` in the first byte must be zero.
+    /// @param[in] num_bits Number of bits in the bitstring.
+    ConstBitArrayRef(const std::uint8_t *bytes, std::size_t num_bits)
+      : bytes_(bytes), num_bits_(num_bits)
+    {
+    }
+
+    /// Return the number of bits
+    std::size_t size() const
+    {
+        return num_bits_;
+    }
+
+    /// Return the number of bytes holding the bits
+    std::size_t num_bytes() const
+    {
+        return internal::bytes_for_bits(num_bits_);
+    }
+
+    /// Return a pointer to the bytes holding the bits, most significant first
+    const std::uint8_t *bytes() const
+    {
+        return bytes_;
+    }
+
+    /// Return the number of 64-bit words spanned by the bits
+    std::size_t num_words() const
+    {
+        return internal::words_for_bits(num_bits_);
+    }
+
+    /// Return bits `64 * i` to `64 * i + 63` as a word
+    std::uint64_t word(std::size_t i) const
+    {
+        return internal::load_big_endian_word(bytes_, num_bytes(), i);
+    }
+
+    /// Return the value of bit `pos`
+    bool test(std::size_t pos) const
+    {
+        return ((bytes_[num_bytes() - 1 - pos / 8] >> (pos % 8)) & 1) != 0;
+    }
+
+    /// Return the value of bit `pos`
+    bool operator[](std::size_t pos) const
+    {
+        return test(pos);
+    }
+
+    /// Return the number of set bits
+    std::size_t count() const
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < num_words(); ++i) {
+            count += internal::popcount64(word(i));
+        }
+        return count;
+    }
+
+    /// Return `true` if any bit is set
+    bool any() const
+    {
+        return std::any_of(bytes_, bytes_ + num_bytes(), [](std::uint8_t byte) {
+            return byte != 0;
+        });
+    }
+
+    /// Return `true` if no bit is set
+    bool none() const
+    {
+        return !any();
+    }
+
+    /// Copy the referenced bitstring into a `boost::dynamic_bitset`
+    operator value_type() const
+    {
+        value_type retval;
+        for (std::size_t i = 0; i < num_words(); ++i) {
+            retval.append(word(i));
+        }
+        retval.resize(num_bits_);
+        return retval;
+    }
+
+    /// Compare two referenced bitstrings
+    friend bool operator==(const ConstBitArrayRef &a, const ConstBitArrayRef &b)
+    {
+        return a.num_bits_ == b.num_bits_ &&
+               std::equal(a.bytes_, a.bytes_ + a.num_bytes(), b.bytes_);
+    }
+
+    /// Compare two referenced bitstrings
+    friend bool operator!=(const ConstBitArrayRef &a, const ConstBitArrayRef &b)
+    {
+        return !(a == b);
+    }
+
+    /// Compare a referenced bitstring with a `boost::dynamic_bitset` of any
+    /// block type
+    template <typename Block, typename Allocator>
+    friend bool operator==(
+        const ConstBitArrayRef &a, const boost::dynamic_bitset<Block, Allocator> &b
+    )
+    {
+        if (a.num_bits_ != b.size()) {
+            return false;
+        }
+        std::vector<std::uint64_t> words(a.num_words());
+        internal::WordsImpl<boost::dynamic_bitset<Block, Allocator>>::copy(
+            b, words.data()
+        );
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            if (a.word(i) != words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Compare a referenced bitstring with a `boost::dynamic_bitset` of any
+    /// block type
+    template <typename Block, typename Allocator>
+    friend bool operator==(
+        const boost::dynamic_bitset<Block, Allocator> &a, const ConstBitArrayRef &b
+    )
+    {
+        return b == a;
+    }
+};
+
+/// Mutable reference to a single bitstring stored in a `BitArrayVector`.
+class BitArrayRef : public ConstBitArrayRef
+{
+  private:
+    std::uint8_t *mutable_bytes() const
+    {
+        return const_cast<std::uint8_t *>(bytes_);
+    }
+
+  public:
+    /// Constructor
+    ///
+    /// @param[in] bytes Pointer to the `internal::bytes_for_bits(num_bits)` bytes
+    ///     of the bitstring, most significant byte first.
+    /// @param[in] num_bits Number of bits in the bitstring.
+    BitArrayRef(std::uint8_t *bytes, std::size_t num_bits)
+      : ConstBitArrayRef(bytes, num_bits)
+    {
+    }
+
+    BitArrayRef(const BitArrayRef &) = default;
+
+    /// Overwrite the referenced bitstring with another of the same size
+    BitArrayRef &operator=(const ConstBitArrayRef &other)
+    {
+        if (other.size() != num_bits_) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_("Bitstring sizes do not match");
+        }
+        std::copy(other.bytes(), other.bytes() + num_bytes(), mutable_bytes());
+        return *this;
+    }
+
+    /// Overwrite the referenced bitstring with another of the same size
+    BitArrayRef &operator=(const BitArrayRef &other)
+    {
+        return *this = static_cast<const ConstBitArrayRef &>(other);
+    }
+
+    /// Overwrite the referenced bitstring with a `boost::dynamic_bitset`, of any
+    /// block type, of the same size
+    template <typename Block, typename Allocator>
+    BitArrayRef &operator=(const boost::dynamic_bitset<Block, Allocator> &other)
+    {
+        if (other.size() != num_bits_) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_("Bitstring sizes do not match");
+        }
+        std::vector<std::uint64_t> words(num_words());
+        internal::WordsImpl<boost::dynamic_bitset<Block, Allocator>>::copy(
+            other, words.data()
+        );
+        internal::store_big_endian_bytes(words.data(), num_bytes(), mutable_bytes());
+        return *this;
+    }
+
+    /// Set bit `pos` to `value`
+    const BitArrayRef &set(std::size_t pos, bool value = true) const
+    {
+        auto &byte = mutable_bytes()[num_bytes() - 1 - pos / 8];
+        const auto mask = static_cast<std::uint8_t>(1u << (pos % 8));
+        if (value) {
+            byte |= mask;
+        } else {
+            byte &= static_cast<std::uint8_t>(~mask);
+        }
+        return *this;
+    }
+
+    /// Clear bit `pos`
+    const BitArrayRef &reset(std::size_t pos) const
+    {
+        return set(pos, false);
+    }
+
+    /// Toggle bit `pos`
+    const BitArrayRef &flip(std::size_t pos) const
+    {
+        mutable_bytes()[num_bytes() - 1 - pos / 8] ^=
+            static_cast<std::uint8_t>(1u << (pos % 8));
+        return *this;
+    }
+};
+
+/// Container of bitstrings of uniform length in the layout of the array of a
+/// Qiskit `BitArray`, as returned by the Qiskit samplers.
+///
+/// Each bitstring occupies `bytes_per_bitstring()` consecutive bytes, most
+/// significant byte first, so bit `i` is bit `i % 8` of byte
+/// `bytes_per_bitstring() - 1 - i / 8`, and any unused bits in its first byte
+/// are zero.  Elements are accessed through the proxy types `BitArrayRef` and
+/// `ConstBitArrayRef`, which read the bytes a 64-bit word at a time and convert
+/// to `value_type` on demand.  As with `std::vector<bool>`, `auto x = v[i]`
+/// yields a reference, not a copy.
+///
+/// To process the output of a sampler without copying or unpacking it, borrow
+/// its array with `BitArrayVector::borrow` and pass the container, through a
+/// const reference, as the `BitstringVectorType` of the functions in this
+/// library.  These return containers of the same type as their input, which own
+/// their bytes.  As with `BorrowingVector`, any non-const access to a borrowed
+/// container copies the borrowed bytes first.
+///
+/// A default-constructed container adopts the length of the first bitstring
+/// added to it.
+class BitArrayVector
+{
+  private:
+    BorrowingVector<std::uint8_t> bytes_;
+    std::size_t num_bits_ = 0;
+    std::size_t bytes_per_bitstring_ = 0;
+    std::size_t size_ = 0;
+
+    void adopt_num_bits(std::size_t num_bits)
+    {
+        if (num_bits == num_bits_) {
+            return;
+        }
+        if (size_ != 0 || num_bits_ != 0) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Bitstring length does not match the length of the container"
+            );
+        }
+        num_bits_ = num_bits;
+        bytes_per_bitstring_ = internal::bytes_for_bits(num_bits);
+    }
+
+    std::uint8_t *append_zeroed()
+    {
+        bytes_.resize(bytes_.size() + bytes_per_bitstring_);
+        ++size_;
+        return bytes_.data() + bytes_.size() - bytes_per_bitstring_;
+    }
+
+  public:
+    /// Type of the bitstrings as returned by value
+    using value_type = boost::dynamic_bitset<std::uint64_t>;
+    using reference = BitArrayRef;
+    using const_reference = ConstBitArrayRef;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator = internal::ProxyIterator<BitArrayVector, false>;
+    using const_iterator = internal::ProxyIterator<BitArrayVector, true>;
+
+    /// Construct an empty container, which adopts the length of the first
+    /// bitstring added to it.
+    BitArrayVector() = default;
+
+    /// Construct a container holding `count` bitstrings of `num_bits` bits each,
+    /// all of which are zero.
+    explicit BitArrayVector(std::size_t num_bits, std::size_t count = 0)
+      : bytes_(internal::bytes_for_bits(num_bits) * count), num_bits_(num_bits),
+        bytes_per_bitstring_(internal::bytes_for_bits(num_bits)), size_(count)
+    {
+    }
+
+    /// Construct a container which borrows its bytes.
+    ///
+    /// @param[in] bytes Pointer to the `count * internal::bytes_for_bits(num_bits)`
+    ///     bytes of the bitstrings, laid out as described above, which must
+    ///     outlive the container and every copy of it.
+    /// @param[in] num_bits Number of bits in each bitstring
+    /// @param[in] count Number of bitstrings
+    static BitArrayVector
+    borrow(const std::uint8_t *bytes, std::size_t num_bits, std::size_t count)
+    {
+        BitArrayVector retval(num_bits);
+        retval.bytes_ = BorrowingVector<std::uint8_t>::borrow(
+            bytes, count * retval.bytes_per_bitstring_
+        );
+        retval.size_ = count;
+        return retval;
+    }
+
+    /// Return `true` if the bytes are borrowed
+    bool is_borrowed() const
+    {
+        return bytes_.is_borrowed();
+    }
+
+    /// Return the number of bits in each bitstring
+    std::size_t num_bits() const
+    {
+        return num_bits_;
+    }
+
+    /// Return the number of bytes occupied by each bitstring
+    std::size_t bytes_per_bitstring() const
+    {
+        return bytes_per_bitstring_;
+    }
+
+    /// Return a pointer to the underlying byte matrix
+    const std::uint8_t *data() const
+    {
+        return bytes_.data();
+    }
+
+    /// Return a pointer to the underlying byte matrix, copying it first if it
+    /// is borrowed
+    std::uint8_t *data()
+    {
+        return bytes_.data();
+    }
+
+    /// Return the number of bitstrings
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /// Return `true` if the container holds no bitstrings
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    /// Reserve storage for at least `count` bitstrings
+    void reserve(std::size_t count)
+    {
+        bytes_.reserve(count * bytes_per_bitstring_);
+    }
+
+    /// Remove all bitstrings, keeping the bitstring length
+    void clear()
+    {
+        bytes_.clear();
+        size_ = 0;
+    }
+
+    /// Resize to hold `count` bitstrings, zero-initializing any new ones
+    void resize(std::size_t count)
+    {
+        bytes_.resize(count * bytes_per_bitstring_);
+        size_ = count;
+    }
+
+    /// Access bitstring `pos`
+    reference operator[](std::size_t pos)
+    {
+        return {data() + pos * bytes_per_bitstring_, num_bits_};
+    }
+
+    /// Access bitstring `pos`
+    const_reference operator[](std::size_t pos) const
+    {
+        return {data() + pos * bytes_per_bitstring_, num_bits_};
+    }
+
+    /// Access the first bitstring
+    reference front()
+    {
+        return (*this)[0];
+    }
+
+    /// Access the first bitstring
+    const_reference front() const
+    {
+        return (*this)[0];
+    }
+
+    /// Access the last bitstring
+    reference back()
+    {
+        return (*this)[size_ - 1];
+    }
+
+    /// Access the last bitstring
+    const_reference back() const
+    {
+        return (*this)[size_ - 1];
+    }
+
+    iterator begin()
+    {
+        return {this, 0};
+    }
+    iterator end()
+    {
+        return {this, static_cast<std::ptrdiff_t>(size_)};
+    }
+    const_iterator begin() const
+    {
+        return {this, 0};
+    }
+    const_iterator end() const
+    {
+        return {this, static_cast<std::ptrdiff_t>(size_)};
+    }
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /// Append a copy of a referenced bitstring
+    void push_back(const_reference bitstring)
+    {
+        adopt_num_bits(bitstring.size());
+        // The source may live in this container, so copy it by offset after
+        // the storage is possibly reallocated.
+        const auto *owned = static_cast<const BitArrayVector &>(*this).data();
+        if (!is_borrowed() && bitstring.bytes() >= owned &&
+            bitstring.bytes() < owned + bytes_.size()) {
+            const auto offset = static_cast<std::size_t>(bitstring.bytes() - owned);
+            auto *dest = append_zeroed();
+            std::copy_n(bytes_.data() + offset, bytes_per_bitstring_, dest);
+            return;
+        }
+        auto *dest = append_zeroed();
+        std::copy_n(bitstring.bytes(), bytes_per_bitstring_, dest);
+    }
+
+    /// Append a copy of a `boost::dynamic_bitset` of any block type
+    template <typename Block, typename Allocator>
+    void push_back(const boost::dynamic_bitset<Block, Allocator> &bitstring)
+    {
+        adopt_num_bits(bitstring.size());
+        std::vector<std::uint64_t> words(internal::words_for_bits(num_bits_));
+        internal::WordsImpl<boost::dynamic_bitset<Block, Allocator>>::copy(
+            bitstring, words.data()
+        );
+        internal::store_big_endian_bytes(
+            words.data(), bytes_per_bitstring_, append_zeroed()
+        );
+    }
+
+    /// Append a copy of a bitstring
+    template <typename BitstringType>
+    void emplace_back(const BitstringType &bitstring)
+    {
+        push_back(bitstring);
+    }
+
+    /// Remove the last bitstring
+    void pop_back()
+    {
+        bytes_.resize(bytes_.size() - bytes_per_bitstring_);
+        --size_;
+    }
+
+    /// Compare two containers element-wise
+    friend bool operator==(const BitArrayVector &a, const BitArrayVector &b)
+    {
+        return a.size_ == b.size_ && a.num_bits_ == b.num_bits_ && a.bytes_ == b.bytes_;
+    }
+
+    /// Compare two containers element-wise
+    friend bool operator!=(const BitArrayVector &a, const BitArrayVector &b)
+    {
+        return !(a == b);
+    }
+};
+
+namespace internal
+{
+
+template <>
+struct HalfSizeImpl<ConstBitArrayRef> {
+    using type = ConstBitArrayRef::value_type;
+};
+
+template <>
+struct HalfSizeImpl<BitArrayRef> {
+    using type = ConstBitArrayRef::value_type;
+};
+
+template <>
+struct RightLeftHammingImpl<ConstBitArrayRef> {
+    static std::array<std::size_t, 2> count(const ConstBitArrayRef &bitstring)
+    {
+        RightLeftWordCounter<std::uint64_t> counter(bitstring.size() / 2);
+        for (std::size_t i = 0; i < bitstring.num_words(); ++i) {
+            counter(bitstring.word(i));
+        }
+        return counter.counts();
+    }
+};
+
+template <>
+struct RightLeftHammingImpl<BitArrayRef> : RightLeftHammingImpl<ConstBitArrayRef> {
+};
+
+template <>
+struct WordsImpl<ConstBitArrayRef> {
+    static void copy(const ConstBitArrayRef &bitstring, std::uint64_t *words)
+    {
+        for (std::size_t i = 0; i < bitstring.num_words(); ++i) {
+            words[i] = bitstring.word(i);
+        }
+    }
+};
+
+template <>
+struct WordsImpl<BitArrayRef> : WordsImpl<ConstBitArrayRef> {
+};
+
+} // namespace internal
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // __has_include(<boost/dynamic_bitset.hpp>)
+
+#endif // QISKIT_ADDON_SQD_BIT_ARRAY_HPP_
@@ -16,6 +16,10 @@
 /// Interfaces/utilities for supporting a variety of bitset types.
 
 #include "qiskit/addon/sqd/internal/bitset_common.hpp"
+#include "qiskit/addon/sqd/native_bitstring_vector.hpp"
+#include "qiskit/addon/sqd/packed_bitstrings.hpp"
+#include "qiskit/addon/sqd/support/bitset2.hpp"
 #include "qiskit/addon/sqd/support/boost_dynamic_bitset.hpp"
+#include "qiskit/addon/sqd/support/native_bitstrings.hpp"
 
 #endif // QISKIT_ADDON_SQD_BITSET_FULL_HPP_
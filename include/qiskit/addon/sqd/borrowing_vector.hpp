@@ -0,0 +1,250 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_BORROWING_VECTOR_HPP_
+#define QISKIT_ADDON_SQD_BORROWING_VECTOR_HPP_
+
+/// Vector which may borrow its elements from memory it does not own
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+/// Contiguous vector of `T` which either owns its elements, like a
+/// `std::vector<T>`, or borrows them, read-only, from memory owned elsewhere,
+/// such as a memory-mapped file (see `BorrowingVector::borrow`).
+///
+/// Const member functions read borrowed elements in place.  Any non-const
+/// member function which could modify the elements first copies them into
+/// storage of its own, so a borrowed vector should be accessed through a const
+/// reference to avoid copying it.  A copy of a borrowed vector borrows the same
+/// elements.  The borrowed memory must outlive every vector which borrows it.
+///
+/// This can be used as the `WeightVectorType` of the functions in this library,
+/// which return vectors of the same type as their input, which own their
+/// elements.
+template <typename T>
+class BorrowingVector
+{
+  private:
+    std::vector<T> owned_;
+    const T *borrowed_ = nullptr;
+    std::size_t borrowed_size_ = 0;
+
+    // Copy the borrowed elements, if any, into owned storage
+    void own()
+    {
+        if (borrowed_ != nullptr) {
+            owned_.assign(borrowed_, borrowed_ + borrowed_size_);
+            borrowed_ = nullptr;
+            borrowed_size_ = 0;
+        }
+    }
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    /// Construct an empty vector
+    BorrowingVector() = default;
+
+    /// Construct a vector owning `count` copies of `value`
+    explicit BorrowingVector(std::size_t count, const T &value = T())
+      : owned_(count, value)
+    {
+    }
+
+    /// Construct a vector owning a copy of the elements of `[first, last)`
+    template <typename InputIterator>
+    BorrowingVector(InputIterator first, InputIterator last) : owned_(first, last)
+    {
+    }
+
+    /// Construct a vector which borrows the `count` elements at `data`, which
+    /// must outlive it and every copy of it.
+    static BorrowingVector borrow(const T *data, std::size_t count)
+    {
+        BorrowingVector retval;
+        retval.borrowed_ = data;
+        retval.borrowed_size_ = count;
+        return retval;
+    }
+
+    /// Return `true` if the elements are borrowed
+    bool is_borrowed() const
+    {
+        return borrowed_ != nullptr;
+    }
+
+    /// Return the number of elements
+    std::size_t size() const
+    {
+        return borrowed_ != nullptr ? borrowed_size_ : owned_.size();
+    }
+
+    /// Return `true` if the vector holds no elements
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /// Return a pointer to the elements
+    const T *data() const
+    {
+        return borrowed_ != nullptr ? borrowed_ : owned_.data();
+    }
+
+    /// Return a pointer to the elements, copying them first if they are
+    /// borrowed
+    T *data()
+    {
+        own();
+        return owned_.data();
+    }
+
+    /// Access element `pos`
+    const T &operator[](std::size_t pos) const
+    {
+        return data()[pos];
+    }
+
+    /// Access element `pos`, copying the elements first if they are borrowed
+    T &operator[](std::size_t pos)
+    {
+        return data()[pos];
+    }
+
+    /// Access the first element
+    const T &front() const
+    {
+        return data()[0];
+    }
+
+    /// Access the last element
+    const T &back() const
+    {
+        return data()[size() - 1];
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+    const_iterator end() const
+    {
+        return data() + size();
+    }
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+    const_iterator cend() const
+    {
+        return end();
+    }
+    iterator begin()
+    {
+        return data();
+    }
+    iterator end()
+    {
+        return data() + size();
+    }
+
+    /// Reserve owned storage for at least `count` elements
+    void reserve(std::size_t count)
+    {
+        own();
+        owned_.reserve(count);
+    }
+
+    /// Remove all elements, releasing any borrowed ones
+    void clear()
+    {
+        borrowed_ = nullptr;
+        borrowed_size_ = 0;
+        owned_.clear();
+    }
+
+    /// Resize to hold `count` elements, value-initializing any new ones
+    void resize(std::size_t count)
+    {
+        own();
+        owned_.resize(count);
+    }
+
+    /// Resize to hold `count` elements, copying `value` into any new ones
+    void resize(std::size_t count, const T &value)
+    {
+        own();
+        owned_.resize(count, value);
+    }
+
+    /// Append a copy of `value`
+    void push_back(const T &value)
+    {
+        own();
+        owned_.push_back(value);
+    }
+
+    /// Append an element constructed from `args`
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        own();
+        return owned_.emplace_back(std::forward<Args>(args)...);
+    }
+
+    /// Remove the last element
+    void pop_back()
+    {
+        own();
+        owned_.pop_back();
+    }
+
+    /// Compare two vectors element-wise
+    friend bool operator==(const BorrowingVector &a, const BorrowingVector &b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    /// Compare two vectors element-wise
+    friend bool operator!=(const BorrowingVector &a, const BorrowingVector &b)
+    {
+        return !(a == b);
+    }
+};
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // QISKIT_ADDON_SQD_BORROWING_VECTOR_HPP_
@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <array>
+#include <bitset>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
@@ -25,13 +26,20 @@
 #include <optional>
 #include <random>
 #include <sstream>
-#include <unordered_map>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "qiskit/addon/sqd/bitset_full.hpp"
+#include "qiskit/addon/sqd/deduplication.hpp"
 #include "qiskit/addon/sqd/internal/concepts.hpp"
 #include "qiskit/addon/sqd/internal/exception-macros.hpp"
+#include "qiskit/addon/sqd/internal/flat-hash-map.hpp"
+#include "qiskit/addon/sqd/internal/parallel.hpp"
+#include "qiskit/addon/sqd/internal/radix-sort.hpp"
 #include "qiskit/addon/sqd/internal/sample-without-replacement.hpp"
+#include "qiskit/addon/sqd/postselection.hpp"
 
 namespace Qiskit
 {
@@ -57,7 +65,7 @@ void _normalize(WeightVectorType &probs)
 }
 
 // NOLINTBEGIN(bugprone-easily-swappable-parameters)
-double _p_flip_0_to_1(double ratio_exp, double occ, double eps = 0.01)
+inline double _p_flip_0_to_1(double ratio_exp, double occ, double eps = 0.01)
 {
     // Occupancy is less than the naive expectation.
     // Flip 0s to 1 with small (<eps) probability in this case.
@@ -77,7 +85,7 @@ double _p_flip_0_to_1(double ratio_exp, double occ, double eps = 0.01)
     return occ * slope + intercept;
 }
 
-double _p_flip_1_to_0(double ratio_exp, double occ, double eps = 0.01)
+inline double _p_flip_1_to_0(double ratio_exp, double occ, double eps = 0.01)
 {
     return _p_flip_0_to_1(1.0 - ratio_exp, 1.0 - occ, eps);
 }
@@ -101,13 +109,301 @@ mask_lower_n_bits(const BitstringType &bitstring, unsigned int n)
     return retval;
 }
 
+// Fill `probs_table` with the probabilities of flipping each bit, resizing its
+// vectors only if the number of orbitals has changed.
+inline void _fill_probs_table(
+    std::array<std::array<std::vector<double>, 2>, 2> &probs_table,
+    const std::array<std::vector<double>, 2> &avg_occupancies,
+    std::array<std::uint64_t, 2> num_elec
+)
+{
+    const auto partition_size = avg_occupancies[0].size();
+    if (avg_occupancies[1].size() != partition_size) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Average occupancies vectors must have matching number of alpha and beta "
+            "orbitals."
+        );
+    }
+    if (num_elec[0] > partition_size || num_elec[1] > partition_size) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Desired Hamming weight cannot be larger than the number of orbitals."
+        );
+    }
+
+    // Populate the probabilities table
+    for (int s = 0; s < 2; ++s) {
+        probs_table[s][0].resize(partition_size);
+        probs_table[s][1].resize(partition_size);
+        // NOLINTBEGIN(bugprone-narrowing-conversions)
+        double density_s = static_cast<double>(num_elec[s]) / partition_size;
+        // NOLINTEND(bugprone-narrowing-conversions)
+        for (std::size_t i = 0; i < partition_size; ++i) {
+            const auto occ = std::max(0.0, std::min(1.0, avg_occupancies[s][i]));
+            probs_table[s][0][i] = _p_flip_0_to_1(density_s, occ);
+            probs_table[s][1][i] = _p_flip_1_to_0(density_s, occ);
+        }
+    }
+}
+
+inline std::array<std::array<std::vector<double>, 2>, 2> _make_probs_table(
+    const std::array<std::vector<double>, 2> &avg_occupancies,
+    std::array<std::uint64_t, 2> num_elec
+)
+{
+    std::array<std::array<std::vector<double>, 2>, 2> probs_table;
+    _fill_probs_table(probs_table, avg_occupancies, num_elec);
+    return probs_table;
+}
+
+// Scratch space for correcting bitstrings, reused from one bitstring to the
+// next, so that correcting a bitstring allocates nothing once it has grown to
+// fit.
+struct CorrectionScratch {
+    // Words of the bitstring being corrected (see `WordsImpl`)
+    std::vector<std::uint64_t> words;
+    // Positions of the bits of the RIGHT (alpha) and LEFT (beta) halves which
+    // may be flipped, and the probabilities of flipping them
+    std::array<std::vector<std::size_t>, 2> indices;
+    std::array<std::vector<double>, 2> weights;
+};
+
+// Collect the bits of each half of the bitstring held in `words` which may be
+// flipped to reach the target Hamming weights, and return the number to flip in
+// each half.  The bitstring is scanned a word at a time, visiting only the
+// candidate bits.
+//
+// `probs_table[s][flip]` must hold at least `norb` probabilities, and `indices`
+// and `weights` may be `std::vector`s or `InlineVector`s.
+template <typename ProbsTableType, typename IndexVectorType, typename WeightVectorType>
+std::array<std::uint64_t, 2> _gather_flip_candidates(
+    const std::uint64_t *words, std::size_t norb, const ProbsTableType &probs_table,
+    std::array<std::uint64_t, 2> num_elec, std::array<IndexVectorType, 2> &indices,
+    std::array<WeightVectorType, 2> &weights
+)
+{
+    std::array<std::uint64_t, 2> num_flip{0, 0};
+    for (std::size_t s = 0; s < 2; ++s) {
+        indices[s].clear();
+        weights[s].clear();
+        const auto offset = s * norb;
+        const std::uint64_t hamming_weight =
+            count_bits_in_range(words, offset, offset + norb);
+        if (hamming_weight == num_elec[s]) {
+            continue;
+        }
+        // 1 or 0 depending on which should be flipped
+        const bool flip = hamming_weight > num_elec[s];
+        num_flip[s] =
+            flip ? hamming_weight - num_elec[s] : num_elec[s] - hamming_weight;
+        const auto &flip_probs = probs_table[s][flip];
+        for (std::size_t begin = 0; begin < norb; begin += 64) {
+            const auto num_bits = std::min<std::size_t>(64, norb - begin);
+            std::uint64_t word = 0;
+            extract_bits(words, offset + begin, num_bits, &word);
+            if (!flip) {
+                word = ~word & low_bits_mask(num_bits);
+            }
+            for (; word != 0; word &= word - 1) {
+                const auto j = begin + countr_zero64(word);
+                indices[s].push_back(offset + j);
+                weights[s].push_back(flip_probs[j]);
+            }
+        }
+    }
+    return num_flip;
+}
+
+// Collect the candidate bits of `bitstring` into `scratch` (see above).
+template <typename BitstringType>
+std::array<std::uint64_t, 2> _gather_flip_candidates(
+    const BitstringType &bitstring,
+    const std::array<std::array<std::vector<double>, 2>, 2> &probs_table,
+    std::array<std::uint64_t, 2> num_elec, CorrectionScratch &scratch
+)
+{
+    // The number of bits should be even - this was already checked in the calling
+    // function
+    const auto partition_size = probs_table[0][0].size();
+    scratch.words.resize(words_for_bits(2 * partition_size));
+    WordsImpl<BitstringType>::copy(bitstring, scratch.words.data());
+    return _gather_flip_candidates(
+        scratch.words.data(), partition_size, probs_table, num_elec, scratch.indices,
+        scratch.weights
+    );
+}
+
+inline void _flip_bit(std::uint64_t *words, std::size_t i)
+{
+    words[i / 64] ^= std::uint64_t{1} << (i % 64);
+}
+
+// Corrects bitstrings held as arrays of words (see `WordsImpl`), for any number
+// of orbitals.  Each thread needs its own, for the scratch space.
+class WordsCorrector
+{
+  private:
+    const std::array<std::array<std::vector<double>, 2>, 2> *probs_table;
+    std::array<std::uint64_t, 2> num_elec;
+    CorrectionScratch scratch;
+
+  public:
+    WordsCorrector(
+        const std::array<std::array<std::vector<double>, 2>, 2> &probs_table,
+        std::array<std::uint64_t, 2> num_elec
+    )
+      : probs_table(&probs_table), num_elec(num_elec)
+    {
+    }
+
+    template <QKA_SQD_CONCEPT_RNG_(RNGType)>
+    void correct(std::uint64_t *words, RNGType &rng, SamplingMethod sampling_method)
+    {
+        const auto num_flip = _gather_flip_candidates(
+            words, (*probs_table)[0][0].size(), *probs_table, num_elec,
+            scratch.indices, scratch.weights
+        );
+        for (std::size_t s = 0; s < 2; ++s) {
+            if (num_flip[s] == 0) {
+                continue;
+            }
+            const auto &indices = scratch.indices[s];
+            visit_sampler(sampling_method, scratch.weights[s], [&](auto &sampler) {
+                for (std::uint64_t i = 0; i < num_flip[s]; ++i) {
+                    _flip_bit(words, indices[sampler(rng)]);
+                }
+            });
+        }
+    }
+};
+
+// Corrects bitstrings held as arrays of words, for at most `MaxNOrb` orbitals
+// per spin sector, or exactly `MaxNOrb` if `ExactNOrb`.  The flip probabilities
+// are held in `std::array`s, and the candidate bits and the samplers in
+// fixed-size buffers on the stack, so `correct` allocates nothing and reads no
+// shared mutable state; a single instance may serve every thread.
+template <std::size_t MaxNOrb, bool ExactNOrb = false>
+class FixedSizeCorrector
+{
+  private:
+    std::size_t norb_;
+    std::array<std::uint64_t, 2> num_elec;
+    std::array<std::array<std::array<double, MaxNOrb>, 2>, 2> probs_table;
+
+    std::size_t norb() const
+    {
+        if constexpr (ExactNOrb) {
+            return MaxNOrb;
+        } else {
+            return norb_;
+        }
+    }
+
+  public:
+    FixedSizeCorrector(
+        const std::array<std::array<std::vector<double>, 2>, 2> &probs_table,
+        std::array<std::uint64_t, 2> num_elec
+    )
+      : norb_(probs_table[0][0].size()), num_elec(num_elec), probs_table{}
+    {
+        assert(ExactNOrb ? norb_ == MaxNOrb : norb_ <= MaxNOrb);
+        for (std::size_t s = 0; s < 2; ++s) {
+            for (std::size_t flip = 0; flip < 2; ++flip) {
+                std::copy(
+                    probs_table[s][flip].begin(), probs_table[s][flip].end(),
+                    this->probs_table[s][flip].begin()
+                );
+            }
+        }
+    }
+
+    template <QKA_SQD_CONCEPT_RNG_(RNGType)>
+    void correct(
+        std::uint64_t *words, RNGType &rng, SamplingMethod sampling_method
+    ) const
+    {
+        std::array<InlineVector<std::size_t, MaxNOrb>, 2> indices;
+        std::array<InlineVector<double, MaxNOrb>, 2> weights;
+        const auto num_flip = _gather_flip_candidates(
+            words, norb(), probs_table, num_elec, indices, weights
+        );
+        for (std::size_t s = 0; s < 2; ++s) {
+            if (num_flip[s] == 0) {
+                continue;
+            }
+            visit_sampler_with_storage<InlineStorage<MaxNOrb>>(
+                sampling_method, weights[s],
+                [&](auto &sampler) {
+                    for (std::uint64_t i = 0; i < num_flip[s]; ++i) {
+                        _flip_bit(words, indices[s][sampler(rng)]);
+                    }
+                }
+            );
+        }
+    }
+};
+
+// Construct the fastest corrector for bitstrings of type `BitstringType` with
+// `probs_table[0][0].size()` orbitals per spin sector, and pass it to `func`.
+// For types of a fixed size `N` (see `FixedSizeImpl`), such as `std::bitset<N>`
+// and `std::uint64_t`, it is sized exactly for `N / 2` orbitals, provided the
+// table has that many, and otherwise for the smallest of 16, 32, 64 and 128
+// orbitals which fits.  Beyond that, a `WordsCorrector` is used.  All of them
+// draw the same random numbers, and flip the same bits.
+template <typename BitstringType, typename FunctionType>
+decltype(auto) visit_corrector(
+    const std::array<std::array<std::vector<double>, 2>, 2> &probs_table,
+    std::array<std::uint64_t, 2> num_elec, FunctionType &&func
+)
+{
+    constexpr std::size_t max_fixed_norb = max_inline_sampler_weights;
+    constexpr auto fixed_norb = FixedSizeImpl<BitstringType>::value / 2;
+    const auto norb = probs_table[0][0].size();
+    if constexpr (fixed_norb > 0 && fixed_norb <= max_fixed_norb) {
+        // The lengths of the bitstrings are only checked against the table when
+        // there are any, so the table may not match the type
+        if (norb == fixed_norb) {
+            const FixedSizeCorrector<fixed_norb, true> corrector(probs_table, num_elec);
+            return func(corrector);
+        }
+    }
+    if (norb <= 16) {
+        const FixedSizeCorrector<16> corrector(probs_table, num_elec);
+        return func(corrector);
+    }
+    if (norb <= 32) {
+        const FixedSizeCorrector<32> corrector(probs_table, num_elec);
+        return func(corrector);
+    }
+    if (norb <= 64) {
+        const FixedSizeCorrector<64> corrector(probs_table, num_elec);
+        return func(corrector);
+    }
+    if (norb <= max_fixed_norb) {
+        const FixedSizeCorrector<max_fixed_norb> corrector(probs_table, num_elec);
+        return func(corrector);
+    }
+    WordsCorrector corrector(probs_table, num_elec);
+    return func(corrector);
+}
+
+// Construct a bitstring of type `BitstringType` with the `num_bits` bits held in
+// `words`, starting from a copy of `like`, which has the same length.
+template <typename BitstringType, typename ElementType>
+BitstringType _bitstring_from_words(
+    const ElementType &like, const std::uint64_t *words, std::size_t num_bits
+)
+{
+    BitstringType bitstring(like);
+    AssignWordsImpl<BitstringType>::assign(bitstring, words, num_bits);
+    return bitstring;
+}
+
 template <typename BitstringType, QKA_SQD_CONCEPT_RNG_(RNGType)>
 void _bipartite_bitstring_correcting(
     BitstringType &bitstring,
     const std::array<std::array<std::vector<double>, 2>, 2> &probs_table,
-    std::array<std::uint64_t, 2> num_elec,
-    std::pair<std::vector<std::size_t>, std::vector<double>> &scratch_vectors,
-    RNGType &rng
+    std::array<std::uint64_t, 2> num_elec, CorrectionScratch &scratch,
+    RNGType &rng, SamplingMethod sampling_method = SamplingMethod::rejection
 )
 {
     // Use occupancy information (via probs_table) and target Hamming weight to
@@ -119,52 +415,162 @@ void _bipartite_bitstring_correcting(
               << std::endl;
 #endif
 
-    // The number of bits should be even - this was already checked in the calling
-    // function
-    const auto partition_size = probs_table[0][0].size();
-
-    // Determine starting Hamming weights
-    std::array<std::uint64_t, 2> initial_hamming_weight;
-    const auto n_right = mask_lower_n_bits(bitstring, partition_size).count();
-    initial_hamming_weight[0] = n_right;
-    initial_hamming_weight[1] = bitstring.count() - n_right;
+    const auto num_flip =
+        _gather_flip_candidates(bitstring, probs_table, num_elec, scratch);
 
-    // Handle RIGHT (alpha) then LEFT (beta) bits
-    std::uint64_t offset = 0;
+    // Handle RIGHT (alpha) then LEFT (beta) bits.  For up to 128 orbitals, the
+    // sampler lives on the stack (see `visit_sampler`).
     for (int s = 0; s < 2; ++s) {
-        if (initial_hamming_weight[s] != num_elec[s]) {
-            const bool flip = bool(
-                initial_hamming_weight[s] > num_elec[s]
-            ); // 1 or 0 depending on which should be flipped
-            const std::uint64_t num_flip = std::abs(
-                static_cast<int>(initial_hamming_weight[s]) -
-                static_cast<int>(num_elec[s])
-            );
-            auto &[indices, weights] = scratch_vectors;
-            indices.clear();
-            weights.clear();
-            for (std::uint64_t j = 0; j < partition_size; ++j) {
-                if (bitstring[j + offset] == flip) {
-                    indices.push_back(j + offset);
-                    weights.push_back(probs_table[s][flip][j]);
-                }
-            }
-            internal::NoReplacementSampler sampler(weights);
-            for (std::size_t i = 0; i < num_flip; ++i) {
-                const auto idx = indices[sampler(rng)];
-                bitstring.flip(idx);
-            }
+        if (num_flip[s] == 0) {
+            continue;
         }
-        offset += partition_size;
+        const auto &indices = scratch.indices[s];
+        visit_sampler(sampling_method, scratch.weights[s], [&](auto &sampler) {
+            for (std::uint64_t i = 0; i < num_flip[s]; ++i) {
+                FlipImpl<BitstringType>::flip(bitstring, indices[sampler(rng)]);
+            }
+        });
     }
 
 #if QKA_SQD_DEBUG_RECOVERY
     std::cerr << "Final bitstring: " << bitstring << '\n' << std::endl;
 #endif
-    assert(mask_lower_n_bits(bitstring, partition_size).count() == num_elec[0]);
+    assert(
+        mask_lower_n_bits(bitstring, probs_table[0][0].size()).count() == num_elec[0]
+    );
     assert(bitstring.count() == num_elec[0] + num_elec[1]);
 }
 
+// Draw `multiplicity` independent corrections of `bitstring` into
+// `corrected_bitstring`, and pass each to `func`.  The candidate bits of each
+// half and their weights are found once, and the samplers built from them are
+// reset between draws, so the draws are distributed as if
+// `_bipartite_bitstring_correcting` were called on `multiplicity` copies.
+template <typename BitstringType, QKA_SQD_CONCEPT_RNG_(RNGType), typename FunctionType>
+void _bipartite_bitstring_correcting_repeated(
+    const BitstringType &bitstring, BitstringType &corrected_bitstring,
+    const std::array<std::array<std::vector<double>, 2>, 2> &probs_table,
+    std::array<std::uint64_t, 2> num_elec, CorrectionScratch &scratch,
+    std::uint64_t multiplicity, RNGType &rng, SamplingMethod sampling_method,
+    FunctionType &&func
+)
+{
+    const auto num_flip =
+        _gather_flip_candidates(bitstring, probs_table, num_elec, scratch);
+    const auto &[right_indices, left_indices] = scratch.indices;
+    const auto &[right_weights, left_weights] = scratch.weights;
+
+    const auto draw = [&](auto &right_sampler, auto &left_sampler) {
+        for (std::uint64_t k = 0; k < multiplicity; ++k) {
+            if (k != 0) {
+                right_sampler.reset();
+                left_sampler.reset();
+            }
+            // Assignment reuses the storage of the previous draw
+            corrected_bitstring = bitstring;
+            for (std::uint64_t i = 0; i < num_flip[0]; ++i) {
+                FlipImpl<BitstringType>::flip(
+                    corrected_bitstring, right_indices[right_sampler(rng)]
+                );
+            }
+            for (std::uint64_t i = 0; i < num_flip[1]; ++i) {
+                FlipImpl<BitstringType>::flip(
+                    corrected_bitstring, left_indices[left_sampler(rng)]
+                );
+            }
+#ifndef NDEBUG
+            const auto counts =
+                RightLeftHammingImpl<BitstringType>::count(corrected_bitstring);
+            assert(counts[0] == num_elec[0] && counts[1] == num_elec[1]);
+#endif // NDEBUG
+            func(std::as_const(corrected_bitstring));
+        }
+    };
+    // Both samplers use the same storage, which halves the number of
+    // combinations to instantiate
+    const auto visit_samplers = [&](auto storage) {
+        using Storage = decltype(storage);
+        visit_sampler_with_storage<Storage>(
+            sampling_method, right_weights,
+            [&](auto &right_sampler) {
+                visit_sampler_with_storage<Storage>(
+                    sampling_method, left_weights,
+                    [&](auto &left_sampler) { draw(right_sampler, left_sampler); }
+                );
+            }
+        );
+    };
+    if (std::max(right_weights.size(), left_weights.size()) <=
+        max_inline_sampler_weights) {
+        visit_samplers(InlineStorage<max_inline_sampler_weights>{});
+    } else {
+        visit_samplers(HeapStorage{});
+    }
+}
+
+// Check that each bitstring has twice `partition_size` bits, and compute which
+// of them already have the target Hamming weights, and so need no correction.
+// The set bits of `PackedBitstringVector`s are counted with SIMD instructions
+// (see `postselection_bitmap`).
+template <typename BitstringVectorType>
+std::vector<std::uint64_t> _valid_bitmap(
+    const BitstringVectorType &bitstrings, std::size_t partition_size,
+    std::array<std::uint64_t, 2> num_elec
+)
+{
+    for (const auto &bitstring : bitstrings) {
+        if (bitstring_size(bitstring) != 2 * partition_size) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Bitstring length must be twice the number of orbitals."
+            );
+        }
+    }
+    // Unqualified, so that overloads for particular containers are found
+    return postselection_bitmap(
+        bitstrings, MatchesRightLeftHamming<std::uint64_t>(num_elec[0], num_elec[1])
+    );
+}
+
+inline bool _bitmap_test(const std::vector<std::uint64_t> &bitmap, std::size_t i)
+{
+    return ((bitmap[i / 64] >> (i % 64)) & 1) != 0;
+}
+
+// Sort the corrected bitstrings on their words `keys` (see `WordsImpl`), and
+// sum the probabilities of adjacent duplicates.  Duplicates are summed in their
+// original order, so the result is fully deterministic.  Only the first of each
+// run of duplicates, `i`, is materialized, by `make_bitstring(i)`.
+template <
+    typename BitstringVectorType, typename WeightVectorType, typename ProbabilitiesType,
+    typename FunctionType>
+std::pair<BitstringVectorType, WeightVectorType> _sort_and_reduce(
+    const ProbabilitiesType &probabilities, const std::vector<std::uint64_t> &keys,
+    std::size_t words_per_key, FunctionType &&make_bitstring
+)
+{
+    const auto num_bitstrings = probabilities.size();
+    const auto order =
+        internal::radix_sort_permutation(keys.data(), num_bitstrings, words_per_key);
+
+    BitstringVectorType bitstrings_out;
+    WeightVectorType freqs_out;
+    for (std::size_t j = 0; j < num_bitstrings;) {
+        const auto first = order[j];
+        const auto *first_key = keys.data() + first * words_per_key;
+        double freq = probabilities[first];
+        for (++j; j < num_bitstrings; ++j) {
+            const auto *key = keys.data() + order[j] * words_per_key;
+            if (!std::equal(key, key + words_per_key, first_key)) {
+                break;
+            }
+            freq += probabilities[order[j]];
+        }
+        bitstrings_out.push_back(make_bitstring(first));
+        freqs_out.push_back(freq);
+    }
+    return {std::move(bitstrings_out), std::move(freqs_out)};
+}
+
 } // namespace internal
 
 /// Refine bitstrings based on average orbital occupancy and a target
@@ -179,6 +585,9 @@ void _bipartite_bitstring_correcting(
 /// @param[in] num_elec Size-2 `std::array` containing the number of spin-up and
 ///     spin-down electrons in the system, respectively.
 /// @param[in,out] rng Random number generator.
+/// @param[in] sampling_method Algorithm to use when choosing which bits to flip.
+/// @param[in] aggregation_method How the probabilities of duplicate corrected
+///     bitstrings are combined, which also determines the order of the output.
 ///
 /// @tparam BitstringVectorType Type of `bitstrings`, compatible with
 ///     `std::vector<boost::dynamic_bitset<>>`.
@@ -193,7 +602,9 @@ template <
 [[nodiscard]] std::pair<BitstringVectorType, WeightVectorType> recover_configurations(
     const BitstringVectorType &bitstrings, const WeightVectorType &probabilities,
     const std::array<std::vector<double>, 2> &avg_occupancies,
-    std::array<std::uint64_t, 2> num_elec, RNGType &rng
+    std::array<std::uint64_t, 2> num_elec, RNGType &rng,
+    SamplingMethod sampling_method = SamplingMethod::rejection,
+    AggregationMethod aggregation_method = AggregationMethod::hash_map
 )
 {
     if (bitstrings.size() != probabilities.size()) {
@@ -202,71 +613,695 @@ template <
         );
     }
 
+    const auto probs_table = internal::_make_probs_table(avg_occupancies, num_elec);
     const auto partition_size = avg_occupancies[0].size();
-    if (avg_occupancies[1].size() != partition_size) {
+    if (bitstrings.empty()) {
+        return {};
+    }
+
+    using BitstringType = typename BitstringVectorType::value_type;
+    const bool sort_reduce = aggregation_method == AggregationMethod::sort_reduce;
+    const auto num_bits = 2 * partition_size;
+    const auto words_per_key = internal::words_for_bits(num_bits);
+    std::vector<BitstringType> corrected_bitstrings;
+    std::vector<std::uint64_t> keys(
+        (sort_reduce ? bitstrings.size() : 1) * words_per_key
+    );
+    internal::FlatBitstringMap<double> corrected_dict(words_per_key);
+
+    // Bitstrings which already have the target Hamming weights are aggregated
+    // as they are, and draw no random numbers
+    const auto valid =
+        internal::_valid_bitmap(bitstrings, partition_size, num_elec);
+
+    // Each bitstring is corrected in place in its words, which are then the key
+    // for aggregation.  A bitstring of type `BitstringType` is only constructed
+    // for each unique result.
+    internal::visit_corrector<BitstringType>(
+        probs_table, num_elec,
+        [&](auto &corrector) {
+            for (std::size_t i = 0; i < bitstrings.size(); ++i) {
+                const auto &bitstring = bitstrings[i];
+                using ElementType = std::decay_t<decltype(bitstring)>;
+                auto *key = keys.data() + (sort_reduce ? i * words_per_key : 0);
+                internal::WordsImpl<ElementType>::copy(bitstring, key);
+                if (!internal::_bitmap_test(valid, i)) {
+                    corrector.correct(key, rng, sampling_method);
+                }
+                if (sort_reduce) {
+                    // Duplicates are removed after sorting, below
+                    continue;
+                }
+                const auto [index, inserted] = corrected_dict.try_emplace(key, 0.0);
+                if (inserted) {
+                    corrected_bitstrings.push_back(
+                        internal::_bitstring_from_words<BitstringType>(
+                            bitstring, key, num_bits
+                        )
+                    );
+                }
+                corrected_dict.value(index) += probabilities[i];
+            }
+        }
+    );
+
+    BitstringVectorType bitstrings_out;
+    WeightVectorType freqs_out;
+
+    if (sort_reduce) {
+        std::tie(bitstrings_out, freqs_out) =
+            internal::_sort_and_reduce<BitstringVectorType, WeightVectorType>(
+                probabilities, keys, words_per_key,
+                [&](std::size_t i) {
+                    return internal::_bitstring_from_words<BitstringType>(
+                        bitstrings[i], keys.data() + i * words_per_key, num_bits
+                    );
+                }
+            );
+    } else {
+        for (std::size_t j = 0; j < corrected_dict.size(); ++j) {
+            bitstrings_out.push_back(std::move(corrected_bitstrings[j]));
+            freqs_out.push_back(corrected_dict.value(j));
+        }
+    }
+
+    // Normalize the frequencies
+    internal::_normalize(freqs_out);
+
+    return {std::move(bitstrings_out), std::move(freqs_out)};
+}
+
+/// Refine unique bitstrings, each observed a given number of times, based on
+/// average orbital occupancy and a target Hamming weight.
+///
+/// This takes measurement counts directly, rather than the bitstring of every
+/// shot.  Each of the `multiplicities[i]` shots of `bitstrings[i]` is corrected
+/// independently, and carries an equal share of `probabilities[i]`.  The
+/// candidate bits and the samplers are prepared once per unique bitstring, and
+/// reused for each of its shots.  Bitstrings which already have the target
+/// Hamming weights are kept whole, and bitstrings with zero multiplicity are
+/// dropped.
+///
+/// The result is thus distributed as that of the first overload applied to the
+/// input with each bitstring repeated `multiplicities[i]` times, each copy
+/// having probability `probabilities[i] / multiplicities[i]`.  With
+/// `SamplingMethod::rejection` or `SamplingMethod::exponential_keys`, and the
+/// same random number generator state, the two agree exactly, up to rounding of
+/// the probabilities.
+///
+/// @param[in] bitstrings A container (e.g., `std::vector`) of bitstrings.
+/// @param[in] multiplicities A 1D array of the number of times each bitstring
+///     was observed.  Must contain the same number of elements as `bitstrings`.
+/// @param[in] probabilities A 1D array specifying a probability distribution over
+///     the bitstrings.  Must contain the same number of elements as `bitstrings`.
+/// @param[in] avg_occupancies Size-2 `std::array` of `std::vector<double>`s holding the
+///     mean occupancy of the spin-up and spin-down orbitals, respectively.  Each
+///     vector's size must be half the size of a single bitstring.
+/// @param[in] num_elec Size-2 `std::array` containing the number of spin-up and
+///     spin-down electrons in the system, respectively.
+/// @param[in,out] rng Random number generator.
+/// @param[in] sampling_method Algorithm to use when choosing which bits to flip.
+/// @param[in] aggregation_method Order of the output: by first occurrence for
+///     `AggregationMethod::hash_map`, or ascending for
+///     `AggregationMethod::sort_reduce`.
+///
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+/// @tparam MultiplicityVectorType Type of `multiplicities`, compatible with
+///     `std::vector<std::uint64_t>`.
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+/// @tparam RNGType Type of random number generator.
+///
+/// @return A refined `std::vector` of unique bitstrings and a parallel, updated
+///     probability array.
+template <
+    typename BitstringVectorType, typename MultiplicityVectorType,
+    typename WeightVectorType, QKA_SQD_CONCEPT_RNG_(RNGType)>
+[[nodiscard]] std::pair<BitstringVectorType, WeightVectorType> recover_configurations(
+    const BitstringVectorType &bitstrings, const MultiplicityVectorType &multiplicities,
+    const WeightVectorType &probabilities,
+    const std::array<std::vector<double>, 2> &avg_occupancies,
+    std::array<std::uint64_t, 2> num_elec, RNGType &rng,
+    SamplingMethod sampling_method = SamplingMethod::rejection,
+    AggregationMethod aggregation_method = AggregationMethod::hash_map
+)
+{
+    if (bitstrings.size() != probabilities.size()) {
         QKA_SQD_THROW_INVALID_ARGUMENT_(
-            "Average occupancies vectors must have matching number of alpha and beta "
-            "orbitals."
+            "Probabilities vector must have length that matches the bitstrings vector."
         );
     }
-    if (num_elec[0] > partition_size || num_elec[1] > partition_size) {
+    if (bitstrings.size() != multiplicities.size()) {
         QKA_SQD_THROW_INVALID_ARGUMENT_(
-            "Desired Hamming weight cannot be larger than the number of orbitals."
+            "Multiplicities vector must have length that matches the bitstrings "
+            "vector."
         );
     }
 
-    // Populate the probabilities table
-    std::array<std::array<std::vector<double>, 2>, 2> probs_table;
-    for (int s = 0; s < 2; ++s) {
-        probs_table[s][0].resize(partition_size);
-        probs_table[s][1].resize(partition_size);
-        // NOLINTBEGIN(bugprone-narrowing-conversions)
-        double density_s = static_cast<double>(num_elec[s]) / partition_size;
-        // NOLINTEND(bugprone-narrowing-conversions)
-        for (std::size_t i = 0; i < partition_size; ++i) {
-            const auto occ = std::max(0.0, std::min(1.0, avg_occupancies[s][i]));
-            probs_table[s][0][i] = internal::_p_flip_0_to_1(density_s, occ);
-            probs_table[s][1][i] = internal::_p_flip_1_to_0(density_s, occ);
-        }
+    const auto probs_table = internal::_make_probs_table(avg_occupancies, num_elec);
+    const auto partition_size = avg_occupancies[0].size();
+    if (bitstrings.empty()) {
+        return {};
     }
+    const auto valid = internal::_valid_bitmap(bitstrings, partition_size, num_elec);
 
     using BitstringType = typename BitstringVectorType::value_type;
-    std::unordered_map<BitstringType, double> corrected_dict;
+    const auto words_per_key = internal::words_for_bits(2 * partition_size);
+    std::vector<BitstringType> corrected_bitstrings;
+    std::vector<std::uint64_t> key(words_per_key);
+    internal::FlatBitstringMap<double> corrected_dict(words_per_key);
+    const auto aggregate = [&](const auto &bitstring, double probability) {
+        using ElementType = std::decay_t<decltype(bitstring)>;
+        internal::WordsImpl<ElementType>::copy(bitstring, key.data());
+        const auto [index, inserted] = corrected_dict.try_emplace(key.data(), 0.0);
+        if (inserted) {
+            corrected_bitstrings.emplace_back(bitstring);
+        }
+        corrected_dict.value(index) += probability;
+    };
 
-    std::pair<std::vector<std::size_t>, std::vector<double>> scratch_vectors;
+    internal::CorrectionScratch scratch;
+    BitstringType bitstring, corrected_bitstring;
     for (std::size_t i = 0; i < bitstrings.size(); ++i) {
-        const auto &bitstring = bitstrings[i];
-        if (bitstring.size() != 2 * partition_size) {
-            QKA_SQD_THROW_INVALID_ARGUMENT_(
-                "Bitstring length must be twice the number of orbitals."
-            );
+        const auto multiplicity = static_cast<std::uint64_t>(multiplicities[i]);
+        if (multiplicity == 0) {
+            continue;
+        }
+        if (internal::_bitmap_test(valid, i)) {
+            aggregate(bitstrings[i], probabilities[i]);
+            continue;
         }
 
-        // Correct the bitstring
-        auto corrected_bitstring = bitstring;
-        internal::_bipartite_bitstring_correcting(
-            corrected_bitstring, probs_table, num_elec, scratch_vectors, rng
+        // Each shot carries an equal share of the probability
+        const double probability = probabilities[i] / static_cast<double>(multiplicity);
+        bitstring = bitstrings[i];
+        internal::_bipartite_bitstring_correcting_repeated(
+            bitstring, corrected_bitstring, probs_table, num_elec, scratch,
+            multiplicity, rng, sampling_method,
+            [&](const BitstringType &corrected) { aggregate(corrected, probability); }
         );
+    }
 
-        // Use the unordered_map to remove duplicates
-        const auto freq = probabilities[i];
-        corrected_dict[corrected_bitstring] += freq;
+    // The unique bitstrings are in order of first occurrence.  Sort them if
+    // requested; their words are contiguous in the hash map.
+    std::vector<std::size_t> order(corrected_dict.size());
+    if (aggregation_method == AggregationMethod::sort_reduce) {
+        order = internal::radix_sort_permutation(
+            corrected_dict.key(0), corrected_dict.size(), words_per_key
+        );
+    } else {
+        std::iota(order.begin(), order.end(), std::size_t{0});
     }
 
     BitstringVectorType bitstrings_out;
     WeightVectorType freqs_out;
+    for (const auto j : order) {
+        bitstrings_out.push_back(std::move(corrected_bitstrings[j]));
+        freqs_out.push_back(corrected_dict.value(j));
+    }
+
+    // Normalize the frequencies
+    internal::_normalize(freqs_out);
+
+    return {std::move(bitstrings_out), std::move(freqs_out)};
+}
+
+/// Refine bitstrings based on average orbital occupancy and a target
+/// Hamming weight, using multiple threads.
+///
+/// The bitstrings are divided into shards of `parallel_options.shard_size`
+/// consecutive elements, which are corrected concurrently.  Each shard draws
+/// from its own random number generator, seeded with a value derived from
+/// `parallel_options.seed` and the index of the shard.  The output is
+/// therefore reproducible for a given seed and shard size, regardless of the
+/// number of threads used.  With `AggregationMethod::hash_map`, the unique
+/// bitstrings are returned in order of their first occurrence.
+///
+/// The random streams differ from those of the single-threaded overload, so
+/// the two overloads do not return identical results for the same input.
+///
+/// @param[in] bitstrings A container (e.g., `std::vector`) of bitstrings.
+/// @param[in] probabilities A 1D array specifying a probability distribution over
+///     the bitstrings.  Must contain the same number of elements as `bitstrings`.
+/// @param[in] avg_occupancies Size-2 `std::array` of `std::vector<double>`s holding the
+///     mean occupancy of the spin-up and spin-down orbitals, respectively.  Each
+///     vector's size must be half the size of a single bitstring.
+/// @param[in] num_elec Size-2 `std::array` containing the number of spin-up and
+///     spin-down electrons in the system, respectively.
+/// @param[in] parallel_options Seed, number of threads, and shard size.
+/// @param[in] sampling_method Algorithm to use when choosing which bits to flip.
+/// @param[in] aggregation_method How the probabilities of duplicate corrected
+///     bitstrings are combined, which also determines the order of the output.
+///
+/// @tparam RNGType Type of random number generator used for each shard.  Must be
+///     constructible from a single seed value.
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+///
+/// @return A refined `std::vector` of unique bitstrings and a parallel, updated
+///     probability array.
+template <
+    QKA_SQD_CONCEPT_RNG_(RNGType) = std::mt19937_64, typename BitstringVectorType,
+    typename WeightVectorType>
+[[nodiscard]] std::pair<BitstringVectorType, WeightVectorType> recover_configurations(
+    const BitstringVectorType &bitstrings, const WeightVectorType &probabilities,
+    const std::array<std::vector<double>, 2> &avg_occupancies,
+    std::array<std::uint64_t, 2> num_elec, ParallelOptions parallel_options,
+    SamplingMethod sampling_method = SamplingMethod::rejection,
+    AggregationMethod aggregation_method = AggregationMethod::hash_map
+)
+{
+    if (bitstrings.size() != probabilities.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Probabilities vector must have length that matches the bitstrings vector."
+        );
+    }
+    if (parallel_options.shard_size == 0) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("Shard size must be nonzero.");
+    }
+
+    const auto probs_table = internal::_make_probs_table(avg_occupancies, num_elec);
+    const auto partition_size = avg_occupancies[0].size();
+    if (bitstrings.empty()) {
+        return {};
+    }
+
+    using BitstringType = typename BitstringVectorType::value_type;
+    const auto num_bitstrings = bitstrings.size();
+    const auto shard_size = parallel_options.shard_size;
+    const auto num_shards = (num_bitstrings + shard_size - 1) / shard_size;
+    const auto num_threads =
+        internal::resolve_num_threads(parallel_options.num_threads, num_shards);
+
+    const auto valid = internal::_valid_bitmap(bitstrings, partition_size, num_elec);
+    const auto num_bits = 2 * partition_size;
+    const auto words_per_key = internal::words_for_bits(num_bits);
+
+    if (aggregation_method == AggregationMethod::sort_reduce) {
+        // Each corrected bitstring's words go to their own slot, so the sort
+        // below sees the same input regardless of the scheduling.
+        std::vector<std::uint64_t> keys(num_bitstrings * words_per_key);
+        internal::visit_corrector<BitstringType>(
+            probs_table, num_elec,
+            [&](auto &corrector) {
+                std::vector<std::decay_t<decltype(corrector)>> thread_correctors(
+                    num_threads, corrector
+                );
+                internal::parallel_for(
+                    num_shards, num_threads,
+                    [&](std::size_t shard, unsigned int thread) {
+                        auto rng = internal::make_stream_rng<RNGType>(
+                            parallel_options.seed, shard
+                        );
+                        const auto begin = shard * shard_size;
+                        const auto end = std::min(begin + shard_size, num_bitstrings);
+                        for (auto i = begin; i < end; ++i) {
+                            const auto &bitstring = bitstrings[i];
+                            using ElementType = std::decay_t<decltype(bitstring)>;
+                            auto *key = keys.data() + i * words_per_key;
+                            internal::WordsImpl<ElementType>::copy(bitstring, key);
+                            if (!internal::_bitmap_test(valid, i)) {
+                                thread_correctors[thread].correct(
+                                    key, rng, sampling_method
+                                );
+                            }
+                        }
+                    }
+                );
+            }
+        );
+        auto [bitstrings_out, freqs_out] =
+            internal::_sort_and_reduce<BitstringVectorType, WeightVectorType>(
+                probabilities, keys, words_per_key,
+                [&](std::size_t i) {
+                    return internal::_bitstring_from_words<BitstringType>(
+                        bitstrings[i], keys.data() + i * words_per_key, num_bits
+                    );
+                }
+            );
+        internal::_normalize(freqs_out);
+        return {std::move(bitstrings_out), std::move(freqs_out)};
+    }
+
+    // Each shard produces its unique corrected bitstrings in order of first
+    // occurrence, so that the merge below does not depend on the scheduling.
+    // Bitstrings which already have the target Hamming weights are aggregated
+    // as they are.
+    std::vector<internal::FlatBitstringMap<double>> shard_dicts(
+        num_shards, internal::FlatBitstringMap<double>(words_per_key)
+    );
+    std::vector<std::vector<BitstringType>> shard_bitstrings(num_shards);
+    std::vector<std::vector<std::uint64_t>> thread_keys(
+        num_threads, std::vector<std::uint64_t>(words_per_key)
+    );
+
+    internal::visit_corrector<BitstringType>(
+        probs_table, num_elec,
+        [&](auto &corrector) {
+            std::vector<std::decay_t<decltype(corrector)>> thread_correctors(
+                num_threads, corrector
+            );
+            internal::parallel_for(
+                num_shards, num_threads,
+                [&](std::size_t shard, unsigned int thread) {
+                    auto rng = internal::make_stream_rng<RNGType>(
+                        parallel_options.seed, shard
+                    );
+                    auto *key = thread_keys[thread].data();
+                    auto &dict = shard_dicts[shard];
+                    auto &result = shard_bitstrings[shard];
+                    const auto begin = shard * shard_size;
+                    const auto end = std::min(begin + shard_size, num_bitstrings);
+                    dict.reserve(end - begin);
+                    for (auto i = begin; i < end; ++i) {
+                        const auto &bitstring = bitstrings[i];
+                        using ElementType = std::decay_t<decltype(bitstring)>;
+                        internal::WordsImpl<ElementType>::copy(bitstring, key);
+                        if (!internal::_bitmap_test(valid, i)) {
+                            thread_correctors[thread].correct(
+                                key, rng, sampling_method
+                            );
+                        }
 
-    for (const auto &[bitstring, freq] : corrected_dict) {
-        bitstrings_out.emplace_back(bitstring);
+                        // Remove duplicates within the shard
+                        const auto [index, inserted] = dict.try_emplace(key, 0.0);
+                        if (inserted) {
+                            result.push_back(
+                                internal::_bitstring_from_words<BitstringType>(
+                                    bitstring, key, num_bits
+                                )
+                            );
+                        }
+                        dict.value(index) += probabilities[i];
+                    }
+                }
+            );
+        }
+    );
+
+    // Merge the shards in order.  The keys keep their hashes from the shards,
+    // so none is hashed again.
+    internal::FlatBitstringMap<double> merged(words_per_key);
+    BitstringVectorType bitstrings_out;
+    for (std::size_t shard = 0; shard < num_shards; ++shard) {
+        auto &dict = shard_dicts[shard];
+        auto &result = shard_bitstrings[shard];
+        merged.merge(dict, [&](std::size_t j, std::size_t index, bool inserted) {
+            if (inserted) {
+                bitstrings_out.push_back(std::move(result[j]));
+            } else {
+                merged.value(index) += dict.value(j);
+            }
+        });
+        dict = internal::FlatBitstringMap<double>(words_per_key);
+        result = {};
+    }
+    WeightVectorType freqs_out;
+    for (const auto freq : merged.values()) {
         freqs_out.push_back(freq);
     }
 
     // Normalize the frequencies
     internal::_normalize(freqs_out);
 
-    return {bitstrings_out, freqs_out};
+    return {std::move(bitstrings_out), std::move(freqs_out)};
 }
 
+/// Reusable state for refining the same bitstrings repeatedly, as in the
+/// iterations of SQD, where each round updates the average orbital occupancies.
+///
+/// The bitstrings and probabilities are validated once, upon construction.
+/// `update_occupancies` refills the table of flip probabilities in place, and
+/// `run` refines every bitstring, reusing the scratch space, the hash map which
+/// removes duplicates, and the storage of the unique bitstrings from the
+/// previous call.  Once those have grown to fit, an iteration with up to 128
+/// orbitals per spin sector allocates nothing, as the samplers which choose the
+/// bits to flip then live on the stack.
+///
+/// Bitstrings which already have the target Hamming weights are never changed
+/// by `run`, so they are found, and their duplicates combined, once upon
+/// construction.  Each iteration then only corrects the remaining bitstrings.
+///
+/// Each call to `run` returns the same bitstrings, in the same order, as the
+/// single-threaded `recover_configurations` with `AggregationMethod::hash_map`
+/// would, given the same random number generator state.  The probabilities
+/// agree up to rounding, since those of duplicate valid bitstrings are summed
+/// in advance.
+///
+/// `bitstrings` and `probabilities` are held by reference, must outlive the
+/// `ConfigurationRecoverer`, and must not be modified after its construction.
+///
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+/// @tparam WeightVectorType Type of `probabilities`, compatible with
+///     `std::vector<double>`.
+///
+/// # Example
+///
+/// ```
+/// ConfigurationRecoverer recoverer(bitstrings, probabilities, num_elec);
+/// for (int i = 0; i < num_iterations; ++i) {
+///     recoverer.update_occupancies(avg_occupancies);
+///     recoverer.run(rng);
+///     // Use recoverer.bitstring(j) and recoverer.probabilities()[j],
+///     // for j < recoverer.size(), to update avg_occupancies
+/// }
+/// ```
+template <typename BitstringVectorType, typename WeightVectorType>
+class ConfigurationRecoverer
+{
+  public:
+    using BitstringType = typename BitstringVectorType::value_type;
+
+  private:
+    const BitstringVectorType &bitstrings_in;
+    const WeightVectorType &probabilities_in;
+    std::array<std::uint64_t, 2> num_elec;
+    SamplingMethod sampling_method;
+    std::size_t num_bits;
+    bool has_occupancies = false;
+    std::array<std::array<std::vector<double>, 2>, 2> probs_table;
+    BitstringType corrected_bitstring;
+    // Scratch space for the words of a corrected bitstring
+    std::vector<std::uint64_t> key;
+    // Maps the words of each unique corrected bitstring to its probability
+    internal::FlatBitstringMap<double> corrected_dict;
+    // The first `corrected_dict.size()` elements are the unique corrected
+    // bitstrings, in order of first occurrence.  Later elements are left over
+    // from previous iterations, and are kept for their storage.
+    std::vector<BitstringType> unique_bitstrings;
+    // Maps the words of each unique bitstring which needs no correction to its
+    // total probability, in order of first occurrence
+    internal::FlatBitstringMap<double> valid_dict;
+    // Index into `bitstrings_in` of the first occurrence of each entry of
+    // `valid_dict`
+    std::vector<std::size_t> valid_first;
+    // Indices of the bitstrings which need correction
+    std::vector<std::size_t> invalid_indices;
+
+    // Record a new unique bitstring at `index`.  Its storage is swapped with
+    // that of the element left over from a previous iteration, if any, so that
+    // it is reused for the next corrected bitstring.
+    void store_unique(std::size_t index, BitstringType &bitstring)
+    {
+        if (index < unique_bitstrings.size()) {
+            std::swap(unique_bitstrings[index], bitstring);
+        } else {
+            unique_bitstrings.push_back(bitstring);
+        }
+    }
+
+  public:
+    /// Constructor
+    ///
+    /// @param[in] bitstrings A container (e.g., `std::vector`) of bitstrings,
+    ///     all of the same, even length.
+    /// @param[in] probabilities A 1D array specifying a probability distribution
+    ///     over the bitstrings.  Must contain the same number of elements as
+    ///     `bitstrings`.
+    /// @param[in] num_elec Size-2 `std::array` containing the number of spin-up
+    ///     and spin-down electrons in the system, respectively.
+    /// @param[in] sampling_method Algorithm to use when choosing which bits to
+    ///     flip.
+    ConfigurationRecoverer(
+        const BitstringVectorType &bitstrings, const WeightVectorType &probabilities,
+        std::array<std::uint64_t, 2> num_elec,
+        SamplingMethod sampling_method = SamplingMethod::rejection
+    )
+      : bitstrings_in(bitstrings), probabilities_in(probabilities),
+        num_elec(num_elec), sampling_method(sampling_method),
+        num_bits(bitstrings.empty() ? 0 : internal::bitstring_size(bitstrings[0])),
+        key(internal::words_for_bits(num_bits)),
+        corrected_dict(internal::words_for_bits(num_bits)),
+        valid_dict(internal::words_for_bits(num_bits))
+    {
+        if (bitstrings.size() != probabilities.size()) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Probabilities vector must have length that matches the bitstrings "
+                "vector."
+            );
+        }
+        for (std::size_t i = 0; i < bitstrings.size(); ++i) {
+            if (internal::bitstring_size(bitstrings[i]) != num_bits ||
+                num_bits % 2 != 0) {
+                QKA_SQD_THROW_INVALID_ARGUMENT_(
+                    "Bitstrings must have uniform, even length."
+                );
+            }
+        }
+
+        // Split the bitstrings into those which already have the target Hamming
+        // weights, whose duplicates are combined here, and those to correct
+        const auto valid =
+            internal::_valid_bitmap(bitstrings, num_bits / 2, num_elec);
+        for (std::size_t i = 0; i < bitstrings.size(); ++i) {
+            if (!internal::_bitmap_test(valid, i)) {
+                invalid_indices.push_back(i);
+                continue;
+            }
+            using ElementType = std::decay_t<decltype(bitstrings[i])>;
+            internal::WordsImpl<ElementType>::copy(bitstrings[i], key.data());
+            const auto [index, inserted] = valid_dict.try_emplace(key.data(), 0.0);
+            if (inserted) {
+                valid_first.push_back(i);
+            }
+            valid_dict.value(index) += probabilities[i];
+        }
+    }
+
+    /// Set the mean occupancies used by subsequent calls to `run`.
+    ///
+    /// @param[in] avg_occupancies Size-2 `std::array` of `std::vector<double>`s
+    ///     holding the mean occupancy of the spin-up and spin-down orbitals,
+    ///     respectively.  Each vector's size must be half the size of a single
+    ///     bitstring.
+    void update_occupancies(const std::array<std::vector<double>, 2> &avg_occupancies)
+    {
+        if (!bitstrings_in.empty() && 2 * avg_occupancies[0].size() != num_bits) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Bitstring length must be twice the number of orbitals."
+            );
+        }
+        has_occupancies = false;
+        internal::_fill_probs_table(probs_table, avg_occupancies, num_elec);
+        has_occupancies = true;
+    }
+
+    /// Refine the bitstrings based on the current mean occupancies and the
+    /// target Hamming weight.
+    ///
+    /// The unique refined bitstrings and their normalized probabilities are
+    /// then available from `bitstring` and `probabilities`, until the next call.
+    ///
+    /// @param[in,out] rng Random number generator.
+    ///
+    /// @tparam RNGType Type of random number generator.
+    template <QKA_SQD_CONCEPT_RNG_(RNGType)>
+    void run(RNGType &rng)
+    {
+        if (!has_occupancies) {
+            QKA_SQD_THROW_RUNTIME_ERROR_(
+                "update_occupancies must be called before run."
+            );
+        }
+        corrected_dict.clear();
+
+        // Interleave the unique valid bitstrings with the corrected ones in
+        // order of first occurrence, so that the output is ordered as if every
+        // bitstring had been visited in turn
+        std::size_t next_valid = 0;
+        const auto add_valid_before = [&](std::size_t end) {
+            for (; next_valid < valid_dict.size() && valid_first[next_valid] < end;
+                 ++next_valid) {
+                const auto [index, inserted] = corrected_dict.try_emplace_hashed(
+                    valid_dict.key(next_valid), valid_dict.hash(next_valid), 0.0
+                );
+                if (inserted) {
+                    corrected_bitstring = bitstrings_in[valid_first[next_valid]];
+                    store_unique(index, corrected_bitstring);
+                }
+                corrected_dict.value(index) += valid_dict.value(next_valid);
+            }
+        };
+
+        // Each bitstring is corrected in its words, and only copied into a
+        // `BitstringType` if the result is new
+        if (!invalid_indices.empty()) {
+            internal::visit_corrector<BitstringType>(
+                probs_table, num_elec,
+                [&](auto &corrector) {
+                    for (const auto i : invalid_indices) {
+                        add_valid_before(i);
+
+                        const auto &bitstring = bitstrings_in[i];
+                        using ElementType = std::decay_t<decltype(bitstring)>;
+                        internal::WordsImpl<ElementType>::copy(bitstring, key.data());
+                        corrector.correct(key.data(), rng, sampling_method);
+
+                        const auto [index, inserted] =
+                            corrected_dict.try_emplace(key.data(), 0.0);
+                        if (inserted) {
+                            // Assignment reuses the storage of the previous
+                            // corrected bitstring
+                            corrected_bitstring = bitstring;
+                            internal::AssignWordsImpl<BitstringType>::assign(
+                                corrected_bitstring, key.data(), num_bits
+                            );
+                            store_unique(index, corrected_bitstring);
+                        }
+                        corrected_dict.value(index) += probabilities_in[i];
+                    }
+                }
+            );
+        }
+        add_valid_before(bitstrings_in.size());
+
+        // Normalize the frequencies
+        double sum = 0.0;
+        for (std::size_t j = 0; j < corrected_dict.size(); ++j) {
+            sum += corrected_dict.value(j);
+        }
+        if (sum > 0.0) {
+            for (std::size_t j = 0; j < corrected_dict.size(); ++j) {
+                corrected_dict.value(j) /= sum;
+            }
+        }
+    }
+
+    /// Return the number of unique bitstrings produced by the last call to `run`
+    std::size_t size() const
+    {
+        return corrected_dict.size();
+    }
+
+    /// Return unique bitstring number `i` produced by the last call to `run`
+    const BitstringType &bitstring(std::size_t i) const
+    {
+        return unique_bitstrings[i];
+    }
+
+    /// Return the probabilities of the unique bitstrings produced by the last
+    /// call to `run`
+    const std::vector<double> &probabilities() const
+    {
+        return corrected_dict.values();
+    }
+
+    /// Return a copy of the unique bitstrings and probabilities produced by the
+    /// last call to `run`, as `recover_configurations` would
+    std::pair<BitstringVectorType, WeightVectorType> result() const
+    {
+        BitstringVectorType bitstrings_out;
+        WeightVectorType freqs_out;
+        for (std::size_t j = 0; j < size(); ++j) {
+            bitstrings_out.push_back(unique_bitstrings[j]);
+            freqs_out.push_back(corrected_dict.value(j));
+        }
+        return {std::move(bitstrings_out), std::move(freqs_out)};
+    }
+};
+
 } // namespace sqd
 
 } // namespace addon
@@ -0,0 +1,418 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_DEDUPLICATION_HPP_
+#define QISKIT_ADDON_SQD_DEDUPLICATION_HPP_
+
+/// Reduction of raw shots to unique bitstrings
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "qiskit/addon/sqd/bitset_full.hpp"
+#include "qiskit/addon/sqd/internal/exception-macros.hpp"
+#include "qiskit/addon/sqd/internal/flat-hash-map.hpp"
+#include "qiskit/addon/sqd/internal/parallel.hpp"
+#include "qiskit/addon/sqd/internal/radix-sort.hpp"
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+/// How duplicate bitstrings are combined, by `deduplicate_bitstrings` and
+/// `recover_configurations`.
+enum class AggregationMethod {
+    /// Accumulate the weights in a hash map keyed by bitstring.  The unique
+    /// bitstrings are returned in order of first occurrence.
+    hash_map,
+    /// Collect the bitstrings and their weights in a flat array, radix sort it
+    /// on the words of the bitstrings, and sum the weights of adjacent
+    /// duplicates.  The unique bitstrings are returned in ascending order,
+    /// regarding each as an unsigned integer whose bit 0 is the least
+    /// significant.
+    sort_reduce,
+};
+
+namespace internal
+{
+
+// Words of every bitstring, `words_for_bits(num_bits)` per bitstring, as copied
+// by `WordsImpl`.  The word matrix of a `PackedBitstringVector` already has this
+// layout, and is used where it is.  The words of other containers are copied
+// into `storage`, one shard of `shard_size` bitstrings per task.
+template <typename BitstringVectorType>
+const std::uint64_t *_bitstring_keys(
+    const BitstringVectorType &bitstrings, std::size_t num_bits,
+    std::size_t shard_size, unsigned int num_threads,
+    std::vector<std::uint64_t> &storage
+)
+{
+    if constexpr (std::is_same_v<BitstringVectorType, PackedBitstringVector>) {
+        return bitstrings.data();
+    } else {
+        const auto num_bitstrings = bitstrings.size();
+        const auto words_per_key = words_for_bits(num_bits);
+        const auto num_shards = (num_bitstrings + shard_size - 1) / shard_size;
+        storage.resize(num_bitstrings * words_per_key);
+        parallel_for(num_shards, num_threads, [&](std::size_t shard, unsigned int) {
+            const auto begin = shard * shard_size;
+            const auto end = std::min(begin + shard_size, num_bitstrings);
+            for (auto i = begin; i < end; ++i) {
+                const auto &bitstring = bitstrings[i];
+                using ElementType = std::decay_t<decltype(bitstring)>;
+                if (bitstring_size(bitstring) != num_bits) {
+                    QKA_SQD_THROW_INVALID_ARGUMENT_(
+                        "All bitstrings must have the same length."
+                    );
+                }
+                WordsImpl<ElementType>::copy(bitstring, &storage[i * words_per_key]);
+            }
+        });
+        return storage.data();
+    }
+}
+
+// Find the unique keys among `num_keys` keys of `words_per_key` words each, and
+// sum `value_of(i)` over the occurrences `i` of each.
+//
+// Each key is assigned to a partition by its hash.  The keys of each shard of
+// `shard_size` consecutive keys are first hashed and listed by partition, and
+// each partition is then deduplicated in its own hash map, visiting its keys in
+// their original order.  Every occurrence of a key falls in the same partition,
+// so the values of each unique key are summed in order of occurrence, as on a
+// single thread, and the result does not depend on the number of threads.
+//
+// @return The index of the first occurrence of each unique key, and the sum of
+//     its values, in the order determined by `aggregation_method`.
+template <typename ValueType, typename FunctionType>
+std::pair<std::vector<std::size_t>, std::vector<ValueType>> _deduplicate_keys(
+    const std::uint64_t *keys, std::size_t num_keys, std::size_t words_per_key,
+    std::size_t shard_size, unsigned int num_threads,
+    AggregationMethod aggregation_method, FunctionType &&value_of
+)
+{
+    const auto num_shards = (num_keys + shard_size - 1) / shard_size;
+    // A few partitions per thread even out differences in their sizes.  The
+    // partition is taken from bits of the hash which the hash maps do not use
+    // for tags, nor for choosing a group unless they hold over 2^32 groups.
+    std::size_t num_partitions = 1;
+    while (num_threads > 1 && num_partitions < 4 * std::size_t{num_threads}) {
+        num_partitions *= 2;
+    }
+    const auto partition_of = [&](std::uint64_t h) {
+        return static_cast<std::size_t>(h >> 32) & (num_partitions - 1);
+    };
+
+    std::vector<std::uint64_t> hashes(num_keys);
+    std::vector<std::vector<std::size_t>> members(
+        num_partitions > 1 ? num_shards * num_partitions : 0
+    );
+    parallel_for(num_shards, num_threads, [&](std::size_t shard, unsigned int) {
+        const auto begin = shard * shard_size;
+        const auto end = std::min(begin + shard_size, num_keys);
+        for (auto i = begin; i < end; ++i) {
+            hashes[i] = hash_words(keys + i * words_per_key, words_per_key);
+            if (num_partitions > 1) {
+                members[shard * num_partitions + partition_of(hashes[i])].push_back(i);
+            }
+        }
+    });
+
+    std::vector<std::vector<std::size_t>> partition_firsts(num_partitions);
+    std::vector<std::vector<ValueType>> partition_values(num_partitions);
+    parallel_for(num_partitions, num_threads, [&](std::size_t p, unsigned int) {
+        FlatBitstringMap<ValueType> map(words_per_key);
+        const auto visit = [&](std::size_t i) {
+            const auto *key = keys + i * words_per_key;
+            const auto [index, inserted] =
+                map.try_emplace_hashed(key, hashes[i], ValueType{});
+            if (inserted) {
+                partition_firsts[p].push_back(i);
+            }
+            map.value(index) += value_of(i);
+        };
+        if (num_partitions == 1) {
+            for (std::size_t i = 0; i < num_keys; ++i) {
+                visit(i);
+            }
+        } else {
+            for (std::size_t shard = 0; shard < num_shards; ++shard) {
+                for (const auto i : members[shard * num_partitions + p]) {
+                    visit(i);
+                }
+            }
+        }
+        partition_values[p] = map.values();
+    });
+
+    std::vector<std::size_t> firsts;
+    std::vector<ValueType> values;
+    for (std::size_t p = 0; p < num_partitions; ++p) {
+        firsts.insert(
+            firsts.end(), partition_firsts[p].begin(), partition_firsts[p].end()
+        );
+        values.insert(
+            values.end(), partition_values[p].begin(), partition_values[p].end()
+        );
+    }
+
+    // Put the unique keys in order, by the index of their first occurrence or
+    // by their words.  A single partition is already in order of occurrence.
+    const auto num_unique = firsts.size();
+    std::vector<std::uint64_t> sort_keys;
+    std::size_t words_per_sort_key = 1;
+    if (aggregation_method == AggregationMethod::sort_reduce) {
+        words_per_sort_key = words_per_key;
+        sort_keys.resize(num_unique * words_per_key);
+        for (std::size_t j = 0; j < num_unique; ++j) {
+            std::copy_n(
+                keys + firsts[j] * words_per_key, words_per_key,
+                sort_keys.data() + j * words_per_key
+            );
+        }
+    } else if (num_partitions > 1) {
+        sort_keys.assign(firsts.begin(), firsts.end());
+    } else {
+        return {std::move(firsts), std::move(values)};
+    }
+    const auto order =
+        radix_sort_permutation(sort_keys.data(), num_unique, words_per_sort_key);
+    std::vector<std::size_t> sorted_firsts(num_unique);
+    std::vector<ValueType> sorted_values(num_unique);
+    for (std::size_t j = 0; j < num_unique; ++j) {
+        sorted_firsts[j] = firsts[order[j]];
+        sorted_values[j] = values[order[j]];
+    }
+    return {std::move(sorted_firsts), std::move(sorted_values)};
+}
+
+// Deduplicate `bitstrings`, summing `value_of(i)` over the occurrences `i` of
+// each unique bitstring, on `num_threads` threads.
+template <
+    typename ValueType, typename BitstringVectorType, typename ValueVectorType,
+    typename FunctionType>
+std::pair<BitstringVectorType, ValueVectorType> _deduplicate_bitstrings(
+    const BitstringVectorType &bitstrings, std::size_t shard_size,
+    unsigned int num_threads, AggregationMethod aggregation_method,
+    FunctionType &&value_of
+)
+{
+    BitstringVectorType bitstrings_out;
+    ValueVectorType values_out;
+    if (bitstrings.empty()) {
+        return {std::move(bitstrings_out), std::move(values_out)};
+    }
+
+    std::size_t num_bits;
+    if constexpr (std::is_same_v<BitstringVectorType, PackedBitstringVector>) {
+        num_bits = bitstrings.num_bits();
+    } else {
+        num_bits = bitstring_size(*std::begin(bitstrings));
+    }
+    const auto words_per_key = words_for_bits(num_bits);
+    std::vector<std::uint64_t> storage;
+    const auto *keys =
+        _bitstring_keys(bitstrings, num_bits, shard_size, num_threads, storage);
+    const auto [firsts, values] = _deduplicate_keys<ValueType>(
+        keys, bitstrings.size(), words_per_key, shard_size, num_threads,
+        aggregation_method, value_of
+    );
+
+    for (std::size_t j = 0; j < firsts.size(); ++j) {
+        bitstrings_out.push_back(bitstrings[firsts[j]]);
+        values_out.push_back(values[j]);
+    }
+    return {std::move(bitstrings_out), std::move(values_out)};
+}
+
+} // namespace internal
+
+/// Reduce raw shots to unique bitstrings, summing their weights.
+///
+/// Each bitstring is returned once, with the sum of the weights of all of its
+/// occurrences, which are added in order of occurrence.  The result may be
+/// passed to `subsample`, which requires unique bitstrings.
+///
+/// @param[in] bitstrings A container (e.g., `std::vector`) of bitstrings, all of
+///     the same length.
+/// @param[in] weights A 1D array of the weight of each bitstring.  Must contain
+///     the same number of elements as `bitstrings`.
+/// @param[in] aggregation_method How duplicates are found, which also
+///     determines the order of the output: by first occurrence for
+///     `AggregationMethod::hash_map`, or ascending for
+///     `AggregationMethod::sort_reduce`.
+///
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+///
+/// @return The unique bitstrings, and a parallel array of their summed weights.
+template <typename BitstringVectorType, typename WeightVectorType>
+[[nodiscard]] std::pair<BitstringVectorType, WeightVectorType> deduplicate_bitstrings(
+    const BitstringVectorType &bitstrings, const WeightVectorType &weights,
+    AggregationMethod aggregation_method = AggregationMethod::hash_map
+)
+{
+    if (bitstrings.size() != weights.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Weights vector must match the number of bitstrings"
+        );
+    }
+    return internal::_deduplicate_bitstrings<
+        double, BitstringVectorType, WeightVectorType>(
+        bitstrings, std::max<std::size_t>(bitstrings.size(), 1), 1, aggregation_method,
+        [&](std::size_t i) { return static_cast<double>(weights[i]); }
+    );
+}
+
+/// Reduce raw shots to unique bitstrings, counting their occurrences.
+///
+/// The counts may be passed as the multiplicities of the overload of
+/// `recover_configurations` which takes measurement counts, so that each unique
+/// bitstring is prepared for correction only once.
+///
+/// @param[in] bitstrings A container (e.g., `std::vector`) of bitstrings, all of
+///     the same length.
+/// @param[in] aggregation_method How duplicates are found, which also
+///     determines the order of the output: by first occurrence for
+///     `AggregationMethod::hash_map`, or ascending for
+///     `AggregationMethod::sort_reduce`.
+///
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+///
+/// @return The unique bitstrings, and a parallel array of the number of times
+///     each occurs.
+template <typename BitstringVectorType>
+[[nodiscard]] std::pair<BitstringVectorType, std::vector<std::uint64_t>>
+deduplicate_bitstrings(
+    const BitstringVectorType &bitstrings,
+    AggregationMethod aggregation_method = AggregationMethod::hash_map
+)
+{
+    return internal::_deduplicate_bitstrings<
+        std::uint64_t, BitstringVectorType, std::vector<std::uint64_t>>(
+        bitstrings, std::max<std::size_t>(bitstrings.size(), 1), 1, aggregation_method,
+        [](std::size_t) { return std::uint64_t{1}; }
+    );
+}
+
+/// Reduce raw shots to unique bitstrings, summing their weights, using multiple
+/// threads.
+///
+/// The bitstrings are divided into shards of `parallel_options.shard_size`
+/// consecutive elements, which are hashed concurrently, and the bitstrings are
+/// then partitioned by hash among hash maps which are filled concurrently.  The
+/// weights of each bitstring are still added in order of occurrence, so the
+/// result is identical to that of the single-threaded overload, regardless of
+/// the number of threads and the shard size.  `parallel_options.seed` is not
+/// used.
+///
+/// @param[in] bitstrings A container (e.g., `std::vector`) of bitstrings, all of
+///     the same length.
+/// @param[in] weights A 1D array of the weight of each bitstring.  Must contain
+///     the same number of elements as `bitstrings`.
+/// @param[in] parallel_options Number of threads, and shard size.
+/// @param[in] aggregation_method How duplicates are found, which also
+///     determines the order of the output: by first occurrence for
+///     `AggregationMethod::hash_map`, or ascending for
+///     `AggregationMethod::sort_reduce`.
+///
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+///
+/// @return The unique bitstrings, and a parallel array of their summed weights.
+template <typename BitstringVectorType, typename WeightVectorType>
+[[nodiscard]] std::pair<BitstringVectorType, WeightVectorType> deduplicate_bitstrings(
+    const BitstringVectorType &bitstrings, const WeightVectorType &weights,
+    ParallelOptions parallel_options,
+    AggregationMethod aggregation_method = AggregationMethod::hash_map
+)
+{
+    if (bitstrings.size() != weights.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Weights vector must match the number of bitstrings"
+        );
+    }
+    if (parallel_options.shard_size == 0) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("Shard size must be nonzero.");
+    }
+    const auto shard_size = parallel_options.shard_size;
+    const auto num_threads = internal::resolve_num_threads(
+        parallel_options.num_threads, (bitstrings.size() + shard_size - 1) / shard_size
+    );
+    return internal::_deduplicate_bitstrings<
+        double, BitstringVectorType, WeightVectorType>(
+        bitstrings, shard_size, num_threads, aggregation_method,
+        [&](std::size_t i) { return static_cast<double>(weights[i]); }
+    );
+}
+
+/// Reduce raw shots to unique bitstrings, counting their occurrences, using
+/// multiple threads.
+///
+/// The work is divided as in the weighted overload, and the result is identical
+/// to that of the single-threaded overload.
+///
+/// @param[in] bitstrings A container (e.g., `std::vector`) of bitstrings, all of
+///     the same length.
+/// @param[in] parallel_options Number of threads, and shard size.
+/// @param[in] aggregation_method How duplicates are found, which also
+///     determines the order of the output: by first occurrence for
+///     `AggregationMethod::hash_map`, or ascending for
+///     `AggregationMethod::sort_reduce`.
+///
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+///
+/// @return The unique bitstrings, and a parallel array of the number of times
+///     each occurs.
+template <typename BitstringVectorType>
+[[nodiscard]] std::pair<BitstringVectorType, std::vector<std::uint64_t>>
+deduplicate_bitstrings(
+    const BitstringVectorType &bitstrings, ParallelOptions parallel_options,
+    AggregationMethod aggregation_method = AggregationMethod::hash_map
+)
+{
+    if (parallel_options.shard_size == 0) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("Shard size must be nonzero.");
+    }
+    const auto shard_size = parallel_options.shard_size;
+    const auto num_threads = internal::resolve_num_threads(
+        parallel_options.num_threads, (bitstrings.size() + shard_size - 1) / shard_size
+    );
+    return internal::_deduplicate_bitstrings<
+        std::uint64_t, BitstringVectorType, std::vector<std::uint64_t>>(
+        bitstrings, shard_size, num_threads, aggregation_method,
+        [](std::size_t) { return std::uint64_t{1}; }
+    );
+}
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // QISKIT_ADDON_SQD_DEDUPLICATION_HPP_
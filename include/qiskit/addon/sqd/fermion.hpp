@@ -18,14 +18,19 @@
 #include <algorithm>
 #include <array>
 #include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <numeric>
 #include <optional>
-#include <unordered_map>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "qiskit/addon/sqd/bitset_full.hpp"
 #include "qiskit/addon/sqd/internal/exception-macros.hpp"
+#include "qiskit/addon/sqd/internal/flat-hash-map.hpp"
+#include "qiskit/addon/sqd/internal/parallel.hpp"
 
 namespace Qiskit
 {
@@ -39,13 +44,130 @@ namespace sqd
 namespace internal
 {
 
+/// Counts the occurrences of distinct CI strings of `norb` orbitals, keyed by
+/// their words, and keeps one copy of each in order of first occurrence.
+template <typename HalfBitstringType>
+class CIStringCounter
+{
+  private:
+    std::size_t norb;
+    FlatBitstringMap<unsigned int> counts;
+    std::vector<HalfBitstringType> ci_strings;
+    // Scratch space for the words of a bitstring, and of one of its halves
+    std::vector<std::uint64_t> words;
+    std::vector<std::uint64_t> key;
+
+    // Count the CI string whose words are in `key`.  A CI string is only
+    // materialized the first time it is seen.
+    void add_key(unsigned int count)
+    {
+        const auto [index, inserted] = counts.try_emplace(key.data(), 0u);
+        if (inserted) {
+            HalfBitstringType ci_string;
+            AssignWordsImpl<HalfBitstringType>::assign(ci_string, key.data(), norb);
+            ci_strings.push_back(std::move(ci_string));
+        }
+        counts.value(index) += count;
+    }
+
+  public:
+    CIStringCounter(std::size_t norb, std::size_t expected_size)
+        : norb(norb), counts(words_for_bits(norb), expected_size),
+          words(words_for_bits(2 * norb)), key(words_for_bits(norb))
+    {
+    }
+
+    /// Add `count` occurrences of a CI string.
+    void add_ci_string(const HalfBitstringType &ci_string, unsigned int count)
+    {
+        WordsImpl<HalfBitstringType>::copy(ci_string, key.data());
+        add_key(count);
+    }
+
+    /// Add one occurrence of each half of a bitstring, right half first,
+    /// working on the words of the bitstring so that nothing is allocated.
+    template <typename BitstringType>
+    void add_bitstring(const BitstringType &bitstring)
+    {
+        if (bitstring_size(bitstring) != 2 * norb) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_("Bitstrings must have uniform length");
+        }
+        WordsImpl<BitstringType>::copy(bitstring, words.data());
+        for (std::size_t s = 0; s < 2; ++s) {
+            extract_bits(words.data(), s * norb, norb, key.data());
+            add_key(1);
+        }
+    }
+
+    /// Add the counts of `other`, whose CI strings are moved into this counter
+    /// if they are new.  The hashes of the CI strings are reused.
+    void merge(CIStringCounter &&other)
+    {
+        counts.merge(
+            other.counts,
+            [&](std::size_t other_index, std::size_t index, bool inserted) {
+                if (inserted) {
+                    ci_strings.push_back(std::move(other.ci_strings[other_index]));
+                } else {
+                    counts.value(index) += other.counts.value(other_index);
+                }
+            }
+        );
+    }
+
+    /// Return the `max_dimension` CI strings with the largest counts, or all of
+    /// them, by decreasing count.  Equal counts are ordered by first occurrence.
+    std::vector<HalfBitstringType>
+    top(std::optional<unsigned int> max_dimension) &&
+    {
+        std::vector<std::size_t> order(ci_strings.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        const auto by_count = [&](std::size_t a, std::size_t b) {
+            const auto count_a = counts.value(a), count_b = counts.value(b);
+            return count_a > count_b || (count_a == count_b && a < b);
+        };
+        if (max_dimension && *max_dimension < order.size()) {
+            // Only the first `max_dimension` need to be sorted
+            const auto middle = order.begin() + *max_dimension;
+            std::partial_sort(order.begin(), middle, order.end(), by_count);
+            order.erase(middle, order.end());
+        } else {
+            std::sort(order.begin(), order.end(), by_count);
+        }
+
+        std::vector<HalfBitstringType> retval;
+        retval.reserve(order.size());
+        for (const auto index : order) {
+            retval.push_back(std::move(ci_strings[index]));
+        }
+        return retval;
+    }
+};
+
+// Number of distinct CI strings of `norb` orbitals to reserve space for, when
+// counting `num_ci_strings` of them.  There are at most 2^norb distinct ones.
+// The estimate is capped, since the table can grow without hashing any key
+// again, while reserving for every CI string of a large input would waste
+// memory when most are duplicates.
+inline std::size_t
+_expected_num_ci_strings(std::size_t num_ci_strings, std::size_t norb)
+{
+    constexpr std::size_t max_expected = std::size_t{1} << 20;
+    auto expected = std::min(num_ci_strings, max_expected);
+    if (norb < 64) {
+        expected = std::min<std::size_t>(expected, std::uint64_t{1} << norb);
+    }
+    return expected;
+}
+
 } // namespace internal
 
 /// Convert bitstrings into CI strings (representations of determinants).
 ///
 /// This function separates each bitstring in bitstring_matrix in half, combining the
 /// right and left halves of all the bitstrings into a single set of unique
-/// configurations.
+/// configurations.  The CI strings are returned in order of decreasing number of
+/// occurrences, with ties broken by order of first occurrence.
 ///
 /// @param[in] bitstrings Population of bitstrings.
 /// @param[in] max_dimension Maximum dimension of returned CI strings.  If less than the
@@ -69,57 +191,125 @@ auto bitstrings_to_ci_strings_symmetrize_spin(
     if (bitstrings.empty()) {
         return std::vector<HalfBitstringType>();
     }
-    if (bitstrings[0].size() % 2 != 0) {
+    if (internal::bitstring_size(bitstrings[0]) % 2 != 0) {
         QKA_SQD_THROW_INVALID_ARGUMENT_("Bitstring length must be even");
     }
-    const auto norb = bitstrings[0].size() / 2;
+    const auto norb = internal::bitstring_size(bitstrings[0]) / 2;
 
-    std::unordered_map<HalfBitstringType, unsigned int> counts;
+    internal::CIStringCounter<HalfBitstringType> counter(
+        norb, internal::_expected_num_ci_strings(2 * bitstrings.size(), norb)
+    );
     // Include any CI strings that are being explicitly included
     if (include_configurations) {
         for (const auto &ci_string : include_configurations->get()) {
-            if (ci_string.size() != norb) {
+            if (internal::bitstring_size(ci_string) != norb) {
                 QKA_SQD_THROW_INVALID_ARGUMENT_(
                     "CI string in `include_configurations` has length not equal to the "
                     "number of orbitals"
                 );
             }
             // Add a large constant, which is larger than any existing count
-            counts[ci_string] += bitstrings.size();
+            counter.add_ci_string(
+                ci_string, static_cast<unsigned int>(bitstrings.size())
+            );
         }
     }
     // For each bitstrings, separate into CI strings
     for (const auto &bitstring : bitstrings) {
-        if (bitstring.size() != 2 * norb) {
-            QKA_SQD_THROW_INVALID_ARGUMENT_("Bitstrings must have uniform length");
-        }
-        auto [right_ci, left_ci] = internal::split_bitstring(bitstring);
-        ++counts[right_ci];
-        ++counts[left_ci];
+        counter.add_bitstring(bitstring);
     }
 
-    // Sort them by count, largest first
-    std::vector<std::pair<unsigned int, HalfBitstringType>> by_counts;
-    by_counts.reserve(counts.size());
-    for (const auto &[ci_string, count] : counts) {
-        by_counts.emplace_back(count, std::move(ci_string));
+    // Sort them by count, largest first, truncating if max_dimension is given
+    return std::move(counter).top(max_dimension);
+}
+
+/// Convert bitstrings into CI strings (representations of determinants), using
+/// multiple threads.
+///
+/// The bitstrings are divided into shards of `parallel_options.shard_size`
+/// consecutive elements, whose CI strings are counted concurrently and then
+/// merged in order.  The result is identical to that of the single-threaded
+/// overload.  `parallel_options.seed` is not used.
+///
+/// @param[in] bitstrings Population of bitstrings.
+/// @param[in] parallel_options Number of threads, and shard size.
+/// @param[in] max_dimension Maximum dimension of returned CI strings.  If less than the
+///     number of CI strings, the list of CI strings will be truncated.
+/// @param[in] include_configurations A list of CI strings that will be included in the
+///     output, regardless of whether they are contained in \p bitstrings.
+///
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+template <class BitstringVectorType>
+auto bitstrings_to_ci_strings_symmetrize_spin(
+    const BitstringVectorType &bitstrings, ParallelOptions parallel_options,
+    std::optional<unsigned int> max_dimension = std::nullopt,
+    std::optional<std::reference_wrapper<const std::vector<
+        internal::HalfSize<typename BitstringVectorType::value_type>>>>
+        include_configurations = std::nullopt
+) -> std::vector<internal::HalfSize<typename BitstringVectorType::value_type>>
+{
+    using BitstringType = typename BitstringVectorType::value_type;
+    using HalfBitstringType = internal::HalfSize<BitstringType>;
+    if (parallel_options.shard_size == 0) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("Shard size must be nonzero.");
+    }
+    if (bitstrings.empty()) {
+        return std::vector<HalfBitstringType>();
+    }
+    if (internal::bitstring_size(bitstrings[0]) % 2 != 0) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("Bitstring length must be even");
     }
-    std::sort(by_counts.begin(), by_counts.end(), [](const auto &a, const auto &b) {
-        return a.first > b.first;
-    });
+    const auto norb = internal::bitstring_size(bitstrings[0]) / 2;
 
-    // Truncate if max_dimension is given
-    if (max_dimension && by_counts.size() > *max_dimension) {
-        by_counts.resize(*max_dimension);
+    internal::CIStringCounter<HalfBitstringType> counter(norb, 0);
+    // Include any CI strings that are being explicitly included
+    if (include_configurations) {
+        for (const auto &ci_string : include_configurations->get()) {
+            if (internal::bitstring_size(ci_string) != norb) {
+                QKA_SQD_THROW_INVALID_ARGUMENT_(
+                    "CI string in `include_configurations` has length not equal to the "
+                    "number of orbitals"
+                );
+            }
+            // Add a large constant, which is larger than any existing count
+            counter.add_ci_string(
+                ci_string, static_cast<unsigned int>(bitstrings.size())
+            );
+        }
     }
 
-    // Populate return value
-    std::vector<HalfBitstringType> retval;
-    retval.reserve(by_counts.size());
-    for (const auto &[_, ci_string] : by_counts) {
-        retval.push_back(std::move(ci_string));
+    // Each shard counts its CI strings in order of first occurrence, so that the
+    // merge below does not depend on the scheduling.
+    const auto num_bitstrings = bitstrings.size();
+    const auto shard_size = parallel_options.shard_size;
+    const auto num_shards = (num_bitstrings + shard_size - 1) / shard_size;
+    const auto num_threads =
+        internal::resolve_num_threads(parallel_options.num_threads, num_shards);
+    std::vector<std::optional<internal::CIStringCounter<HalfBitstringType>>>
+        shard_counters(num_shards);
+    internal::parallel_for(
+        num_shards, num_threads,
+        [&](std::size_t shard, unsigned int /*thread*/) {
+            const auto begin = shard * shard_size;
+            const auto end = std::min(begin + shard_size, num_bitstrings);
+            auto &shard_counter = shard_counters[shard].emplace(
+                norb, internal::_expected_num_ci_strings(2 * (end - begin), norb)
+            );
+            for (auto i = begin; i < end; ++i) {
+                shard_counter.add_bitstring(bitstrings[i]);
+            }
+        }
+    );
+
+    // Merge the shards in order
+    for (auto &shard_counter : shard_counters) {
+        counter.merge(std::move(*shard_counter));
+        shard_counter.reset();
     }
-    return retval;
+
+    // Sort them by count, largest first, truncating if max_dimension is given
+    return std::move(counter).top(max_dimension);
 }
 
 } // namespace sqd
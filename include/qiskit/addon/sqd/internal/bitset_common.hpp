@@ -15,9 +15,17 @@
 
 /// Interfaces/utilities for supporting a variety of bitset types.
 
+#include <algorithm>
 #include <array>
 #include <bitset>
+#include <climits>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if __cplusplus >= 202002L && __has_include(<bit>)
+#include <bit>
+#endif
 
 namespace Qiskit
 {
@@ -31,7 +39,151 @@ namespace sqd
 namespace internal
 {
 
+/// Number of 64-bit words needed to hold `num_bits` bits.
+constexpr std::size_t words_for_bits(std::size_t num_bits)
+{
+    return (num_bits + 63) / 64;
+}
+
+/// Mask selecting the lowest `n` bits of a 64-bit word, for `n` in [0, 64].
+constexpr std::uint64_t low_bits_mask(std::size_t n)
+{
+    return n >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+}
+
+/// Count the set bits in a 64-bit word.
+inline unsigned int popcount64(std::uint64_t word)
+{
+#if defined(__cpp_lib_bitops)
+    return static_cast<unsigned int>(std::popcount(word));
+#elif defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned int>(__builtin_popcountll(word));
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<unsigned int>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/// Index of the lowest set bit of a nonzero 64-bit word.
+inline unsigned int countr_zero64(std::uint64_t word)
+{
+#if defined(__cpp_lib_bitops)
+    return static_cast<unsigned int>(std::countr_zero(word));
+#elif defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned int>(__builtin_ctzll(word));
+#else
+    return popcount64((word & (~word + 1)) - 1);
+#endif
+}
+
+/// Return `true` if the host stores integers least significant byte first.
+inline bool host_is_little_endian()
+{
+    const std::uint32_t one = 1;
+    unsigned char first_byte;
+    std::memcpy(&first_byte, &one, 1);
+    return first_byte == 1;
+}
+
+/// Call `func(i)` for the index `i` of each set bit of a bitmap of
+/// `num_words` 64-bit words, in increasing order.
+template <typename FunctionType>
+void for_each_set_bit(
+    const std::uint64_t *bitmap, std::size_t num_words, FunctionType &&func
+)
+{
+    for (std::size_t k = 0; k < num_words; ++k) {
+        for (std::uint64_t word = bitmap[k]; word != 0; word &= word - 1) {
+            func(k * 64 + countr_zero64(word));
+        }
+    }
+}
+
+/// Count the set bits in positions `[begin, end)` of an array of 64-bit words.
+inline std::size_t
+count_bits_in_range(const std::uint64_t *words, std::size_t begin, std::size_t end)
+{
+    if (begin >= end) {
+        return 0;
+    }
+    const auto first_word = begin / 64;
+    const auto last_word = (end - 1) / 64;
+    const auto first_mask = ~low_bits_mask(begin % 64);
+    const auto last_mask = low_bits_mask(end - last_word * 64);
+    if (first_word == last_word) {
+        return popcount64(words[first_word] & first_mask & last_mask);
+    }
+    std::size_t count = popcount64(words[first_word] & first_mask);
+    for (auto i = first_word + 1; i < last_word; ++i) {
+        count += popcount64(words[i]);
+    }
+    return count + popcount64(words[last_word] & last_mask);
+}
+
+/// Copy `num_bits` bits, starting at bit `offset` of `words`, into `out`.
+inline void extract_bits(
+    const std::uint64_t *words, std::size_t offset, std::size_t num_bits,
+    std::uint64_t *out
+)
+{
+    const auto word_shift = offset / 64;
+    const auto bit_shift = offset % 64;
+    const auto num_out_words = words_for_bits(num_bits);
+    const auto num_in_words = words_for_bits(offset + num_bits);
+    for (std::size_t i = 0; i < num_out_words; ++i) {
+        auto word = words[word_shift + i] >> bit_shift;
+        if (bit_shift != 0 && word_shift + i + 1 < num_in_words) {
+            word |= words[word_shift + i + 1] << (64 - bit_shift);
+        }
+        out[i] = word;
+    }
+    if (num_out_words != 0) {
+        out[num_out_words - 1] &= low_bits_mask(num_bits - (num_out_words - 1) * 64);
+    }
+}
+
+/// Number of bits in a bitstring.
+///
+/// Specialize this for bitstring types without a `size()` member which returns
+/// it, such as native integers.
+template <typename T, typename = void>
+struct SizeImpl {
+    static std::size_t size(const T &bitstring)
+    {
+        return bitstring.size();
+    }
+};
+
 template <typename T>
+std::size_t bitstring_size(const T &bitstring)
+{
+    return SizeImpl<T>::size(bitstring);
+}
+
+/// Number of bits in every bitstring of type `T`, or 0 if it is not fixed by the
+/// type.
+template <typename T, typename = void>
+struct FixedSizeImpl {
+    static constexpr std::size_t value = 0;
+};
+
+template <std::size_t N>
+struct FixedSizeImpl<std::bitset<N>> {
+    static constexpr std::size_t value = N;
+};
+
+/// Flip bit `i` of a bitstring.
+template <typename T, typename = void>
+struct FlipImpl {
+    static void flip(T &bitstring, std::size_t i)
+    {
+        bitstring.flip(i);
+    }
+};
+
+template <typename T, typename = void>
 struct HalfSizeImpl;
 
 template <std::size_t N>
@@ -43,16 +195,215 @@ struct HalfSizeImpl<std::bitset<N>> {
 template <typename T>
 using HalfSize = typename HalfSizeImpl<T>::type;
 
+/// Count the set bits in the right and left halves of a bitstring.
+///
+/// The size of the bitstring is assumed to be even.  Specialize this for bitset
+/// types that can count their halves more efficiently.
+template <typename T, typename = void>
+struct RightLeftHammingImpl {
+    static std::array<std::size_t, 2> count(const T &bitstring)
+    {
+        const std::size_t left_count = (bitstring >> (bitstring.size() / 2)).count();
+        const std::size_t right_count = bitstring.count() - left_count;
+        return {right_count, left_count};
+    }
+};
+
+/// Accumulates the set bits on either side of bit `half_N` of a bitstring whose
+/// words are fed to it in order, least significant word first.
+template <typename Word>
+class RightLeftWordCounter
+{
+  private:
+    static_assert(sizeof(Word) <= sizeof(std::uint64_t), "Word must fit in 64 bits");
+    static constexpr std::size_t bits_per_word = sizeof(Word) * CHAR_BIT;
+    std::size_t half_N;
+    std::size_t word_begin = 0;
+    std::array<std::size_t, 2> right_left_counts{0, 0};
+
+  public:
+    explicit RightLeftWordCounter(std::size_t half_N) : half_N(half_N) {}
+
+    void operator()(Word word)
+    {
+        const auto value = static_cast<std::uint64_t>(word);
+        if (word_begin + bits_per_word <= half_N) {
+            right_left_counts[0] += popcount64(value);
+        } else if (word_begin >= half_N) {
+            right_left_counts[1] += popcount64(value);
+        } else {
+            // This word straddles the two halves
+            const auto split = half_N - word_begin;
+            right_left_counts[0] += popcount64(value & low_bits_mask(split));
+            right_left_counts[1] += popcount64(value >> split);
+        }
+        word_begin += bits_per_word;
+    }
+
+    const std::array<std::size_t, 2> &counts() const
+    {
+        return right_left_counts;
+    }
+};
+
 template <std::size_t N>
-std::array<HalfSize<std::bitset<N>>, 2> split_bitstring(const std::bitset<N> &bitset)
+struct RightLeftHammingImpl<std::bitset<N>> {
+    static std::array<std::size_t, 2> count(const std::bitset<N> &bitstring)
+    {
+        constexpr auto half_N = N / 2;
+        if constexpr (N <= 64) {
+            // The whole bitstring fits in a single word
+            const std::uint64_t word = bitstring.to_ullong();
+            return {
+                popcount64(word & low_bits_mask(half_N)),
+                popcount64(word >> half_N)
+            };
+        } else {
+            static const std::bitset<N> right_mask = ~std::bitset<N>() >> (N - half_N);
+            const std::size_t right_count = (bitstring & right_mask).count();
+            return {right_count, bitstring.count() - right_count};
+        }
+    }
+};
+
+/// Copy the bits of a bitstring into `words_for_bits(bitstring_size(bitstring))`
+/// 64-bit words, least significant word first, with the unused high bits of the
+/// last word cleared.
+///
+/// Specialize this for bitset types whose storage can be read directly.
+template <typename T, typename = void>
+struct WordsImpl {
+    static void copy(const T &bitstring, std::uint64_t *words)
+    {
+        const auto num_bits = bitstring.size();
+        std::fill(words, words + words_for_bits(num_bits), std::uint64_t{0});
+        for (std::size_t i = 0; i < num_bits; ++i) {
+            if (bitstring[i]) {
+                words[i / 64] |= std::uint64_t{1} << (i % 64);
+            }
+        }
+    }
+};
+
+/// Packs a sequence of words of type `Word`, least significant first, into an
+/// array of 64-bit words.
+template <typename Word>
+class WordPacker
+{
+  private:
+    static_assert(
+        sizeof(std::uint64_t) % sizeof(Word) == 0, "Word must evenly divide 64 bits"
+    );
+    static constexpr std::size_t bits_per_word = sizeof(Word) * CHAR_BIT;
+    std::uint64_t *words;
+    std::size_t bit_offset = 0;
+
+  public:
+    explicit WordPacker(std::uint64_t *words) : words(words) {}
+
+    void operator()(Word word)
+    {
+        auto &target = words[bit_offset / 64];
+        if (bit_offset % 64 == 0) {
+            target = 0;
+        }
+        target |= static_cast<std::uint64_t>(word) << (bit_offset % 64);
+        bit_offset += bits_per_word;
+    }
+};
+
+template <std::size_t N>
+struct WordsImpl<std::bitset<N>> {
+    static void copy(const std::bitset<N> &bitstring, std::uint64_t *words)
+    {
+        if constexpr (N <= 64) {
+            if constexpr (N > 0) {
+                words[0] = bitstring.to_ullong();
+            }
+        } else {
+            static const std::bitset<N> low_word_mask(~0ULL);
+            for (std::size_t k = 0; k < words_for_bits(N); ++k) {
+                words[k] = ((bitstring >> (64 * k)) & low_word_mask).to_ullong();
+            }
+        }
+    }
+};
+
+/// Set the bits of a bitstring from `words_for_bits(num_bits)` 64-bit words,
+/// least significant word first.
+///
+/// The primary template sets the bits one at a time, and assumes the bitstring
+/// already has `num_bits` bits.  Specialize this for bitset types whose storage
+/// can be written more directly, or which must be resized.
+template <typename T, typename = void>
+struct AssignWordsImpl {
+    static void assign(T &bitstring, const std::uint64_t *words, std::size_t num_bits)
+    {
+        for (std::size_t i = 0; i < num_bits; ++i) {
+            bitstring.set(i, (words[i / 64] >> (i % 64)) & 1);
+        }
+    }
+};
+
+/// Assign `words_for_bits(N)` words to a fixed-size bitset type of `N` bits which
+/// is constructible from `unsigned long long`, a word at a time.
+template <std::size_t N, typename BitsetType>
+void assign_fixed_size_words(BitsetType &bitstring, const std::uint64_t *words)
+{
+    if constexpr (N == 0) {
+        bitstring.reset();
+    } else if constexpr (N <= 64) {
+        bitstring = BitsetType(static_cast<unsigned long long>(words[0]));
+    } else {
+        bitstring.reset();
+        for (auto k = words_for_bits(N); k-- > 0;) {
+            bitstring <<= 64;
+            bitstring |= BitsetType(static_cast<unsigned long long>(words[k]));
+        }
+    }
+}
+
+template <std::size_t N>
+struct AssignWordsImpl<std::bitset<N>> {
+    static void assign(
+        std::bitset<N> &bitstring, const std::uint64_t *words, std::size_t /*num_bits*/
+    )
+    {
+        assign_fixed_size_words<N>(bitstring, words);
+    }
+};
+
+/// Split a fixed-size bitset type of `N` bits into its right and left halves,
+/// shifting and masking whole words, with all storage on the stack.
+template <std::size_t N, typename BitsetType>
+std::array<HalfSize<BitsetType>, 2> split_fixed_size_bitstring(const BitsetType &bitset)
 {
+    using HalfType = HalfSize<BitsetType>;
     constexpr auto half_N = N / 2;
-    HalfSize<std::bitset<N>> right, left;
-    for (std::size_t i = 0; i < half_N; ++i) {
-        right[i] = bitset[i];
-        left[i] = bitset[i + half_N];
+    if constexpr (N <= 64) {
+        // The whole bitstring fits in a single word
+        const std::uint64_t word = bitset.to_ullong();
+        return {
+            HalfType(static_cast<unsigned long long>(word & low_bits_mask(half_N))),
+            HalfType(static_cast<unsigned long long>(word >> half_N))
+        };
+    } else {
+        std::array<std::uint64_t, words_for_bits(N)> words;
+        std::array<std::uint64_t, words_for_bits(half_N)> half_words;
+        WordsImpl<BitsetType>::copy(bitset, words.data());
+        std::array<HalfType, 2> retval;
+        for (std::size_t s = 0; s < 2; ++s) {
+            extract_bits(words.data(), s * half_N, half_N, half_words.data());
+            AssignWordsImpl<HalfType>::assign(retval[s], half_words.data(), half_N);
+        }
+        return retval;
     }
-    return {right, left};
+}
+
+template <std::size_t N>
+std::array<HalfSize<std::bitset<N>>, 2> split_bitstring(const std::bitset<N> &bitset)
+{
+    return split_fixed_size_bitstring<N>(bitset);
 }
 
 } // namespace internal
@@ -0,0 +1,410 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_INTERNAL_FLAT_HASH_MAP_HPP_
+#define QISKIT_ADDON_SQD_INTERNAL_FLAT_HASH_MAP_HPP_
+
+/// Open-addressing hash map keyed by fixed-width arrays of 64-bit words.
+///
+/// Groups of control bytes are probed with SSE2 or NEON when the compiler
+/// targets them, and with portable 64-bit word operations otherwise.  Define
+/// `QKA_SQD_DISABLE_SIMD` to 1 to always use the portable code.
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "qiskit/addon/sqd/internal/bitset_common.hpp"
+
+#if !QKA_SQD_DISABLE_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QKA_SQD_FLAT_HASH_SSE2_ 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define QKA_SQD_FLAT_HASH_NEON_ 1
+#include <arm_neon.h>
+#endif
+#endif // !QKA_SQD_DISABLE_SIMD
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+namespace internal
+{
+
+/// Hash an array of `num_words` 64-bit words.
+///
+/// Each word is folded into the state with a multiply and xor-shift, and the
+/// result is finished with the SplitMix64 finalizer, so that both the low bits
+/// (which select the group) and the high bits (which form the tag) are well
+/// mixed.
+inline std::uint64_t hash_words(const std::uint64_t *words, std::size_t num_words)
+{
+    std::uint64_t h = 0x9e3779b97f4a7c15ULL * (num_words + 1);
+    for (std::size_t i = 0; i < num_words; ++i) {
+        h = (h ^ words[i]) * 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 29;
+    }
+    h = (h ^ (h >> 32)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 29);
+}
+
+// A `ControlGroup` loads `width` consecutive control bytes and returns bitmasks
+// of those which hold a given tag, or are empty.  Each byte corresponds to
+// `1 << shift` bits of the mask, of which only the highest may be set, so that
+// the index of a matching byte is `countr_zero64(mask) >> shift`.  The portable
+// `match` may report false positives, which are rejected when the keys are
+// compared, but never reports an empty byte.
+
+constexpr std::uint8_t empty_control = 0x80;
+
+#if QKA_SQD_FLAT_HASH_SSE2_
+struct ControlGroup {
+    static constexpr std::size_t width = 16;
+    static constexpr unsigned int shift = 0;
+
+    explicit ControlGroup(const std::uint8_t *p)
+        : bytes_(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)))
+    {
+    }
+    std::uint64_t match(std::uint8_t tag) const
+    {
+        const auto pattern = _mm_set1_epi8(static_cast<char>(tag));
+        return static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(bytes_, pattern))
+        );
+    }
+    std::uint64_t match_empty() const
+    {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(bytes_));
+    }
+
+  private:
+    __m128i bytes_;
+};
+#elif QKA_SQD_FLAT_HASH_NEON_
+struct ControlGroup {
+    static constexpr std::size_t width = 16;
+    static constexpr unsigned int shift = 2;
+
+    explicit ControlGroup(const std::uint8_t *p) : bytes_(vld1q_u8(p))
+    {
+    }
+    std::uint64_t match(std::uint8_t tag) const
+    {
+        return to_mask(vceqq_u8(bytes_, vdupq_n_u8(tag)));
+    }
+    std::uint64_t match_empty() const
+    {
+        return to_mask(vcgeq_u8(bytes_, vdupq_n_u8(empty_control)));
+    }
+
+  private:
+    static std::uint64_t to_mask(uint8x16_t v)
+    {
+        const auto narrowed = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) &
+               0x8888888888888888ULL;
+    }
+
+    uint8x16_t bytes_;
+};
+#else
+struct ControlGroup {
+    static constexpr std::size_t width = 8;
+    static constexpr unsigned int shift = 3;
+
+    explicit ControlGroup(const std::uint8_t *p)
+    {
+        std::memcpy(&bytes_, p, sizeof(bytes_));
+    }
+    std::uint64_t match(std::uint8_t tag) const
+    {
+        const auto v = bytes_ ^ (lsb * tag);
+        return (v - lsb) & ~v & msb;
+    }
+    std::uint64_t match_empty() const
+    {
+        return bytes_ & msb;
+    }
+
+  private:
+    static constexpr std::uint64_t lsb = 0x0101010101010101ULL;
+    static constexpr std::uint64_t msb = 0x8080808080808080ULL;
+
+    std::uint64_t bytes_;
+};
+#endif
+
+/// Hash map from keys of `words_per_key` 64-bit words to values of type
+/// `MappedType`.
+///
+/// The entries are stored densely, in order of insertion, and are addressed by
+/// their index in that order.  Each entry keeps its hash, so growing the table
+/// and merging another table into this one never hash a key twice.  Entries
+/// cannot be erased.
+template <typename MappedType>
+class FlatBitstringMap
+{
+  public:
+    /// Index returned by `find` when a key is absent.
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// Construct an empty map, with room for `expected_size` entries.
+    explicit FlatBitstringMap(std::size_t words_per_key, std::size_t expected_size = 0)
+        : words_per_key_(words_per_key)
+    {
+        reserve(expected_size);
+    }
+
+    std::size_t words_per_key() const noexcept
+    {
+        return words_per_key_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return values_.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return values_.empty();
+    }
+
+    /// Key of entry number `index`, as an array of `words_per_key()` words.
+    const std::uint64_t *key(std::size_t index) const
+    {
+        return keys_.data() + index * words_per_key_;
+    }
+
+    /// Cached hash of entry number `index`.
+    std::uint64_t hash(std::size_t index) const
+    {
+        return hashes_[index];
+    }
+
+    MappedType &value(std::size_t index)
+    {
+        return values_[index];
+    }
+
+    const MappedType &value(std::size_t index) const
+    {
+        return values_[index];
+    }
+
+    /// Values of all entries, in order of insertion.
+    const std::vector<MappedType> &values() const noexcept
+    {
+        return values_;
+    }
+
+    /// Make room for `expected_size` entries, so that inserting up to that many
+    /// does not grow the table.
+    void reserve(std::size_t expected_size)
+    {
+        keys_.reserve(expected_size * words_per_key_);
+        hashes_.reserve(expected_size);
+        values_.reserve(expected_size);
+        reserve_slots(expected_size);
+    }
+
+    /// Remove all entries, keeping the allocated memory.
+    void clear()
+    {
+        keys_.clear();
+        hashes_.clear();
+        values_.clear();
+        std::fill(control_.begin(), control_.end(), empty_control);
+    }
+
+    /// Index of the entry with the given key, or `npos` if there is none.
+    std::size_t find(const std::uint64_t *key) const
+    {
+        return find_hashed(key, hash_words(key, words_per_key_));
+    }
+
+    /// Insert an entry with the given key and value, unless one with that key
+    /// already exists.
+    ///
+    /// @return The index of the entry with the given key, and whether it was
+    ///     inserted.
+    std::pair<std::size_t, bool> try_emplace(const std::uint64_t *key, MappedType value)
+    {
+        const auto h = hash_words(key, words_per_key_);
+        return try_emplace_hashed(key, h, std::move(value));
+    }
+
+    /// Like `try_emplace`, with the hash of `key` already computed by
+    /// `hash_words`.
+    std::pair<std::size_t, bool>
+    try_emplace_hashed(const std::uint64_t *key, std::uint64_t h, MappedType value)
+    {
+        if (size() == max_load()) {
+            rebuild(std::max<std::size_t>(2 * num_groups_, 1));
+        }
+        const auto tag = tag_of(h);
+        for (auto group = h & group_mask_;; group = (group + 1) & group_mask_) {
+            const ControlGroup g(control_.data() + group * ControlGroup::width);
+            for (auto mask = g.match(tag); mask != 0; mask &= mask - 1) {
+                const auto slot = first_slot(group, mask);
+                const auto index = slots_[slot];
+                if (hashes_[index] == h && keys_equal(this->key(index), key)) {
+                    return {index, false};
+                }
+            }
+            if (const auto empty = g.match_empty(); empty != 0) {
+                const auto slot = first_slot(group, empty);
+                const auto index = size();
+                control_[slot] = tag;
+                slots_[slot] = index;
+                keys_.insert(keys_.end(), key, key + words_per_key_);
+                hashes_.push_back(h);
+                values_.push_back(std::move(value));
+                return {index, true};
+            }
+        }
+    }
+
+    /// Merge the entries of `other`, which must have the same number of words
+    /// per key, into this map, reusing their cached hashes.
+    ///
+    /// The entries of `other` are visited in order of insertion.  Those whose
+    /// key is new are appended to this map with a copy of their value.  For
+    /// each entry, `func(other_index, index, inserted)` is then called with its
+    /// index in `other` and in this map, and whether it was inserted.
+    template <typename FunctionType>
+    void merge(const FlatBitstringMap &other, FunctionType &&func)
+    {
+        assert(other.words_per_key_ == words_per_key_);
+        reserve_slots(size() + other.size());
+        for (std::size_t j = 0; j < other.size(); ++j) {
+            const auto [index, inserted] =
+                try_emplace_hashed(other.key(j), other.hash(j), other.value(j));
+            func(j, index, inserted);
+        }
+    }
+
+  private:
+    std::size_t words_per_key_;
+    std::size_t num_groups_ = 0;
+    std::size_t group_mask_ = 0;
+    // One control byte per slot: `empty_control`, or the tag of the entry
+    std::vector<std::uint8_t> control_;
+    // Index of the entry in each occupied slot
+    std::vector<std::size_t> slots_;
+    std::vector<std::uint64_t> keys_;
+    std::vector<std::uint64_t> hashes_;
+    std::vector<MappedType> values_;
+
+    static std::uint8_t tag_of(std::uint64_t h)
+    {
+        return static_cast<std::uint8_t>(h >> 57);
+    }
+
+    // The table is grown once it is 7/8 full.
+    std::size_t max_load() const
+    {
+        return num_groups_ * ControlGroup::width / 8 * 7;
+    }
+
+    // Grow the table, if needed, so that it can hold `num_entries` entries.
+    void reserve_slots(std::size_t num_entries)
+    {
+        if (num_entries <= max_load()) {
+            return;
+        }
+        std::size_t num_groups = std::max<std::size_t>(num_groups_, 1);
+        while (num_groups * ControlGroup::width / 8 * 7 < num_entries) {
+            num_groups *= 2;
+        }
+        rebuild(num_groups);
+    }
+
+    // Slot of the first byte reported in a mask from `ControlGroup`.
+    static std::size_t first_slot(std::size_t group, std::uint64_t mask)
+    {
+        return group * ControlGroup::width +
+               (countr_zero64(mask) >> ControlGroup::shift);
+    }
+
+    bool keys_equal(const std::uint64_t *a, const std::uint64_t *b) const
+    {
+        return std::equal(a, a + words_per_key_, b);
+    }
+
+    std::size_t find_hashed(const std::uint64_t *key, std::uint64_t h) const
+    {
+        if (num_groups_ == 0) {
+            return npos;
+        }
+        const auto tag = tag_of(h);
+        for (auto group = h & group_mask_;; group = (group + 1) & group_mask_) {
+            const ControlGroup g(control_.data() + group * ControlGroup::width);
+            for (auto mask = g.match(tag); mask != 0; mask &= mask - 1) {
+                const auto slot = first_slot(group, mask);
+                const auto index = slots_[slot];
+                if (hashes_[index] == h && keys_equal(this->key(index), key)) {
+                    return index;
+                }
+            }
+            if (g.match_empty() != 0) {
+                return npos;
+            }
+        }
+    }
+
+    // Reallocate the control bytes and slots for `num_groups` groups, and
+    // reinsert every entry using its cached hash.
+    void rebuild(std::size_t num_groups)
+    {
+        num_groups_ = num_groups;
+        group_mask_ = num_groups - 1;
+        control_.assign(num_groups * ControlGroup::width, empty_control);
+        slots_.resize(num_groups * ControlGroup::width);
+        for (std::size_t index = 0; index < hashes_.size(); ++index) {
+            const auto h = hashes_[index];
+            for (auto group = h & group_mask_;; group = (group + 1) & group_mask_) {
+                const auto empty =
+                    ControlGroup(control_.data() + group * ControlGroup::width)
+                        .match_empty();
+                if (empty != 0) {
+                    const auto slot = first_slot(group, empty);
+                    control_[slot] = tag_of(h);
+                    slots_[slot] = index;
+                    break;
+                }
+            }
+        }
+    }
+};
+
+} // namespace internal
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // QISKIT_ADDON_SQD_INTERNAL_FLAT_HASH_MAP_HPP_
@@ -0,0 +1,219 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_INTERNAL_INLINE_VECTOR_HPP_
+#define QISKIT_ADDON_SQD_INTERNAL_INLINE_VECTOR_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+namespace internal
+{
+
+/// Vector of at most `Capacity` elements, stored inline, so that it never
+/// allocates.
+///
+/// It supports the subset of the `std::vector` interface used by the samplers
+/// in `sample-without-replacement.hpp`.  Exceeding the capacity is a logic
+/// error, checked only by assertions.  Storage beyond `size()` is left
+/// uninitialized, and elements are never destroyed, so `T` must be trivially
+/// destructible.
+template <typename T, std::size_t Capacity>
+class InlineVector
+{
+    static_assert(
+        std::is_trivially_destructible_v<T>, "T must be trivially destructible"
+    );
+
+  private:
+    alignas(T) unsigned char storage_[Capacity * sizeof(T)];
+    std::size_t size_ = 0;
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    InlineVector() noexcept {}
+
+    InlineVector(std::size_t count, const T &value)
+    {
+        assign(count, value);
+    }
+
+    template <typename InputIterator>
+    InlineVector(InputIterator first, InputIterator last)
+    {
+        assign(first, last);
+    }
+
+    // Copy only the elements in use
+    InlineVector(const InlineVector &other)
+    {
+        assign(other.begin(), other.end());
+    }
+
+    InlineVector &operator=(const InlineVector &other)
+    {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    static constexpr std::size_t capacity() noexcept
+    {
+        return Capacity;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    T *data() noexcept
+    {
+        return std::launder(reinterpret_cast<T *>(storage_));
+    }
+
+    const T *data() const noexcept
+    {
+        return std::launder(reinterpret_cast<const T *>(storage_));
+    }
+
+    iterator begin() noexcept
+    {
+        return data();
+    }
+
+    iterator end() noexcept
+    {
+        return data() + size_;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return data();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return data() + size_;
+    }
+
+    T &operator[](std::size_t i)
+    {
+        assert(i < size_);
+        return data()[i];
+    }
+
+    const T &operator[](std::size_t i) const
+    {
+        assert(i < size_);
+        return data()[i];
+    }
+
+    T &back()
+    {
+        assert(size_ != 0);
+        return data()[size_ - 1];
+    }
+
+    const T &back() const
+    {
+        assert(size_ != 0);
+        return data()[size_ - 1];
+    }
+
+    void reserve([[maybe_unused]] std::size_t count) const
+    {
+        assert(count <= Capacity);
+    }
+
+    void clear() noexcept
+    {
+        size_ = 0;
+    }
+
+    void resize(std::size_t count, const T &value = T())
+    {
+        assert(count <= Capacity);
+        for (auto i = size_; i < count; ++i) {
+            ::new (static_cast<void *>(storage_ + i * sizeof(T))) T(value);
+        }
+        size_ = count;
+    }
+
+    void assign(std::size_t count, const T &value)
+    {
+        size_ = 0;
+        resize(count, value);
+    }
+
+    template <typename InputIterator>
+    void assign(InputIterator first, InputIterator last)
+    {
+        size_ = 0;
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    void push_back(const T &value)
+    {
+        emplace_back(value);
+    }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        assert(size_ < Capacity);
+        auto *element = ::new (static_cast<void *>(storage_ + size_ * sizeof(T)))
+            T(std::forward<Args>(args)...);
+        ++size_;
+        return *element;
+    }
+
+    void pop_back()
+    {
+        assert(size_ != 0);
+        --size_;
+    }
+};
+
+} // namespace internal
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // QISKIT_ADDON_SQD_INTERNAL_INLINE_VECTOR_HPP_
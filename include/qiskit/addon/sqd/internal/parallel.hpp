@@ -0,0 +1,176 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_INTERNAL_PARALLEL_HPP_
+#define QISKIT_ADDON_SQD_INTERNAL_PARALLEL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+#include <exception>
+#include <mutex>
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
+
+#include "qiskit/addon/sqd/internal/concepts.hpp"
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+/// Options for the multithreaded overloads of the routines in this library.
+///
+/// The input is divided into shards of `shard_size` elements, and each shard
+/// draws from its own random number stream, derived from `seed` and the index
+/// of the shard.  The results therefore depend on `seed` and `shard_size`, but
+/// not on `num_threads`.  With `Philox4x64` or `Xoshiro256StarStar` as the
+/// generator, the index of the shard is its `stream_id`.
+struct ParallelOptions {
+    /// Seed from which the random number stream of each shard is derived.
+    std::uint64_t seed = 0;
+    /// Number of worker threads.  If zero, `std::thread::hardware_concurrency()`
+    /// is used.
+    unsigned int num_threads = 0;
+    /// Number of elements per shard.  Must be nonzero.
+    std::size_t shard_size = 4096;
+};
+
+namespace internal
+{
+
+/// One step of the SplitMix64 generator, used for deriving seeds.
+constexpr std::uint64_t splitmix64(std::uint64_t &state)
+{
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/// Derive the seed of stream number `stream_id` from a single `seed`.
+constexpr std::uint64_t derive_stream_seed(std::uint64_t seed, std::uint64_t stream_id)
+{
+    std::uint64_t state = seed;
+    std::uint64_t mixed = splitmix64(state) ^ stream_id;
+    return splitmix64(mixed);
+}
+
+/// Construct the random number generator for stream number `stream_id`.
+///
+/// Generators which are constructible from `(seed, stream_id)`, such as
+/// `Philox4x64` and `Xoshiro256StarStar`, are constructed so, and split their
+/// streams themselves.  Any other generator is constructed from a single seed
+/// derived from both.
+template <QKA_SQD_CONCEPT_RNG_(RNGType)>
+RNGType make_stream_rng(std::uint64_t seed, std::uint64_t stream_id)
+{
+    if constexpr (std::is_constructible_v<RNGType, std::uint64_t, std::uint64_t>) {
+        return RNGType(seed, stream_id);
+    } else {
+        return RNGType(static_cast<typename RNGType::result_type>(
+            derive_stream_seed(seed, stream_id)
+        ));
+    }
+}
+
+/// Resolve the number of worker threads to use for `num_tasks` tasks.
+inline unsigned int resolve_num_threads(unsigned int num_threads, std::size_t num_tasks)
+{
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return static_cast<unsigned int>(
+        std::min<std::size_t>(num_threads, std::max<std::size_t>(num_tasks, 1))
+    );
+}
+
+/// Call `func(task_index, thread_index)` for each task in `[0, num_tasks)`,
+/// distributing the tasks dynamically over `num_threads` threads.
+///
+/// `num_threads` must already be resolved (see `resolve_num_threads`).  Tasks
+/// are run inline on the calling thread if `num_threads` is 1.  If any task
+/// throws, the remaining tasks are abandoned and the first exception is
+/// rethrown on the calling thread.
+template <typename FunctionType>
+void parallel_for(std::size_t num_tasks, unsigned int num_threads, FunctionType &&func)
+{
+    if (num_threads <= 1) {
+        for (std::size_t task = 0; task < num_tasks; ++task) {
+            func(task, 0u);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next_task{0};
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+    std::exception_ptr first_exception;
+    std::mutex exception_mutex;
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
+
+    auto worker = [&](unsigned int thread_index) {
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+        try {
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
+            for (;;) {
+                const auto task = next_task.fetch_add(1);
+                if (task >= num_tasks) {
+                    break;
+                }
+                func(task, thread_index);
+            }
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+        } catch (...) {
+            next_task = num_tasks;
+            std::lock_guard<std::mutex> lock(exception_mutex);
+            if (!first_exception) {
+                first_exception = std::current_exception();
+            }
+        }
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (unsigned int t = 1; t < num_threads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0u);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+    if (first_exception) {
+        std::rethrow_exception(first_exception);
+    }
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
+}
+
+} // namespace internal
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // QISKIT_ADDON_SQD_INTERNAL_PARALLEL_HPP_
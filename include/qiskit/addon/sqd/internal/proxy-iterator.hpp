@@ -0,0 +1,156 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_INTERNAL_PROXY_ITERATOR_HPP_
+#define QISKIT_ADDON_SQD_INTERNAL_PROXY_ITERATOR_HPP_
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+namespace internal
+{
+
+/// Random-access iterator over a container whose elements are accessed through
+/// proxy references, such as `PackedBitstringVector`.
+///
+/// It holds a pointer to the container and an index, and dereferences to
+/// `VectorType::reference`, or `VectorType::const_reference` if `IsConst`.
+template <typename VectorType, bool IsConst>
+class ProxyIterator
+{
+  private:
+    using VectorPointer = std::conditional_t<IsConst, const VectorType *, VectorType *>;
+    VectorPointer vec_ = nullptr;
+    std::ptrdiff_t pos_ = 0;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename VectorType::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<
+        IsConst, typename VectorType::const_reference, typename VectorType::reference>;
+    using pointer = void;
+
+    ProxyIterator() = default;
+    ProxyIterator(VectorPointer vec, std::ptrdiff_t pos) : vec_(vec), pos_(pos)
+    {
+    }
+    template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+    ProxyIterator(const ProxyIterator<VectorType, OtherConst> &other)
+      : vec_(other.vec_), pos_(other.pos_)
+    {
+    }
+
+    reference operator*() const
+    {
+        return (*vec_)[static_cast<std::size_t>(pos_)];
+    }
+    reference operator[](difference_type n) const
+    {
+        return (*vec_)[static_cast<std::size_t>(pos_ + n)];
+    }
+    ProxyIterator &operator++()
+    {
+        ++pos_;
+        return *this;
+    }
+    ProxyIterator operator++(int)
+    {
+        auto retval = *this;
+        ++pos_;
+        return retval;
+    }
+    ProxyIterator &operator--()
+    {
+        --pos_;
+        return *this;
+    }
+    ProxyIterator operator--(int)
+    {
+        auto retval = *this;
+        --pos_;
+        return retval;
+    }
+    ProxyIterator &operator+=(difference_type n)
+    {
+        pos_ += n;
+        return *this;
+    }
+    ProxyIterator &operator-=(difference_type n)
+    {
+        pos_ -= n;
+        return *this;
+    }
+    friend ProxyIterator operator+(ProxyIterator it, difference_type n)
+    {
+        return it += n;
+    }
+    friend ProxyIterator operator+(difference_type n, ProxyIterator it)
+    {
+        return it += n;
+    }
+    friend ProxyIterator operator-(ProxyIterator it, difference_type n)
+    {
+        return it -= n;
+    }
+    friend difference_type
+    operator-(const ProxyIterator &a, const ProxyIterator &b)
+    {
+        return a.pos_ - b.pos_;
+    }
+    friend bool operator==(const ProxyIterator &a, const ProxyIterator &b)
+    {
+        return a.pos_ == b.pos_;
+    }
+    friend bool operator!=(const ProxyIterator &a, const ProxyIterator &b)
+    {
+        return a.pos_ != b.pos_;
+    }
+    friend bool operator<(const ProxyIterator &a, const ProxyIterator &b)
+    {
+        return a.pos_ < b.pos_;
+    }
+    friend bool operator>(const ProxyIterator &a, const ProxyIterator &b)
+    {
+        return a.pos_ > b.pos_;
+    }
+    friend bool operator<=(const ProxyIterator &a, const ProxyIterator &b)
+    {
+        return a.pos_ <= b.pos_;
+    }
+    friend bool operator>=(const ProxyIterator &a, const ProxyIterator &b)
+    {
+        return a.pos_ >= b.pos_;
+    }
+
+    friend class ProxyIterator<VectorType, !IsConst>;
+};
+
+} // namespace internal
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // QISKIT_ADDON_SQD_INTERNAL_PROXY_ITERATOR_HPP_
@@ -0,0 +1,105 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_INTERNAL_RADIX_SORT_HPP_
+#define QISKIT_ADDON_SQD_INTERNAL_RADIX_SORT_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+namespace internal
+{
+
+/// Compute the permutation which sorts multi-word keys in ascending order.
+///
+/// Key `i` occupies words `[i * words_per_key, (i + 1) * words_per_key)` of
+/// `keys`, least significant word first.  The sort is a stable least significant
+/// digit radix sort with 8-bit digits.  Each word of the keys is gathered once
+/// into a contiguous column, which is then sorted along with the permutation,
+/// and passes in which every key has the same digit are skipped.
+///
+/// @return `order` such that `keys[order[0]] <= keys[order[1]] <= ...`, with
+///     equal keys in their original relative order.
+inline std::vector<std::size_t> radix_sort_permutation(
+    const std::uint64_t *keys, std::size_t num_keys, std::size_t words_per_key
+)
+{
+    constexpr std::size_t digit_bits = 8;
+    constexpr std::size_t num_buckets = std::size_t{1} << digit_bits;
+    constexpr std::size_t digits_per_word = 64 / digit_bits;
+
+    std::vector<std::size_t> order(num_keys), order_tmp(num_keys);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    if (num_keys <= 1) {
+        return order;
+    }
+
+    std::vector<std::uint64_t> column(num_keys), column_tmp(num_keys);
+    std::vector<std::array<std::size_t, num_buckets>> histograms(digits_per_word);
+    for (std::size_t w = 0; w < words_per_key; ++w) {
+        for (std::size_t j = 0; j < num_keys; ++j) {
+            column[j] = keys[order[j] * words_per_key + w];
+        }
+        for (auto &histogram : histograms) {
+            histogram.fill(0);
+        }
+        for (const auto word : column) {
+            for (std::size_t d = 0; d < digits_per_word; ++d) {
+                ++histograms[d][(word >> (d * digit_bits)) & (num_buckets - 1)];
+            }
+        }
+
+        for (std::size_t d = 0; d < digits_per_word; ++d) {
+            const auto shift = d * digit_bits;
+            auto &offsets = histograms[d];
+            if (offsets[(column[0] >> shift) & (num_buckets - 1)] == num_keys) {
+                continue;
+            }
+            std::size_t total = 0;
+            for (auto &offset : offsets) {
+                total += std::exchange(offset, total);
+            }
+            for (std::size_t j = 0; j < num_keys; ++j) {
+                const auto pos = offsets[(column[j] >> shift) & (num_buckets - 1)]++;
+                column_tmp[pos] = column[j];
+                order_tmp[pos] = order[j];
+            }
+            column.swap(column_tmp);
+            order.swap(order_tmp);
+        }
+    }
+    return order;
+}
+
+} // namespace internal
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // QISKIT_ADDON_SQD_INTERNAL_RADIX_SORT_HPP_
@@ -13,12 +13,16 @@
 #ifndef QISKIT_ADDON_SQD_INTERNAL_SAMPLE_WITHOUT_REPLACEMENT_HPP_
 #define QISKIT_ADDON_SQD_INTERNAL_SAMPLE_WITHOUT_REPLACEMENT_HPP_
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
-#include <random>
+#include <utility>
 #include <vector>
 
 #include "qiskit/addon/sqd/internal/concepts.hpp"
 #include "qiskit/addon/sqd/internal/exception-macros.hpp"
+#include "qiskit/addon/sqd/internal/inline-vector.hpp"
+#include "qiskit/addon/sqd/random.hpp"
 
 namespace Qiskit
 {
@@ -29,53 +33,128 @@ namespace addon
 namespace sqd
 {
 
+/// Algorithm to use for weighted sampling without replacement.
+enum class SamplingMethod {
+    /// Draw from a table of cumulative weights, by a branchless binary search,
+    /// rebuilding it whenever previously drawn indices are hit repeatedly.
+    /// Efficient when only a small fraction of the population is drawn.
+    rejection,
+    /// Maintain the weights in a Fenwick tree, which costs O(log N) per draw
+    /// regardless of how much of the population has already been drawn.
+    fenwick_tree,
+    /// Assign each index a random key, as described by Efraimidis and Spirakis,
+    /// and draw indices in order of decreasing key.  Costs O(N) on the first draw
+    /// and O(log N) per draw thereafter.  Efficient when a large fraction of the
+    /// population is drawn.
+    exponential_keys,
+};
+
 namespace internal
 {
 
-/// Utility class for sampling without replacement.
+/// Storage policy which keeps the working arrays of a sampler on the heap, for
+/// any number of weights.
+struct HeapStorage {
+    template <typename T>
+    using vector = std::vector<T>;
+};
+
+/// Storage policy which keeps the working arrays of a sampler inline, for at
+/// most `MaxWeights` weights, so that constructing and using the sampler never
+/// allocates.
+template <std::size_t MaxWeights>
+struct InlineStorage {
+    // One extra element for the root of a Fenwick tree
+    template <typename T>
+    using vector = InlineVector<T, MaxWeights + 1>;
+};
+
+/// Largest number of weights for which `visit_sampler` uses `InlineStorage`.
+/// This covers every spin sector of up to 128 orbitals.
+inline constexpr std::size_t max_inline_sampler_weights = 128;
+
 template <typename WeightVectorType>
+std::size_t _validate_weights(const WeightVectorType &weights)
+{
+    std::size_t nonzero_weights = 0;
+    for (auto weight : weights) {
+        // Check for any invalid argument
+        if (std::isnan(weight)) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_("NaN found in weight array");
+        }
+        if (std::isinf(weight)) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_("Infinite value found in weight array");
+        }
+        if (weight < 0) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_("Negative value found in weight array");
+        }
+
+        // Tally all nonzero weights
+        if (weight > 0) {
+            ++nonzero_weights;
+        }
+    }
+    return nonzero_weights;
+}
+
+/// Utility class for sampling without replacement.
+///
+/// @tparam Storage `HeapStorage` or `InlineStorage`, which determines where the
+///     working arrays are kept.
+template <typename WeightVectorType, typename Storage = HeapStorage>
 class NoReplacementSampler
 {
   private:
     // Sample from the indices corresponding to the `weights`, without
     // replacement.  In order to do so, we will make a copy of the weights
     // vector.  Each time a sample is drawn, we change the corresponding weight
-    // to zero.  However, we continue to use the same
-    // std::discrete_distribution in order to avoid paying the O(N) cost
-    // required to create the std::discrete_distribution for each sample.
-    // However, any time we *do* draw indices that have been drawn before
-    // on `num_retries` consecutive tries, we re-create the distribution, under
-    // the assumption that it has grown too dense with indices that have
-    // been sampled already.
+    // to zero.  However, we continue to use the same table of cumulative
+    // weights in order to avoid paying the O(N) cost required to build the
+    // table for each sample.  However, any time we *do* draw indices that have
+    // been drawn before on `num_retries` consecutive tries, we rebuild the
+    // table, under the assumption that it has grown too dense with indices
+    // that have been sampled already.
+    //
+    // To support `reset()`, we remember each drawn index along with its
+    // weight, as well as the initial table if it was ever rebuilt.
+    using WeightType = typename WeightVectorType::value_type;
+    template <typename T>
+    using Vector = typename Storage::template vector<T>;
     static constexpr int num_retries = 2;
-    std::vector<typename WeightVectorType::value_type> working_weights;
-    std::discrete_distribution<> dist;
+    Vector<WeightType> working_weights;
+    Vector<double> cumulative;
+    Vector<double> initial_cumulative;
+    bool rebuilt = false;
+    Vector<std::pair<std::size_t, WeightType>> drawn;
+    std::size_t nonzero_weights;
     std::size_t remaining_nonzero_weights;
 
+    void build_cumulative()
+    {
+        cumulative.resize(working_weights.size());
+        double total = 0.0;
+        for (std::size_t i = 0; i < working_weights.size(); ++i) {
+            total += working_weights[i];
+            cumulative[i] = total;
+        }
+    }
+
+    // Draw an index with probability proportional to its weight in the table,
+    // or return the number of weights if rounding overshoots the last one.
+    template <QKA_SQD_CONCEPT_RNG_(RNGType)>
+    std::size_t draw_from_table(RNGType &rng) const
+    {
+        return draw_categorical(cumulative.data(), cumulative.size(), rng);
+    }
+
   public:
     /// Constructor
     explicit NoReplacementSampler(const WeightVectorType &weights)
-      : working_weights(weights), dist(working_weights.begin(), working_weights.end())
+      : working_weights(weights.begin(), weights.end()),
+        nonzero_weights(_validate_weights(weights)),
+        remaining_nonzero_weights(nonzero_weights)
     {
-        std::size_t nonzero_weights = 0;
-        for (auto weight : weights) {
-            // Check for any invalid argument
-            if (std::isnan(weight)) {
-                QKA_SQD_THROW_INVALID_ARGUMENT_("NaN found in weight array");
-            }
-            if (std::isinf(weight)) {
-                QKA_SQD_THROW_INVALID_ARGUMENT_("Infinite value found in weight array");
-            }
-            if (weight < 0) {
-                QKA_SQD_THROW_INVALID_ARGUMENT_("Negative value found in weight array");
-            }
-
-            // Tally all nonzero weights
-            if (weight > 0) {
-                ++nonzero_weights;
-            }
-        }
-        remaining_nonzero_weights = nonzero_weights;
+        build_cumulative();
     }
 
     // Delete copy constructor and assignment operator
@@ -104,10 +183,11 @@ class NoReplacementSampler
             // Draw up to `num_retries` samples to find one with nonzero
             // `working_weight`
             do {
-                const auto idx = dist(rng);
-                if (working_weights[idx] != 0) {
+                const auto idx = draw_from_table(rng);
+                if (idx < working_weights.size() && working_weights[idx] != 0) {
                     // We found a sample that has not been sampled yet.  Select it, and
                     // mark it as ineligible for selection again.
+                    drawn.emplace_back(idx, working_weights[idx]);
                     working_weights[idx] = 0;
                     return idx;
                 }
@@ -115,13 +195,285 @@ class NoReplacementSampler
             } while (remaining_retries != 0);
 
             // We performed the loop `num_retries` times, but obtained only
-            // samples that we had drawn previously.  So we reconstruct the
-            // distribution in order to draw more samples without replacement.
-            dist.param({working_weights.begin(), working_weights.end()});
+            // samples that we had drawn previously.  So we rebuild the table in
+            // order to draw more samples without replacement.
+            if (!rebuilt) {
+                initial_cumulative = cumulative;
+                rebuilt = true;
+            }
+            build_cumulative();
+        }
+    }
+
+    /// Return every drawn sample to the population
+    void reset()
+    {
+        for (const auto &[idx, weight] : drawn) {
+            working_weights[idx] = weight;
+        }
+        drawn.clear();
+        if (rebuilt) {
+            cumulative = initial_cumulative;
+            rebuilt = false;
+        }
+        remaining_nonzero_weights = nonzero_weights;
+    }
+};
+
+/// Utility class for sampling without replacement, backed by a Fenwick tree.
+///
+/// @tparam Storage `HeapStorage` or `InlineStorage`, which determines where the
+///     working arrays are kept.
+template <typename WeightVectorType, typename Storage = HeapStorage>
+class FenwickTreeSampler
+{
+  private:
+    // The tree holds partial sums of `working_weights`, so a sample can be
+    // drawn by descending the tree, and a drawn index can be removed from the
+    // population by a point update.  Both operations are O(log N).  Because
+    // the point updates subtract from partial sums, rounding can leave small
+    // residues in the tree; if a descent ever lands on an index that was
+    // already drawn, the tree is rebuilt from `working_weights`.
+    template <typename T>
+    using Vector = typename Storage::template vector<T>;
+    Vector<double> working_weights;
+    Vector<double> tree;
+    Vector<std::pair<std::size_t, double>> drawn;
+    std::size_t top_step = 0;
+    std::size_t nonzero_weights;
+    std::size_t remaining_nonzero_weights;
+
+    void add_to_tree(std::size_t idx, double delta)
+    {
+        for (auto i = idx + 1; i < tree.size(); i += (i & (~i + 1))) {
+            tree[i] += delta;
+        }
+    }
+
+    void build_tree()
+    {
+        const auto n = working_weights.size();
+        tree.assign(n + 1, 0.0);
+        for (std::size_t i = 1; i <= n; ++i) {
+            tree[i] += working_weights[i - 1];
+            const auto parent = i + (i & (~i + 1));
+            if (parent <= n) {
+                tree[parent] += tree[i];
+            }
+        }
+    }
+
+    double total_weight() const
+    {
+        double total = 0.0;
+        for (auto i = working_weights.size(); i > 0; i -= (i & (~i + 1))) {
+            total += tree[i];
+        }
+        return total;
+    }
+
+  public:
+    /// Constructor
+    explicit FenwickTreeSampler(const WeightVectorType &weights)
+      : working_weights(weights.begin(), weights.end()),
+        nonzero_weights(_validate_weights(weights)),
+        remaining_nonzero_weights(nonzero_weights)
+    {
+        build_tree();
+        if (!working_weights.empty()) {
+            top_step = 1;
+            while (top_step * 2 <= working_weights.size()) {
+                top_step *= 2;
+            }
+        }
+    }
+
+    // Delete copy constructor and assignment operator
+    FenwickTreeSampler(const FenwickTreeSampler &) = delete;
+    FenwickTreeSampler &operator=(const FenwickTreeSampler &) = delete;
+
+    /// Return the number of remaining samples that can be drawn
+    std::size_t get_remaining_nonzero_weights() const
+    {
+        return remaining_nonzero_weights;
+    }
+
+    /// Sample a single value
+    template <QKA_SQD_CONCEPT_RNG_(RNGType)>
+    std::size_t operator()(RNGType &rng)
+    {
+        if (remaining_nonzero_weights == 0) {
+            QKA_SQD_THROW_RUNTIME_ERROR_(
+                "Cannot draw more samples than number of nonzero weights."
+            );
+        }
+        --remaining_nonzero_weights;
+
+        const auto n = working_weights.size();
+        for (;;) {
+            const auto total = total_weight();
+            if (!(total > 0)) {
+                build_tree();
+                continue;
+            }
+            // Find the smallest index whose prefix sum exceeds the target
+            double target = uniform_double(rng) * total;
+            std::size_t pos = 0;
+            for (auto step = top_step; step != 0; step >>= 1) {
+                if (pos + step <= n && tree[pos + step] <= target) {
+                    pos += step;
+                    target -= tree[pos];
+                }
+            }
+            if (pos < n && working_weights[pos] != 0) {
+                // Remove the drawn index from the population
+                const auto weight = working_weights[pos];
+                drawn.emplace_back(pos, weight);
+                working_weights[pos] = 0;
+                add_to_tree(pos, -weight);
+                return pos;
+            }
+            // Rounding residue led us astray; start again from exact sums.
+            build_tree();
+        }
+    }
+
+    /// Return every drawn sample to the population
+    void reset()
+    {
+        for (const auto &[idx, weight] : drawn) {
+            working_weights[idx] = weight;
+            add_to_tree(idx, weight);
+        }
+        drawn.clear();
+        remaining_nonzero_weights = nonzero_weights;
+    }
+};
+
+/// Utility class for sampling without replacement, using the exponential keys
+/// of Efraimidis and Spirakis.
+///
+/// @tparam Storage `HeapStorage` or `InlineStorage`, which determines where the
+///     heap of keys is kept.
+template <typename WeightVectorType, typename Storage = HeapStorage>
+class ExponentialKeySampler
+{
+  private:
+    // Each index with nonzero weight w receives the key log(u) / w, where u is
+    // uniform on (0, 1).  Drawing indices in order of decreasing key is
+    // equivalent to drawing them one by one with probability proportional to
+    // their weights.  The keys are generated upon the first draw, and kept in
+    // a max-heap thereafter.
+    const WeightVectorType &weights;
+    typename Storage::template vector<std::pair<double, std::size_t>> heap;
+    bool keys_generated = false;
+    std::size_t nonzero_weights;
+    std::size_t remaining_nonzero_weights;
+
+  public:
+    /// Constructor
+    ///
+    /// The `weights` must outlive the sampler.
+    explicit ExponentialKeySampler(const WeightVectorType &weights)
+      : weights(weights), nonzero_weights(_validate_weights(weights)),
+        remaining_nonzero_weights(nonzero_weights)
+    {
+    }
+
+    // Delete copy constructor and assignment operator
+    ExponentialKeySampler(const ExponentialKeySampler &) = delete;
+    ExponentialKeySampler &operator=(const ExponentialKeySampler &) = delete;
+
+    /// Return the number of remaining samples that can be drawn
+    std::size_t get_remaining_nonzero_weights() const
+    {
+        return remaining_nonzero_weights;
+    }
+
+    /// Sample a single value
+    template <QKA_SQD_CONCEPT_RNG_(RNGType)>
+    std::size_t operator()(RNGType &rng)
+    {
+        if (remaining_nonzero_weights == 0) {
+            QKA_SQD_THROW_RUNTIME_ERROR_(
+                "Cannot draw more samples than number of nonzero weights."
+            );
+        }
+        --remaining_nonzero_weights;
+
+        if (!keys_generated) {
+            heap.reserve(remaining_nonzero_weights + 1);
+            for (std::size_t i = 0; i < weights.size(); ++i) {
+                if (weights[i] > 0) {
+                    // 1 - u is in (0, 1], so the logarithm is finite
+                    const double u = uniform_double(rng);
+                    heap.emplace_back(std::log(1.0 - u) / weights[i], i);
+                }
+            }
+            std::make_heap(heap.begin(), heap.end());
+            keys_generated = true;
         }
+
+        std::pop_heap(heap.begin(), heap.end());
+        const auto idx = heap.back().second;
+        heap.pop_back();
+        return idx;
+    }
+
+    /// Return every drawn sample to the population
+    void reset()
+    {
+        heap.clear();
+        keys_generated = false;
+        remaining_nonzero_weights = nonzero_weights;
     }
 };
 
+/// Construct a sampler of the type corresponding to `method`, with the given
+/// `Storage`, and pass it to `func`.
+template <typename Storage, typename WeightVectorType, typename FunctionType>
+decltype(auto) visit_sampler_with_storage(
+    SamplingMethod method, const WeightVectorType &weights, FunctionType &&func
+)
+{
+    switch (method) {
+    case SamplingMethod::fenwick_tree: {
+        FenwickTreeSampler<WeightVectorType, Storage> sampler(weights);
+        return func(sampler);
+    }
+    case SamplingMethod::exponential_keys: {
+        ExponentialKeySampler<WeightVectorType, Storage> sampler(weights);
+        return func(sampler);
+    }
+    case SamplingMethod::rejection:
+    default: {
+        NoReplacementSampler<WeightVectorType, Storage> sampler(weights);
+        return func(sampler);
+    }
+    }
+}
+
+/// Construct a sampler of the type corresponding to `method`, and pass it to
+/// `func`.
+///
+/// The sampler keeps its working arrays on the stack if there are at most
+/// `max_inline_sampler_weights` weights, and on the heap otherwise.  Either
+/// way, it draws the same indices.
+template <typename WeightVectorType, typename FunctionType>
+decltype(auto) visit_sampler(
+    SamplingMethod method, const WeightVectorType &weights, FunctionType &&func
+)
+{
+    if (weights.size() <= max_inline_sampler_weights) {
+        return visit_sampler_with_storage<InlineStorage<max_inline_sampler_weights>>(
+            method, weights, std::forward<FunctionType>(func)
+        );
+    }
+    return visit_sampler_with_storage<HeapStorage>(
+        method, weights, std::forward<FunctionType>(func)
+    );
+}
+
 } // namespace internal
 
 } // namespace sqd
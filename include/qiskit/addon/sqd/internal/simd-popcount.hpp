@@ -0,0 +1,412 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_INTERNAL_SIMD_POPCOUNT_HPP_
+#define QISKIT_ADDON_SQD_INTERNAL_SIMD_POPCOUNT_HPP_
+
+/// Vectorized population counts over arrays of 64-bit words.
+///
+/// The instruction set is chosen at compile time: AVX-512 VPOPCNTDQ, AVX2 or
+/// NEON when the compiler targets it (e.g. with `-march=native`), and portable
+/// scalar code otherwise.  Define `QKA_SQD_DISABLE_SIMD` to 1 to always use
+/// the scalar code.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "qiskit/addon/sqd/internal/bitset_common.hpp"
+
+#if !QKA_SQD_DISABLE_SIMD
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+#define QKA_SQD_SIMD_AVX512_ 1
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define QKA_SQD_SIMD_AVX2_ 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define QKA_SQD_SIMD_NEON_ 1
+#include <arm_neon.h>
+#endif
+#endif // !QKA_SQD_DISABLE_SIMD
+
+#if QKA_SQD_SIMD_AVX512_ || QKA_SQD_SIMD_AVX2_ || QKA_SQD_SIMD_NEON_
+#define QKA_SQD_SIMD_ 1
+#endif
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+namespace internal
+{
+
+// Each `SimdOps` provides, for one instruction set, the operations on vectors of
+// 64-bit lanes that the kernels below are written in terms of.  `swap_adjacent`
+// and `swap_pairs` exchange neighboring lanes and neighboring pairs of lanes, and
+// `equal` returns a bitmask with bit `i` set if lane `i` of both operands agree.
+
+#if QKA_SQD_SIMD_AVX512_
+struct SimdOps {
+    using vector = __m512i;
+    static constexpr std::size_t lanes = 8;
+
+    static vector load(const std::uint64_t *p)
+    {
+        return _mm512_loadu_si512(p);
+    }
+    static void store(std::uint64_t *p, vector v)
+    {
+        _mm512_storeu_si512(p, v);
+    }
+    static vector broadcast(std::uint64_t x)
+    {
+        return _mm512_set1_epi64(static_cast<long long>(x));
+    }
+    static vector bitwise_and(vector a, vector b)
+    {
+        return _mm512_and_si512(a, b);
+    }
+    static vector add(vector a, vector b)
+    {
+        return _mm512_add_epi64(a, b);
+    }
+    static vector popcount(vector v)
+    {
+        return _mm512_popcnt_epi64(v);
+    }
+    static vector pack_counts(vector low, vector high)
+    {
+        return _mm512_or_si512(low, _mm512_slli_epi64(high, 32));
+    }
+    static vector swap_adjacent(vector v)
+    {
+        return _mm512_permutex_epi64(v, 0xb1);
+    }
+    static vector swap_pairs(vector v)
+    {
+        return _mm512_permutex_epi64(v, 0x4e);
+    }
+    static std::uint64_t equal(vector a, vector b)
+    {
+        return _mm512_cmpeq_epi64_mask(a, b);
+    }
+};
+#elif QKA_SQD_SIMD_AVX2_
+struct SimdOps {
+    using vector = __m256i;
+    static constexpr std::size_t lanes = 4;
+
+    static vector load(const std::uint64_t *p)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    }
+    static void store(std::uint64_t *p, vector v)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+    }
+    static vector broadcast(std::uint64_t x)
+    {
+        return _mm256_set1_epi64x(static_cast<long long>(x));
+    }
+    static vector bitwise_and(vector a, vector b)
+    {
+        return _mm256_and_si256(a, b);
+    }
+    static vector add(vector a, vector b)
+    {
+        return _mm256_add_epi64(a, b);
+    }
+    // Per-lane population count, using a nibble lookup table.
+    static vector popcount(vector v)
+    {
+        const __m256i lookup = _mm256_setr_epi8(
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1,
+            2, 2, 3, 2, 3, 3, 4
+        );
+        const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+        const __m256i lo = _mm256_and_si256(v, low_nibbles);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles);
+        const __m256i counts = _mm256_add_epi8(
+            _mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi)
+        );
+        return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+    }
+    static vector pack_counts(vector low, vector high)
+    {
+        return _mm256_or_si256(low, _mm256_slli_epi64(high, 32));
+    }
+    static vector swap_adjacent(vector v)
+    {
+        return _mm256_shuffle_epi32(v, 0x4e);
+    }
+    static vector swap_pairs(vector v)
+    {
+        return _mm256_permute4x64_epi64(v, 0x4e);
+    }
+    static std::uint64_t equal(vector a, vector b)
+    {
+        return static_cast<std::uint64_t>(
+            _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)))
+        );
+    }
+};
+#elif QKA_SQD_SIMD_NEON_
+struct SimdOps {
+    using vector = uint64x2_t;
+    static constexpr std::size_t lanes = 2;
+
+    static vector load(const std::uint64_t *p)
+    {
+        return vld1q_u64(p);
+    }
+    static void store(std::uint64_t *p, vector v)
+    {
+        vst1q_u64(p, v);
+    }
+    static vector broadcast(std::uint64_t x)
+    {
+        return vdupq_n_u64(x);
+    }
+    static vector bitwise_and(vector a, vector b)
+    {
+        return vandq_u64(a, b);
+    }
+    static vector add(vector a, vector b)
+    {
+        return vaddq_u64(a, b);
+    }
+    static vector popcount(vector v)
+    {
+        return vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vcntq_u8(vreinterpretq_u8_u64(v)))));
+    }
+    static vector pack_counts(vector low, vector high)
+    {
+        return vorrq_u64(low, vshlq_n_u64(high, 32));
+    }
+    static vector swap_adjacent(vector v)
+    {
+        return vextq_u64(v, v, 1);
+    }
+    static vector swap_pairs(vector v)
+    {
+        return v;
+    }
+    static std::uint64_t equal(vector a, vector b)
+    {
+        const uint64x2_t eq = vceqq_u64(a, b);
+        return (vgetq_lane_u64(eq, 0) & 1) | ((vgetq_lane_u64(eq, 1) & 1) << 1);
+    }
+};
+#endif
+
+/// For each `i` in `[0, count)`, store the population counts of
+/// `words[i] & right_masks[i]` and `words[i] & left_masks[i]` in the low and
+/// high 32 bits of `packed_counts[i]`, respectively.
+inline void masked_popcount_pairs(
+    const std::uint64_t *words, const std::uint64_t *right_masks,
+    const std::uint64_t *left_masks, std::size_t count, std::uint64_t *packed_counts
+)
+{
+    std::size_t i = 0;
+#if QKA_SQD_SIMD_
+    for (; i + SimdOps::lanes <= count; i += SimdOps::lanes) {
+        const auto v = SimdOps::load(words + i);
+        const auto right = SimdOps::load(right_masks + i);
+        const auto left = SimdOps::load(left_masks + i);
+        SimdOps::store(
+            packed_counts + i,
+            SimdOps::pack_counts(
+                SimdOps::popcount(SimdOps::bitwise_and(v, right)),
+                SimdOps::popcount(SimdOps::bitwise_and(v, left))
+            )
+        );
+    }
+#endif // QKA_SQD_SIMD_
+    for (; i < count; ++i) {
+        packed_counts[i] = popcount64(words[i] & right_masks[i]) |
+                           (std::uint64_t{popcount64(words[i] & left_masks[i])} << 32);
+    }
+}
+
+// Selection loop of `select_right_left_hamming`.  `FixedWords`, if nonzero, is
+// the number of words per bitstring known at compile time, which lets the
+// per-bitstring reduction be unrolled or done within SIMD registers.
+template <std::size_t FixedWords>
+void select_right_left_hamming_blocks(
+    const std::uint64_t *words, std::size_t num_bitstrings,
+    std::size_t words_per_bitstring, std::size_t num_bits, std::uint64_t packed_target,
+    std::uint64_t *selection_bitmap
+)
+{
+    const std::size_t num_words = FixedWords != 0 ? FixedWords : words_per_bitstring;
+    const auto half_N = num_bits / 2;
+    std::size_t first_remaining = 0;
+
+#if QKA_SQD_SIMD_
+    // Bitstrings are processed in blocks of 64, each yielding one word of the
+    // bitmap, so the masks are laid out to line up with a whole block of words.
+    constexpr std::size_t block_size = 64;
+    const auto block_words = block_size * num_words;
+    std::vector<std::uint64_t> right_masks(block_words), left_masks(block_words);
+    for (std::size_t k = 0; k < num_words; ++k) {
+        const auto begin = k * 64;
+        right_masks[k] = half_N > begin ? low_bits_mask(half_N - begin) : 0;
+        left_masks[k] = ~right_masks[k];
+    }
+    for (std::size_t j = num_words; j < block_words; ++j) {
+        right_masks[j] = right_masks[j - num_words];
+        left_masks[j] = left_masks[j - num_words];
+    }
+
+    std::size_t block = 0;
+    if constexpr (
+        FixedWords != 0 && FixedWords <= 4 && SimdOps::lanes % FixedWords == 0
+    ) {
+        // Each vector holds whole bitstrings, so their per-word counts can be
+        // summed within the vector and compared to the target all at once.
+        constexpr std::size_t bitstrings_per_vector = SimdOps::lanes / FixedWords;
+        const auto right_mask = SimdOps::load(right_masks.data());
+        const auto left_mask = SimdOps::load(left_masks.data());
+        const auto target = SimdOps::broadcast(packed_target);
+        for (; (block + 1) * block_size <= num_bitstrings; ++block) {
+            const std::uint64_t *block_start = words + block * block_words;
+            std::uint64_t selection = 0;
+            for (std::size_t v = 0; v < block_words / SimdOps::lanes; ++v) {
+                const auto x = SimdOps::load(block_start + v * SimdOps::lanes);
+                auto packed = SimdOps::pack_counts(
+                    SimdOps::popcount(SimdOps::bitwise_and(x, right_mask)),
+                    SimdOps::popcount(SimdOps::bitwise_and(x, left_mask))
+                );
+                if constexpr (FixedWords >= 2) {
+                    packed = SimdOps::add(packed, SimdOps::swap_adjacent(packed));
+                }
+                if constexpr (FixedWords >= 4) {
+                    packed = SimdOps::add(packed, SimdOps::swap_pairs(packed));
+                }
+                // Keep the result from the first lane of each bitstring
+                std::uint64_t matches = SimdOps::equal(packed, target);
+                if constexpr (FixedWords == 2) {
+                    matches &= 0x55;
+                    matches = (matches | (matches >> 1)) & 0x33;
+                    matches = (matches | (matches >> 2)) & 0x0f;
+                } else if constexpr (FixedWords == 4) {
+                    matches = (matches & 0x01) | ((matches >> 3) & 0x02);
+                }
+                selection |= matches << (v * bitstrings_per_vector);
+            }
+            selection_bitmap[block] = selection;
+        }
+    }
+
+    std::vector<std::uint64_t> packed_counts(block_words);
+    for (; (block + 1) * block_size <= num_bitstrings; ++block) {
+        masked_popcount_pairs(
+            words + block * block_words, right_masks.data(), left_masks.data(),
+            block_words, packed_counts.data()
+        );
+        std::uint64_t selection = 0;
+        const std::uint64_t *counts = packed_counts.data();
+        for (std::size_t i = 0; i < block_size; ++i) {
+            std::uint64_t packed_count = 0;
+            for (std::size_t k = 0; k < num_words; ++k) {
+                packed_count += counts[k];
+            }
+            selection |= std::uint64_t{packed_count == packed_target} << i;
+            counts += num_words;
+        }
+        selection_bitmap[block] = selection;
+    }
+    first_remaining = block * block_size;
+#endif // QKA_SQD_SIMD_
+
+    // Remaining bitstrings (all of them, without SIMD) are counted one at a time
+    const auto right_target = packed_target & 0xffffffffu;
+    const auto left_target = packed_target >> 32;
+    for (auto i = first_remaining; i < num_bitstrings; ++i) {
+        const std::uint64_t *bitstring = words + i * num_words;
+        if (count_bits_in_range(bitstring, 0, half_N) == right_target &&
+            count_bits_in_range(bitstring, half_N, num_bits) == left_target) {
+            selection_bitmap[i / 64] |= std::uint64_t{1} << (i % 64);
+        }
+    }
+}
+
+/// Compute which of the bitstrings stored contiguously in `words` have
+/// `right_target` set bits in their right half and `left_target` set bits in
+/// their left half.
+///
+/// Bitstring `i` occupies words `[i * words_per_bitstring, (i + 1) *
+/// words_per_bitstring)`, and bit `i` of `selection_bitmap` (an array of
+/// `words_for_bits(num_bitstrings)` words) is set if it matches.  `num_bits`
+/// must be even, and the bits above `num_bits` in each bitstring must be zero.
+inline void select_right_left_hamming(
+    const std::uint64_t *words, std::size_t num_bitstrings,
+    std::size_t words_per_bitstring, std::size_t num_bits, std::size_t right_target,
+    std::size_t left_target, std::uint64_t *selection_bitmap
+)
+{
+    std::fill(selection_bitmap, selection_bitmap + words_for_bits(num_bitstrings), 0);
+    if (num_bitstrings == 0) {
+        return;
+    }
+    if (words_per_bitstring == 0) {
+        if (right_target == 0 && left_target == 0) {
+            for (std::size_t i = 0; i < num_bitstrings; ++i) {
+                selection_bitmap[i / 64] |= std::uint64_t{1} << (i % 64);
+            }
+        }
+        return;
+    }
+    if (right_target > 0xffffffffu || left_target > 0xffffffffu) {
+        return;
+    }
+    const std::uint64_t packed_target =
+        right_target | (std::uint64_t{left_target} << 32);
+
+    const auto select = [&](auto fixed_words) {
+        select_right_left_hamming_blocks<decltype(fixed_words)::value>(
+            words, num_bitstrings, words_per_bitstring, num_bits, packed_target,
+            selection_bitmap
+        );
+    };
+    switch (words_per_bitstring) {
+    case 1:
+        select(std::integral_constant<std::size_t, 1>());
+        break;
+    case 2:
+        select(std::integral_constant<std::size_t, 2>());
+        break;
+    case 4:
+        select(std::integral_constant<std::size_t, 4>());
+        break;
+    default:
+        select(std::integral_constant<std::size_t, 0>());
+    }
+}
+
+} // namespace internal
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // QISKIT_ADDON_SQD_INTERNAL_SIMD_POPCOUNT_HPP_
@@ -0,0 +1,545 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_NATIVE_BITSTRING_VECTOR_HPP_
+#define QISKIT_ADDON_SQD_NATIVE_BITSTRING_VECTOR_HPP_
+
+/// Bitstrings of a run-time number of bits held in unsigned integers
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "qiskit/addon/sqd/internal/bitset_common.hpp"
+#include "qiskit/addon/sqd/internal/exception-macros.hpp"
+#include "qiskit/addon/sqd/internal/proxy-iterator.hpp"
+#include "qiskit/addon/sqd/support/native_bitstrings.hpp"
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+/// A bitstring of `size()` bits held in the low bits of an unsigned integer of
+/// type `T`.
+///
+/// A bare unsigned integer used as a bitstring has exactly as many bits as its
+/// type, so its halves always split at the middle of the integer.  This type
+/// instead carries its length, so that, for example, a `std::uint64_t` can hold
+/// a bitstring of 30 orbitals per spin sector, whose right half is bits 0 to 29
+/// and whose left half is bits 30 to 59.  Its CI strings are of type
+/// `NativeBitstring<U>`, where `U` is the unsigned integer of half the width of
+/// `T`.
+template <typename T>
+class NativeBitstring
+{
+    static_assert(
+        internal::IsNativeBitstring<T>::value, "T must be an unsigned integer type"
+    );
+
+  private:
+    T bits_ = 0;
+    std::size_t num_bits_ = 0;
+
+  public:
+    /// Construct an empty bitstring
+    NativeBitstring() = default;
+
+    /// Construct a bitstring of `num_bits` bits from the low bits of `bits`.
+    ///
+    /// @throws std::invalid_argument if `num_bits` exceeds the width of `T`, or
+    ///     if a bit of `bits` at or beyond `num_bits` is set.
+    NativeBitstring(T bits, std::size_t num_bits) : bits_(bits), num_bits_(num_bits)
+    {
+        if (num_bits > internal::native_bits<T>) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Bitstring length exceeds the width of its integer type"
+            );
+        }
+        if (num_bits < internal::native_bits<T> && (bits >> num_bits) != 0) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_("Bitstring has bits set beyond its length");
+        }
+    }
+
+    /// Return the number of bits
+    std::size_t size() const
+    {
+        return num_bits_;
+    }
+
+    /// Return the integer holding the bits
+    T value() const
+    {
+        return bits_;
+    }
+
+    /// Return the value of bit `pos`
+    bool test(std::size_t pos) const
+    {
+        return ((bits_ >> pos) & 1) != 0;
+    }
+
+    /// Return the value of bit `pos`
+    bool operator[](std::size_t pos) const
+    {
+        return test(pos);
+    }
+
+    /// Return the number of set bits
+    std::size_t count() const
+    {
+        return internal::popcount_native(bits_);
+    }
+
+    /// Toggle bit `pos`
+    NativeBitstring &flip(std::size_t pos)
+    {
+        bits_ ^= static_cast<T>(T{1} << pos);
+        return *this;
+    }
+
+    /// Compare two bitstrings
+    friend bool operator==(const NativeBitstring &a, const NativeBitstring &b)
+    {
+        return a.num_bits_ == b.num_bits_ && a.bits_ == b.bits_;
+    }
+
+    /// Compare two bitstrings
+    friend bool operator!=(const NativeBitstring &a, const NativeBitstring &b)
+    {
+        return !(a == b);
+    }
+};
+
+/// Mutable reference to a single bitstring stored in a `NativeBitstringVector`.
+template <typename T>
+class NativeBitstringRef
+{
+  private:
+    T *bits_;
+    std::size_t num_bits_;
+
+  public:
+    /// Constructor
+    ///
+    /// @param[in] bits Pointer to the integer holding the bitstring, whose bits
+    ///     at or beyond `num_bits` must be zero.
+    /// @param[in] num_bits Number of bits in the bitstring.
+    NativeBitstringRef(T *bits, std::size_t num_bits) : bits_(bits), num_bits_(num_bits)
+    {
+    }
+
+    NativeBitstringRef(const NativeBitstringRef &) = default;
+
+    /// Return the number of bits
+    std::size_t size() const
+    {
+        return num_bits_;
+    }
+
+    /// Return the integer holding the bits
+    T value() const
+    {
+        return *bits_;
+    }
+
+    /// Return the value of bit `pos`
+    bool test(std::size_t pos) const
+    {
+        return ((*bits_ >> pos) & 1) != 0;
+    }
+
+    /// Return the value of bit `pos`
+    bool operator[](std::size_t pos) const
+    {
+        return test(pos);
+    }
+
+    /// Return the number of set bits
+    std::size_t count() const
+    {
+        return internal::popcount_native(*bits_);
+    }
+
+    /// Copy the referenced bitstring
+    operator NativeBitstring<T>() const
+    {
+        return {*bits_, num_bits_};
+    }
+
+    /// Overwrite the referenced bitstring with another of the same size
+    NativeBitstringRef &operator=(const NativeBitstring<T> &other)
+    {
+        if (other.size() != num_bits_) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_("Bitstring sizes do not match");
+        }
+        *bits_ = other.value();
+        return *this;
+    }
+
+    /// Overwrite the referenced bitstring with another of the same size
+    NativeBitstringRef &operator=(const NativeBitstringRef &other)
+    {
+        return *this = static_cast<NativeBitstring<T>>(other);
+    }
+
+    /// Toggle bit `pos`
+    const NativeBitstringRef &flip(std::size_t pos) const
+    {
+        *bits_ ^= static_cast<T>(T{1} << pos);
+        return *this;
+    }
+
+    /// Compare two referenced bitstrings
+    friend bool operator==(const NativeBitstringRef &a, const NativeBitstringRef &b)
+    {
+        return a.num_bits_ == b.num_bits_ && *a.bits_ == *b.bits_;
+    }
+
+    /// Compare a referenced bitstring with a `NativeBitstring`
+    friend bool operator==(const NativeBitstringRef &a, const NativeBitstring<T> &b)
+    {
+        return a.num_bits_ == b.size() && *a.bits_ == b.value();
+    }
+
+    /// Compare a referenced bitstring with a `NativeBitstring`
+    friend bool operator==(const NativeBitstring<T> &a, const NativeBitstringRef &b)
+    {
+        return b == a;
+    }
+};
+
+/// Container of bitstrings of uniform length, each held in the low bits of an
+/// unsigned integer of type `T`.
+///
+/// The bitstrings are stored as a plain array of `T`, and share a length of
+/// `num_bits()` bits, which may be less than the width of `T`.  This allows
+/// shots of, for example, 30 orbitals per spin sector to be stored as
+/// `std::uint64_t` values and processed with single-instruction population
+/// counts and shifts, with their halves split at bit 30 rather than at bit 32.
+///
+/// Elements are read as `NativeBitstring<T>` values and written through the
+/// proxy type `NativeBitstringRef`.  As with `std::vector<bool>`, `auto x = v[i]`
+/// on a non-const container yields a reference, not a copy.  A
+/// default-constructed container adopts the length of the first bitstring added
+/// to it, so it can be used as the `BitstringVectorType` of the functions in
+/// this library, which return containers of the same type as their input.
+template <typename T>
+class NativeBitstringVector
+{
+  private:
+    std::vector<T> bitstrings_;
+    std::size_t num_bits_ = 0;
+
+    void adopt_num_bits(std::size_t num_bits)
+    {
+        if (num_bits == num_bits_) {
+            return;
+        }
+        if (!bitstrings_.empty() || num_bits_ != 0) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Bitstring length does not match the length of the container"
+            );
+        }
+        num_bits_ = num_bits;
+    }
+
+  public:
+    /// Type of the bitstrings as returned by value
+    using value_type = NativeBitstring<T>;
+    using reference = NativeBitstringRef<T>;
+    using const_reference = NativeBitstring<T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator = internal::ProxyIterator<NativeBitstringVector, false>;
+    using const_iterator = internal::ProxyIterator<NativeBitstringVector, true>;
+
+    /// Construct an empty container, which adopts the length of the first
+    /// bitstring added to it.
+    NativeBitstringVector() = default;
+
+    /// Construct a container holding `count` bitstrings of `num_bits` bits each,
+    /// all of which are zero.
+    ///
+    /// @throws std::invalid_argument if `num_bits` exceeds the width of `T`.
+    explicit NativeBitstringVector(std::size_t num_bits, std::size_t count = 0)
+      : bitstrings_(count), num_bits_(num_bits)
+    {
+        if (num_bits > internal::native_bits<T>) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Bitstring length exceeds the width of its integer type"
+            );
+        }
+    }
+
+    /// Construct a container from integers each holding a bitstring of
+    /// `num_bits` bits in its low bits.
+    ///
+    /// @throws std::invalid_argument if `num_bits` exceeds the width of `T`, or
+    ///     if any integer has a bit set at or beyond `num_bits`.
+    NativeBitstringVector(std::size_t num_bits, std::vector<T> bitstrings)
+      : NativeBitstringVector(num_bits)
+    {
+        for (const auto bits : bitstrings) {
+            // Validate through the constructor of `NativeBitstring`
+            static_cast<void>(value_type(bits, num_bits));
+        }
+        bitstrings_ = std::move(bitstrings);
+    }
+
+    /// Return the number of bits in each bitstring
+    std::size_t num_bits() const
+    {
+        return num_bits_;
+    }
+
+    /// Return a pointer to the integers holding the bitstrings
+    const T *data() const
+    {
+        return bitstrings_.data();
+    }
+
+    /// Return a pointer to the integers holding the bitstrings
+    T *data()
+    {
+        return bitstrings_.data();
+    }
+
+    /// Return the number of bitstrings
+    std::size_t size() const
+    {
+        return bitstrings_.size();
+    }
+
+    /// Return `true` if the container holds no bitstrings
+    bool empty() const
+    {
+        return bitstrings_.empty();
+    }
+
+    /// Reserve storage for at least `count` bitstrings
+    void reserve(std::size_t count)
+    {
+        bitstrings_.reserve(count);
+    }
+
+    /// Remove all bitstrings, keeping the bitstring length and the storage
+    void clear()
+    {
+        bitstrings_.clear();
+    }
+
+    /// Resize to hold `count` bitstrings, zero-initializing any new ones
+    void resize(std::size_t count)
+    {
+        bitstrings_.resize(count);
+    }
+
+    /// Access bitstring `pos`
+    reference operator[](std::size_t pos)
+    {
+        return {bitstrings_.data() + pos, num_bits_};
+    }
+
+    /// Access bitstring `pos`
+    const_reference operator[](std::size_t pos) const
+    {
+        return {bitstrings_[pos], num_bits_};
+    }
+
+    /// Access the first bitstring
+    reference front()
+    {
+        return (*this)[0];
+    }
+
+    /// Access the first bitstring
+    const_reference front() const
+    {
+        return (*this)[0];
+    }
+
+    /// Access the last bitstring
+    reference back()
+    {
+        return (*this)[size() - 1];
+    }
+
+    /// Access the last bitstring
+    const_reference back() const
+    {
+        return (*this)[size() - 1];
+    }
+
+    iterator begin()
+    {
+        return {this, 0};
+    }
+    iterator end()
+    {
+        return {this, static_cast<std::ptrdiff_t>(size())};
+    }
+    const_iterator begin() const
+    {
+        return {this, 0};
+    }
+    const_iterator end() const
+    {
+        return {this, static_cast<std::ptrdiff_t>(size())};
+    }
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /// Append a copy of a bitstring
+    void push_back(const value_type &bitstring)
+    {
+        adopt_num_bits(bitstring.size());
+        bitstrings_.push_back(bitstring.value());
+    }
+
+    /// Append a copy of a bitstring
+    template <typename BitstringType>
+    void emplace_back(const BitstringType &bitstring)
+    {
+        push_back(bitstring);
+    }
+
+    /// Remove the last bitstring
+    void pop_back()
+    {
+        bitstrings_.pop_back();
+    }
+
+    /// Compare two containers element-wise
+    friend bool
+    operator==(const NativeBitstringVector &a, const NativeBitstringVector &b)
+    {
+        return a.num_bits_ == b.num_bits_ && a.bitstrings_ == b.bitstrings_;
+    }
+
+    /// Compare two containers element-wise
+    friend bool
+    operator!=(const NativeBitstringVector &a, const NativeBitstringVector &b)
+    {
+        return !(a == b);
+    }
+};
+
+namespace internal
+{
+
+// Integers of 16 bits or more split into integers of half as many bits, each
+// holding half as many bits as the bitstring
+template <typename T>
+struct HalfSizeImpl<NativeBitstring<T>, std::enable_if_t<(native_bits<T> >= 16)>> {
+    using type = NativeBitstring<HalfSize<T>>;
+};
+
+template <typename T>
+struct HalfSizeImpl<NativeBitstringRef<T>> : HalfSizeImpl<NativeBitstring<T>> {
+};
+
+template <typename T>
+struct RightLeftHammingImpl<NativeBitstring<T>> {
+    static std::array<std::size_t, 2> count(const NativeBitstring<T> &bitstring)
+    {
+        const auto half_N = bitstring.size() / 2;
+        const auto bits = bitstring.value();
+        const auto right_mask = static_cast<T>((T{1} << half_N) - 1);
+        return {
+            popcount_native(static_cast<T>(bits & right_mask)),
+            popcount_native(static_cast<T>(bits >> half_N))
+        };
+    }
+};
+
+template <typename T>
+struct RightLeftHammingImpl<NativeBitstringRef<T>>
+  : RightLeftHammingImpl<NativeBitstring<T>> {
+};
+
+template <typename T>
+struct WordsImpl<NativeBitstring<T>> {
+    static void copy(const NativeBitstring<T> &bitstring, std::uint64_t *words)
+    {
+        // Only the words spanned by the bits are written
+        const auto bits = bitstring.value();
+        for (std::size_t k = 0; k < words_for_bits(bitstring.size()); ++k) {
+            words[k] = static_cast<std::uint64_t>(bits >> (64 * k));
+        }
+    }
+};
+
+template <typename T>
+struct WordsImpl<NativeBitstringRef<T>> : WordsImpl<NativeBitstring<T>> {
+};
+
+template <typename T>
+struct AssignWordsImpl<NativeBitstring<T>> {
+    static void assign(
+        NativeBitstring<T> &bitstring, const std::uint64_t *words, std::size_t num_bits
+    )
+    {
+        T bits = 0;
+        for (std::size_t k = 0; k < words_for_bits(num_bits); ++k) {
+            bits |= static_cast<T>(static_cast<T>(words[k]) << (64 * k));
+        }
+        bitstring = NativeBitstring<T>(bits, num_bits);
+    }
+};
+
+/// Split a bitstring held in an unsigned integer into its right and left halves,
+/// with a single mask and a single shift.
+template <typename T>
+std::array<HalfSize<NativeBitstring<T>>, 2>
+split_bitstring(const NativeBitstring<T> &bitstring)
+{
+    using HalfType = HalfSize<T>;
+    if (bitstring.size() % 2 != 0) {
+        QKA_SQD_THROW_RUNTIME_ERROR_("Bitset size must be even");
+    }
+    const auto half_N = bitstring.size() / 2;
+    const auto bits = bitstring.value();
+    const auto right_mask = static_cast<T>((T{1} << half_N) - 1);
+    return {
+        NativeBitstring<HalfType>(static_cast<HalfType>(bits & right_mask), half_N),
+        NativeBitstring<HalfType>(static_cast<HalfType>(bits >> half_N), half_N)
+    };
+}
+
+template <typename T>
+std::array<HalfSize<NativeBitstring<T>>, 2>
+split_bitstring(const NativeBitstringRef<T> &bitstring)
+{
+    return split_bitstring(static_cast<NativeBitstring<T>>(bitstring));
+}
+
+} // namespace internal
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // QISKIT_ADDON_SQD_NATIVE_BITSTRING_VECTOR_HPP_
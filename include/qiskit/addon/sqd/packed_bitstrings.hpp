@@ -0,0 +1,589 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_PACKED_BITSTRINGS_HPP_
+#define QISKIT_ADDON_SQD_PACKED_BITSTRINGS_HPP_
+
+/// Contiguous storage for many bitstrings of the same length (requires
+/// `boost::dynamic_bitset`)
+
+#include "qiskit/addon/sqd/borrowing_vector.hpp"
+#include "qiskit/addon/sqd/internal/bitset_common.hpp"
+#include "qiskit/addon/sqd/internal/exception-macros.hpp"
+#include "qiskit/addon/sqd/internal/proxy-iterator.hpp"
+#include "qiskit/addon/sqd/support/boost_dynamic_bitset.hpp"
+
+#if __has_include(<boost/dynamic_bitset.hpp>)
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+/// Read-only reference to a single bitstring stored in a `PackedBitstringVector`.
+class ConstPackedBitstringRef
+{
+  protected:
+    const std::uint64_t *words_;
+    std::size_t num_bits_;
+
+  public:
+    /// Type to which the referenced bitstring can be converted
+    using value_type = boost::dynamic_bitset<std::uint64_t>;
+
+    /// Constructor
+    ///
+    /// @param[in] words Pointer to the `internal::words_for_bits(num_bits)` words
+    ///     of the bitstring, least significant word first.  Any bits beyond
+    ///     `num_bits` in the last word must be zero.
+    /// @param[in] num_bits Number of bits in the bitstring.
+    ConstPackedBitstringRef(const std::uint64_t *words, std::size_t num_bits)
+      : words_(words), num_bits_(num_bits)
+    {
+    }
+
+    /// Return the number of bits
+    std::size_t size() const
+    {
+        return num_bits_;
+    }
+
+    /// Return the number of 64-bit words holding the bits
+    std::size_t num_words() const
+    {
+        return internal::words_for_bits(num_bits_);
+    }
+
+    /// Return a pointer to the words holding the bits, least significant first
+    const std::uint64_t *words() const
+    {
+        return words_;
+    }
+
+    /// Return the value of bit `pos`
+    bool test(std::size_t pos) const
+    {
+        return ((words_[pos / 64] >> (pos % 64)) & 1) != 0;
+    }
+
+    /// Return the value of bit `pos`
+    bool operator[](std::size_t pos) const
+    {
+        return test(pos);
+    }
+
+    /// Return the number of set bits
+    std::size_t count() const
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < num_words(); ++i) {
+            count += internal::popcount64(words_[i]);
+        }
+        return count;
+    }
+
+    /// Return `true` if any bit is set
+    bool any() const
+    {
+        return std::any_of(words_, words_ + num_words(), [](std::uint64_t word) {
+            return word != 0;
+        });
+    }
+
+    /// Return `true` if no bit is set
+    bool none() const
+    {
+        return !any();
+    }
+
+    /// Copy the referenced bitstring into a `boost::dynamic_bitset`
+    operator value_type() const
+    {
+        value_type retval(words_, words_ + num_words());
+        retval.resize(num_bits_);
+        return retval;
+    }
+
+    /// Compare two referenced bitstrings
+    friend bool
+    operator==(const ConstPackedBitstringRef &a, const ConstPackedBitstringRef &b)
+    {
+        return a.num_bits_ == b.num_bits_ &&
+               std::equal(a.words_, a.words_ + a.num_words(), b.words_);
+    }
+
+    /// Compare two referenced bitstrings
+    friend bool
+    operator!=(const ConstPackedBitstringRef &a, const ConstPackedBitstringRef &b)
+    {
+        return !(a == b);
+    }
+
+    /// Compare a referenced bitstring with a `boost::dynamic_bitset` of any
+    /// block type
+    template <typename Block, typename Allocator>
+    friend bool operator==(
+        const ConstPackedBitstringRef &a,
+        const boost::dynamic_bitset<Block, Allocator> &b
+    )
+    {
+        if (a.num_bits_ != b.size()) {
+            return false;
+        }
+        std::vector<std::uint64_t> words(a.num_words());
+        internal::WordsImpl<boost::dynamic_bitset<Block, Allocator>>::copy(
+            b, words.data()
+        );
+        return std::equal(words.begin(), words.end(), a.words_);
+    }
+
+    /// Compare a referenced bitstring with a `boost::dynamic_bitset` of any
+    /// block type
+    template <typename Block, typename Allocator>
+    friend bool operator==(
+        const boost::dynamic_bitset<Block, Allocator> &a,
+        const ConstPackedBitstringRef &b
+    )
+    {
+        return b == a;
+    }
+};
+
+/// Mutable reference to a single bitstring stored in a `PackedBitstringVector`.
+class PackedBitstringRef : public ConstPackedBitstringRef
+{
+  private:
+    std::uint64_t *mutable_words() const
+    {
+        return const_cast<std::uint64_t *>(words_);
+    }
+
+  public:
+    /// Constructor
+    ///
+    /// @param[in] words Pointer to the `internal::words_for_bits(num_bits)` words
+    ///     of the bitstring, least significant word first.
+    /// @param[in] num_bits Number of bits in the bitstring.
+    PackedBitstringRef(std::uint64_t *words, std::size_t num_bits)
+      : ConstPackedBitstringRef(words, num_bits)
+    {
+    }
+
+    PackedBitstringRef(const PackedBitstringRef &) = default;
+
+    /// Overwrite the referenced bitstring with another of the same size
+    PackedBitstringRef &operator=(const ConstPackedBitstringRef &other)
+    {
+        if (other.size() != num_bits_) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_("Bitstring sizes do not match");
+        }
+        std::copy(other.words(), other.words() + num_words(), mutable_words());
+        return *this;
+    }
+
+    /// Overwrite the referenced bitstring with another of the same size
+    PackedBitstringRef &operator=(const PackedBitstringRef &other)
+    {
+        return *this = static_cast<const ConstPackedBitstringRef &>(other);
+    }
+
+    /// Overwrite the referenced bitstring with a `boost::dynamic_bitset`, of any
+    /// block type, of the same size
+    template <typename Block, typename Allocator>
+    PackedBitstringRef &operator=(const boost::dynamic_bitset<Block, Allocator> &other)
+    {
+        if (other.size() != num_bits_) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_("Bitstring sizes do not match");
+        }
+        internal::WordsImpl<boost::dynamic_bitset<Block, Allocator>>::copy(
+            other, mutable_words()
+        );
+        return *this;
+    }
+
+    /// Set bit `pos` to `value`
+    const PackedBitstringRef &set(std::size_t pos, bool value = true) const
+    {
+        const auto mask = std::uint64_t{1} << (pos % 64);
+        if (value) {
+            mutable_words()[pos / 64] |= mask;
+        } else {
+            mutable_words()[pos / 64] &= ~mask;
+        }
+        return *this;
+    }
+
+    /// Clear bit `pos`
+    const PackedBitstringRef &reset(std::size_t pos) const
+    {
+        return set(pos, false);
+    }
+
+    /// Toggle bit `pos`
+    const PackedBitstringRef &flip(std::size_t pos) const
+    {
+        mutable_words()[pos / 64] ^= std::uint64_t{1} << (pos % 64);
+        return *this;
+    }
+};
+
+/// Container of bitstrings of uniform length, stored as a single contiguous
+/// matrix of 64-bit words.
+///
+/// Each bitstring occupies `words_per_bitstring()` consecutive words, least
+/// significant word first, and any unused bits in its last word are zero.
+/// Elements are accessed through the proxy types `PackedBitstringRef` and
+/// `ConstPackedBitstringRef`, which convert to `value_type` on demand.  As
+/// with `std::vector<bool>`, `auto x = v[i]` yields a reference, not a copy.
+///
+/// A default-constructed container adopts the length of the first bitstring
+/// added to it.  This allows it to be used as the `BitstringVectorType` of the
+/// functions in this library, which return containers of the same type as
+/// their input.
+///
+/// A container may also borrow its word matrix from memory it does not own,
+/// such as a memory-mapped file (see `PackedBitstringVector::borrow`).  As with
+/// `BorrowingVector`, any non-const access copies the borrowed words first, so
+/// a borrowed container should be accessed through a const reference.
+class PackedBitstringVector
+{
+  private:
+    BorrowingVector<std::uint64_t> words_;
+    std::size_t num_bits_ = 0;
+    std::size_t words_per_bitstring_ = 0;
+    std::size_t size_ = 0;
+
+    void adopt_num_bits(std::size_t num_bits)
+    {
+        if (num_bits == num_bits_) {
+            return;
+        }
+        if (size_ != 0 || num_bits_ != 0) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Bitstring length does not match the length of the container"
+            );
+        }
+        num_bits_ = num_bits;
+        words_per_bitstring_ = internal::words_for_bits(num_bits);
+    }
+
+    std::uint64_t *append_zeroed()
+    {
+        words_.resize(words_.size() + words_per_bitstring_);
+        ++size_;
+        return words_.data() + words_.size() - words_per_bitstring_;
+    }
+
+  public:
+    /// Type of the bitstrings as returned by value
+    using value_type = boost::dynamic_bitset<std::uint64_t>;
+    using reference = PackedBitstringRef;
+    using const_reference = ConstPackedBitstringRef;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator = internal::ProxyIterator<PackedBitstringVector, false>;
+    using const_iterator = internal::ProxyIterator<PackedBitstringVector, true>;
+
+    /// Construct an empty container, which adopts the length of the first
+    /// bitstring added to it.
+    PackedBitstringVector() = default;
+
+    /// Construct a container holding `count` bitstrings of `num_bits` bits each,
+    /// all of which are zero.
+    explicit PackedBitstringVector(std::size_t num_bits, std::size_t count = 0)
+      : words_(internal::words_for_bits(num_bits) * count), num_bits_(num_bits),
+        words_per_bitstring_(internal::words_for_bits(num_bits)), size_(count)
+    {
+    }
+
+    /// Construct a container which borrows its word matrix.
+    ///
+    /// @param[in] words Pointer to the `count * internal::words_for_bits(num_bits)`
+    ///     words of the bitstrings, laid out as described above, which must
+    ///     outlive the container and every copy of it.
+    /// @param[in] num_bits Number of bits in each bitstring
+    /// @param[in] count Number of bitstrings
+    static PackedBitstringVector
+    borrow(const std::uint64_t *words, std::size_t num_bits, std::size_t count)
+    {
+        PackedBitstringVector retval(num_bits);
+        retval.words_ = BorrowingVector<std::uint64_t>::borrow(
+            words, count * retval.words_per_bitstring_
+        );
+        retval.size_ = count;
+        return retval;
+    }
+
+    /// Return `true` if the word matrix is borrowed
+    bool is_borrowed() const
+    {
+        return words_.is_borrowed();
+    }
+
+    /// Return the number of bits in each bitstring
+    std::size_t num_bits() const
+    {
+        return num_bits_;
+    }
+
+    /// Return the number of 64-bit words occupied by each bitstring
+    std::size_t words_per_bitstring() const
+    {
+        return words_per_bitstring_;
+    }
+
+    /// Return a pointer to the underlying word matrix
+    const std::uint64_t *data() const
+    {
+        return words_.data();
+    }
+
+    /// Return a pointer to the underlying word matrix, copying it first if it
+    /// is borrowed
+    std::uint64_t *data()
+    {
+        return words_.data();
+    }
+
+    /// Return the number of bitstrings
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /// Return `true` if the container holds no bitstrings
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    /// Reserve storage for at least `count` bitstrings
+    void reserve(std::size_t count)
+    {
+        words_.reserve(count * words_per_bitstring_);
+    }
+
+    /// Remove all bitstrings, keeping the bitstring length and the storage
+    void clear()
+    {
+        words_.clear();
+        size_ = 0;
+    }
+
+    /// Resize to hold `count` bitstrings, zero-initializing any new ones
+    void resize(std::size_t count)
+    {
+        words_.resize(count * words_per_bitstring_);
+        size_ = count;
+    }
+
+    /// Access bitstring `pos`
+    reference operator[](std::size_t pos)
+    {
+        return {words_.data() + pos * words_per_bitstring_, num_bits_};
+    }
+
+    /// Access bitstring `pos`
+    const_reference operator[](std::size_t pos) const
+    {
+        return {words_.data() + pos * words_per_bitstring_, num_bits_};
+    }
+
+    /// Access the first bitstring
+    reference front()
+    {
+        return (*this)[0];
+    }
+
+    /// Access the first bitstring
+    const_reference front() const
+    {
+        return (*this)[0];
+    }
+
+    /// Access the last bitstring
+    reference back()
+    {
+        return (*this)[size_ - 1];
+    }
+
+    /// Access the last bitstring
+    const_reference back() const
+    {
+        return (*this)[size_ - 1];
+    }
+
+    iterator begin()
+    {
+        return {this, 0};
+    }
+    iterator end()
+    {
+        return {this, static_cast<std::ptrdiff_t>(size_)};
+    }
+    const_iterator begin() const
+    {
+        return {this, 0};
+    }
+    const_iterator end() const
+    {
+        return {this, static_cast<std::ptrdiff_t>(size_)};
+    }
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /// Append a copy of a referenced bitstring
+    void push_back(const_reference bitstring)
+    {
+        adopt_num_bits(bitstring.size());
+        // The source may live in this container, so copy it to a temporary
+        // before the storage is possibly reallocated.
+        if (bitstring.words() >= words_.data() &&
+            bitstring.words() < words_.data() + words_.size()) {
+            const auto offset = static_cast<std::size_t>(bitstring.words() - data());
+            auto *dest = append_zeroed();
+            std::copy_n(words_.data() + offset, words_per_bitstring_, dest);
+            return;
+        }
+        auto *dest = append_zeroed();
+        std::copy_n(bitstring.words(), words_per_bitstring_, dest);
+    }
+
+    /// Append a copy of a `boost::dynamic_bitset` of any block type
+    template <typename Block, typename Allocator>
+    void push_back(const boost::dynamic_bitset<Block, Allocator> &bitstring)
+    {
+        adopt_num_bits(bitstring.size());
+        internal::WordsImpl<boost::dynamic_bitset<Block, Allocator>>::copy(
+            bitstring, append_zeroed()
+        );
+    }
+
+    /// Append a copy of a bitstring
+    template <typename BitstringType>
+    void emplace_back(const BitstringType &bitstring)
+    {
+        push_back(bitstring);
+    }
+
+    /// Remove the last bitstring
+    void pop_back()
+    {
+        words_.resize(words_.size() - words_per_bitstring_);
+        --size_;
+    }
+
+    /// Compare two containers element-wise
+    friend bool
+    operator==(const PackedBitstringVector &a, const PackedBitstringVector &b)
+    {
+        return a.size_ == b.size_ && a.num_bits_ == b.num_bits_ && a.words_ == b.words_;
+    }
+
+    /// Compare two containers element-wise
+    friend bool
+    operator!=(const PackedBitstringVector &a, const PackedBitstringVector &b)
+    {
+        return !(a == b);
+    }
+};
+
+namespace internal
+{
+
+template <>
+struct HalfSizeImpl<ConstPackedBitstringRef> {
+    using type = ConstPackedBitstringRef::value_type;
+};
+
+template <>
+struct HalfSizeImpl<PackedBitstringRef> {
+    using type = ConstPackedBitstringRef::value_type;
+};
+
+inline std::array<ConstPackedBitstringRef::value_type, 2>
+split_bitstring(const ConstPackedBitstringRef &bitstring)
+{
+    if (bitstring.size() % 2 != 0) {
+        QKA_SQD_THROW_RUNTIME_ERROR_("Bitset size must be even");
+    }
+    const auto half_N = bitstring.size() / 2;
+    std::vector<std::uint64_t> buffer(words_for_bits(half_N));
+    std::array<ConstPackedBitstringRef::value_type, 2> retval;
+    for (std::size_t s = 0; s < 2; ++s) {
+        extract_bits(bitstring.words(), s * half_N, half_N, buffer.data());
+        retval[s].append(buffer.begin(), buffer.end());
+        retval[s].resize(half_N);
+    }
+    return retval;
+}
+
+template <>
+struct RightLeftHammingImpl<ConstPackedBitstringRef> {
+    static std::array<std::size_t, 2> count(const ConstPackedBitstringRef &bitstring)
+    {
+        const auto half_N = bitstring.size() / 2;
+        return {
+            count_bits_in_range(bitstring.words(), 0, half_N),
+            count_bits_in_range(bitstring.words(), half_N, bitstring.size())
+        };
+    }
+};
+
+template <>
+struct RightLeftHammingImpl<PackedBitstringRef>
+  : RightLeftHammingImpl<ConstPackedBitstringRef> {
+};
+
+template <>
+struct WordsImpl<ConstPackedBitstringRef> {
+    static void copy(const ConstPackedBitstringRef &bitstring, std::uint64_t *words)
+    {
+        std::copy_n(bitstring.words(), bitstring.num_words(), words);
+    }
+};
+
+template <>
+struct WordsImpl<PackedBitstringRef> : WordsImpl<ConstPackedBitstringRef> {
+};
+
+} // namespace internal
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // __has_include(<boost/dynamic_bitset.hpp>)
+
+#endif // QISKIT_ADDON_SQD_PACKED_BITSTRINGS_HPP_
@@ -0,0 +1,611 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_PARSING_HPP_
+#define QISKIT_ADDON_SQD_PARSING_HPP_
+
+/// Parsing of count dictionaries from text (requires `boost::dynamic_bitset`)
+
+#include "qiskit/addon/sqd/packed_bitstrings.hpp"
+
+#if __has_include(<boost/dynamic_bitset.hpp>)
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "qiskit/addon/sqd/internal/bitset_common.hpp"
+#include "qiskit/addon/sqd/internal/exception-macros.hpp"
+#include "qiskit/addon/sqd/internal/parallel.hpp"
+
+// Binary keys are converted 32 characters at a time with AVX2 where the
+// compiler targets it, and 8 characters at a time otherwise.  Define
+// `QKA_SQD_DISABLE_SIMD` to 1 to never use AVX2.
+#if !QKA_SQD_DISABLE_SIMD && defined(__AVX2__)
+#define QKA_SQD_PARSE_AVX2_ 1
+#include <immintrin.h>
+#endif
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+namespace internal
+{
+
+/// Convert the binary digits `[key, key + length)`, most significant first, into
+/// the zero-initialized words of a bitstring of `length` bits.
+///
+/// @return `false` if any character is not a binary digit
+inline bool
+parse_binary_digits(const char *key, std::size_t length, std::uint64_t *words)
+{
+    // Digits `[0, end)` remain, and the next bit to fill is `length - end`.
+    // Since blocks are consumed from the end in multiples of 8 digits, each
+    // block lies within a single word.
+    std::size_t end = length;
+#if QKA_SQD_PARSE_AVX2_
+    // Reverse the 32 bytes, so that the last digit lands in the lowest bit
+    const __m256i reverse = _mm256_setr_epi8(
+        15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10,
+        9, 8, 7, 6, 5, 4, 3, 2, 1, 0
+    );
+    const __m256i zeros = _mm256_set1_epi8('0');
+    const __m256i ones = _mm256_set1_epi8('1');
+    for (; end >= 32; end -= 32) {
+        __m256i chars =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key + end - 32));
+        chars = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(chars, reverse), 0x4e);
+        const __m256i is_one = _mm256_cmpeq_epi8(chars, ones);
+        const __m256i is_digit =
+            _mm256_or_si256(is_one, _mm256_cmpeq_epi8(chars, zeros));
+        if (_mm256_movemask_epi8(is_digit) != -1) {
+            return false;
+        }
+        const auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(is_one));
+        const auto offset = length - end;
+        words[offset / 64] |= std::uint64_t{bits} << (offset % 64);
+    }
+#endif // QKA_SQD_PARSE_AVX2_
+    // Eight digits at a time within a 64-bit word.  XOR with '0' leaves each
+    // byte 0 or 1, and the multiplication gathers the digit at `end - 8 + k`
+    // into bit `7 - k`, whichever the byte order of the host.
+    const bool little_endian = host_is_little_endian();
+    constexpr std::uint64_t ascii_zeros = 0x3030303030303030ULL;
+    constexpr std::uint64_t low_bits = 0x0101010101010101ULL;
+    for (; end >= 8; end -= 8) {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, key + end - 8, 8);
+        chunk ^= ascii_zeros;
+        if ((chunk & ~low_bits) != 0) {
+            return false;
+        }
+        const auto bits = little_endian ? (chunk * 0x8040201008040201ULL) >> 56
+                                        : (chunk * 0x0102040810204080ULL) >> 56;
+        const auto offset = length - end;
+        words[offset / 64] |= bits << (offset % 64);
+    }
+    for (std::size_t p = 0; p < end; ++p) {
+        if (key[p] != '0' && key[p] != '1') {
+            return false;
+        }
+        const auto i = length - 1 - p;
+        words[i / 64] |= static_cast<std::uint64_t>(key[p] - '0') << (i % 64);
+    }
+    return true;
+}
+
+/// Return the value of a hexadecimal digit, or -1 for any other character.
+inline int hex_digit_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/// Convert the hexadecimal digits `[key, key + length)`, most significant
+/// first, into the zero-initialized words of a bitstring of `num_bits` bits.
+///
+/// @return `false` if any character is not a hexadecimal digit, or if the
+///     value does not fit in `num_bits` bits
+inline bool parse_hex_digits(
+    const char *key, std::size_t length, std::size_t num_bits, std::uint64_t *words
+)
+{
+    if (length == 0) {
+        return false;
+    }
+    const auto num_words = words_for_bits(num_bits);
+    for (std::size_t p = 0; p < length; ++p) {
+        const int value = hex_digit_value(key[p]);
+        if (value < 0) {
+            return false;
+        }
+        const auto i = 4 * (length - 1 - p);
+        if (i / 64 < num_words) {
+            words[i / 64] |= static_cast<std::uint64_t>(value) << (i % 64);
+        } else if (value != 0) {
+            return false;
+        }
+    }
+    return num_bits % 64 == 0 ||
+           (words[num_words - 1] & ~low_bits_mask(num_bits % 64)) == 0;
+}
+
+/// Powers of ten which are exactly representable as `double`s
+constexpr double exact_powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                          1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                          1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                          1e18, 1e19, 1e20, 1e21, 1e22};
+
+/// Parse a count, which is a nonnegative number in the syntax of JSON: digits,
+/// then optionally a fraction and an exponent.  Signs other than that of the
+/// exponent, `nan`, `inf`, and numbers too large for a `double`, are rejected.
+///
+/// The parsing does not depend on the C locale.  Numbers of up to 17
+/// significant digits with small exponents are converted exactly here.  Others,
+/// which should be rare, are converted by `std::from_chars` where the standard
+/// library supports it for floating point, and by a stream in the classic
+/// locale otherwise.
+///
+/// @return `false` if `[begin, end)` is not a count
+inline bool parse_count(const char *begin, const char *end, double &value)
+{
+    // Integers of up to 19 digits, which fit in 64 bits, are parsed directly
+    std::uint64_t integer = 0;
+    const char *p = begin;
+    while (p != end && p - begin < 19 && *p >= '0' && *p <= '9') {
+        integer = 10 * integer + static_cast<std::uint64_t>(*p - '0');
+        ++p;
+    }
+    if (p == end && p != begin) {
+        value = static_cast<double>(integer);
+        return true;
+    }
+
+    // Check the syntax, and gather up to 17 significant digits in `mantissa`,
+    // which then holds the number times a power of ten, `-exponent`
+    constexpr std::uint64_t max_mantissa = 10000000000000000ULL;
+    std::uint64_t mantissa = 0;
+    std::int64_t exponent = 0;
+    bool exact = true;
+    const auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+    const auto add_digit = [&](char c, bool fraction) {
+        if (mantissa < max_mantissa) {
+            mantissa = 10 * mantissa + static_cast<std::uint64_t>(c - '0');
+            exponent -= fraction ? 1 : 0;
+        } else {
+            exact = exact && c == '0';
+            exponent += fraction ? 0 : 1;
+        }
+    };
+    p = begin;
+    if (p == end || !is_digit(*p)) {
+        return false;
+    }
+    for (; p != end && is_digit(*p); ++p) {
+        add_digit(*p, false);
+    }
+    if (p != end && *p == '.') {
+        if (++p == end || !is_digit(*p)) {
+            return false;
+        }
+        for (; p != end && is_digit(*p); ++p) {
+            add_digit(*p, true);
+        }
+    }
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        const bool negative = p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+')) {
+            ++p;
+        }
+        if (p == end || !is_digit(*p)) {
+            return false;
+        }
+        std::int64_t power = 0;
+        for (; p != end && is_digit(*p); ++p) {
+            // Any larger exponent overflows or underflows regardless
+            power = std::min<std::int64_t>(10 * power + (*p - '0'), 100000);
+        }
+        exponent += negative ? -power : power;
+    }
+    if (p != end) {
+        return false;
+    }
+
+    constexpr std::int64_t max_exact_power = 22;
+    if (mantissa == 0 && exact) {
+        value = 0.0;
+        return true;
+    }
+    if (exact && mantissa <= (std::uint64_t{1} << 53) &&
+        exponent >= -max_exact_power && exponent <= max_exact_power) {
+        const auto m = static_cast<double>(mantissa);
+        value = exponent < 0 ? m / exact_powers_of_ten[-exponent]
+                             : m * exact_powers_of_ten[exponent];
+        return true;
+    }
+#if defined(__cpp_lib_to_chars)
+    const auto result = std::from_chars(begin, end, value);
+    if (result.ec != std::errc{} || result.ptr != end) {
+        return false;
+    }
+#else
+    std::istringstream stream(std::string(begin, end));
+    stream.imbue(std::locale::classic());
+    if (!(stream >> value)) {
+        return false;
+    }
+#endif // defined(__cpp_lib_to_chars)
+    return std::isfinite(value);
+}
+
+/// Whether `c` separates entries, or precedes the first entry
+inline bool is_entry_separator(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' || c == '{' ||
+           c == '}';
+}
+
+/// Whether `c` ends an unquoted key or a count
+inline bool ends_token(char c)
+{
+    return is_entry_separator(c) || c == ':';
+}
+
+/// A key as it appears in the text
+struct CountKey {
+    const char *begin = nullptr;
+    std::size_t length = 0;
+    bool quoted = false;
+    bool hex = false;
+};
+
+/// Parser of the entries of a count dictionary within `[begin, end)` of `text`.
+class CountsParser
+{
+  private:
+    std::string_view text_;
+    const char *pos_;
+    const char *end_;
+    std::string compacted_key_;
+
+    [[noreturn]] void fail(const char *what, const char *where) const
+    {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            std::string(what) + " at byte " +
+            std::to_string(static_cast<std::size_t>(where - text_.data()))
+        );
+    }
+
+  public:
+    CountsParser(std::string_view text, std::size_t begin, std::size_t end)
+      : text_(text), pos_(text.data() + begin), end_(text.data() + end)
+    {
+    }
+
+    /// Skip to the next key, and return `false` if there is none.
+    bool skip_separators()
+    {
+        while (pos_ != end_ && is_entry_separator(*pos_)) {
+            ++pos_;
+        }
+        return pos_ != end_;
+    }
+
+    /// Read the key at the current position.
+    CountKey read_key()
+    {
+        CountKey key;
+        const char *start = pos_;
+        if (*pos_ == '"' || *pos_ == '\'') {
+            const char quote = *pos_++;
+            key.begin = pos_;
+            while (pos_ != end_ && *pos_ != quote) {
+                ++pos_;
+            }
+            if (pos_ == end_) {
+                fail("Unterminated key", start);
+            }
+            key.length = static_cast<std::size_t>(pos_ - key.begin);
+            key.quoted = true;
+            ++pos_;
+        } else {
+            key.begin = pos_;
+            while (pos_ != end_ && !ends_token(*pos_)) {
+                ++pos_;
+            }
+            key.length = static_cast<std::size_t>(pos_ - key.begin);
+        }
+        if (key.length >= 2 && key.begin[0] == '0' &&
+            (key.begin[1] == 'x' || key.begin[1] == 'X')) {
+            key.hex = true;
+            key.begin += 2;
+            key.length -= 2;
+        } else if (key.quoted &&
+                   std::find(key.begin, key.begin + key.length, ' ') !=
+                       key.begin + key.length) {
+            // Qiskit separates the classical registers of a key with spaces
+            compacted_key_.assign(key.begin, key.length);
+            compacted_key_.erase(
+                std::remove(compacted_key_.begin(), compacted_key_.end(), ' '),
+                compacted_key_.end()
+            );
+            key.begin = compacted_key_.data();
+            key.length = compacted_key_.size();
+        }
+        return key;
+    }
+
+    /// Parse the next entry into a new bitstring of `bitstrings`, and its count
+    /// into `weights`.  Return `false` if there are no more entries.
+    bool
+    parse_entry(PackedBitstringVector &bitstrings, std::vector<double> &weights)
+    {
+        if (!skip_separators()) {
+            return false;
+        }
+        const char *start = pos_;
+        const auto key = read_key();
+        const auto num_bits = bitstrings.num_bits();
+        bitstrings.resize(bitstrings.size() + 1);
+        auto *words = bitstrings.data() +
+                      (bitstrings.size() - 1) * bitstrings.words_per_bitstring();
+        const bool valid =
+            key.hex ? parse_hex_digits(key.begin, key.length, num_bits, words)
+                    : key.length == num_bits &&
+                          parse_binary_digits(key.begin, key.length, words);
+        if (!valid) {
+            fail("Invalid bitstring", start);
+        }
+
+        while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\t')) {
+            ++pos_;
+        }
+        if (pos_ != end_ && (*pos_ == ':' || *pos_ == ',')) {
+            ++pos_;
+        }
+        while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\t')) {
+            ++pos_;
+        }
+        const char *count_begin = pos_;
+        while (pos_ != end_ && !ends_token(*pos_)) {
+            ++pos_;
+        }
+        double count;
+        if (!parse_count(count_begin, pos_, count)) {
+            fail("Invalid count", count_begin);
+        }
+        weights.push_back(count);
+        return true;
+    }
+};
+
+/// Return the offset of the first entry of a count dictionary, skipping a
+/// header line whose first field does not start with a binary digit.
+inline std::size_t first_entry_offset(std::string_view text)
+{
+    std::size_t pos = 0;
+    while (pos < text.size() && is_entry_separator(text[pos]) && text[pos] != '{') {
+        ++pos;
+    }
+    if (pos == text.size() || text[pos] == '{') {
+        return pos;
+    }
+    std::size_t first = pos;
+    if (text[first] == '"' || text[first] == '\'') {
+        ++first;
+    }
+    if (first < text.size() && (text[first] == '0' || text[first] == '1')) {
+        return pos;
+    }
+    const auto newline = text.find('\n', pos);
+    return newline == std::string_view::npos ? text.size() : newline + 1;
+}
+
+/// Parse the entries within `[begin, end)` of `text`.
+inline std::pair<PackedBitstringVector, std::vector<double>> parse_counts_range(
+    std::string_view text, std::size_t begin, std::size_t end, std::size_t num_bits
+)
+{
+    std::pair<PackedBitstringVector, std::vector<double>> retval{
+        PackedBitstringVector(num_bits), {}
+    };
+    CountsParser parser(text, begin, end);
+    while (parser.parse_entry(retval.first, retval.second)) {
+    }
+    return retval;
+}
+
+/// Return the number of bits of the first key of a count dictionary, or 0 if
+/// there is no key or the first key is hexadecimal.
+inline std::size_t infer_num_bits(std::string_view text, std::size_t begin)
+{
+    CountsParser parser(text, begin, text.size());
+    if (!parser.skip_separators()) {
+        return 0;
+    }
+    const auto key = parser.read_key();
+    return key.hex ? 0 : key.length;
+}
+
+/// Return `num_bits` if it is nonzero, or else the number of bits of the
+/// first key.
+inline std::size_t
+resolve_num_bits(std::string_view text, std::size_t begin, std::size_t num_bits)
+{
+    if (num_bits != 0) {
+        return num_bits;
+    }
+    num_bits = infer_num_bits(text, begin);
+    if (num_bits == 0) {
+        CountsParser parser(text, begin, text.size());
+        if (parser.skip_separators()) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "`num_bits` must be given when the first key is hexadecimal"
+            );
+        }
+    }
+    return num_bits;
+}
+
+} // namespace internal
+
+/// Parse a count dictionary from text into bitstrings and their counts.
+///
+/// The text may be a JSON object, such as `{"0110": 12, "1001": 3}`, or lines of
+/// comma-, colon- or whitespace-separated keys and counts, as in a CSV file.
+/// A first line whose first field does not start with `0` or `1` is taken to be
+/// a header, and skipped.
+///
+/// Each key is either a binary string, most significant bit first, as returned
+/// by Qiskit, or a hexadecimal string prefixed with `0x`.  Quoted binary keys
+/// may contain spaces, which separate classical registers.  Each count is an
+/// integer or a floating-point number.  Entries with the same key are not
+/// merged.
+///
+/// Binary keys are converted to words directly, without intermediate strings
+/// or bitsets: 32 characters at a time with AVX2 where the compiler targets it,
+/// and 8 at a time otherwise.
+///
+/// @param[in] text Count dictionary
+/// @param[in] num_bits Number of bits of each bitstring.  If zero, the length
+///     of the first key is used, which must then be binary.
+///
+/// @return The bitstrings, in order of appearance, and their counts.
+///
+/// @throws std::invalid_argument if a key is not a binary or hexadecimal string
+///     of `num_bits` bits, or if a count is not a finite nonnegative number.
+inline std::pair<PackedBitstringVector, std::vector<double>>
+parse_counts(std::string_view text, std::size_t num_bits = 0)
+{
+    const auto begin = internal::first_entry_offset(text);
+    num_bits = internal::resolve_num_bits(text, begin, num_bits);
+    return internal::parse_counts_range(text, begin, text.size(), num_bits);
+}
+
+/// Parse a count dictionary from text on multiple threads.
+///
+/// The text is divided into shards at entry boundaries, each about
+/// `options.shard_size` times as long as its first entry, and the shards are
+/// parsed concurrently.  The result is identical to that of the
+/// single-threaded overload; `options.seed` is unused.
+///
+/// @param[in] text Count dictionary
+/// @param[in] num_bits Number of bits of each bitstring.  If zero, the length
+///     of the first key is used, which must then be binary.
+/// @param[in] options Multithreading options
+///
+/// @return The bitstrings, in order of appearance, and their counts.
+///
+/// @throws std::invalid_argument if a key is not a binary or hexadecimal string
+///     of `num_bits` bits, if a count is not a finite nonnegative number, or if
+///     `options.shard_size` is zero.
+inline std::pair<PackedBitstringVector, std::vector<double>>
+parse_counts(std::string_view text, std::size_t num_bits, ParallelOptions options)
+{
+    if (options.shard_size == 0) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("`shard_size` must be nonzero");
+    }
+    const auto begin = internal::first_entry_offset(text);
+    num_bits = internal::resolve_num_bits(text, begin, num_bits);
+
+    // A comma always ends an entry of a JSON object, and a newline always ends
+    // a line, so shards start just after one of them.
+    std::size_t start = begin;
+    while (start < text.size() && internal::is_entry_separator(text[start]) &&
+           text[start] != '{') {
+        ++start;
+    }
+    const char boundary = start < text.size() && text[start] == '{' ? ',' : '\n';
+    const auto first_boundary = text.find(boundary, start);
+    if (first_boundary == std::string_view::npos) {
+        return internal::parse_counts_range(text, begin, text.size(), num_bits);
+    }
+    const auto shard_length = (first_boundary + 1 - begin) * options.shard_size;
+    std::vector<std::size_t> shard_begins{begin};
+    while (text.size() - shard_begins.back() > shard_length) {
+        const auto next = text.find(boundary, shard_begins.back() + shard_length);
+        if (next == std::string_view::npos) {
+            break;
+        }
+        shard_begins.push_back(next + 1);
+    }
+    shard_begins.push_back(text.size());
+
+    const auto num_shards = shard_begins.size() - 1;
+    std::vector<std::pair<PackedBitstringVector, std::vector<double>>> shards(
+        num_shards
+    );
+    const auto num_threads =
+        internal::resolve_num_threads(options.num_threads, num_shards);
+    internal::parallel_for(num_shards, num_threads, [&](std::size_t shard, unsigned) {
+        shards[shard] = internal::parse_counts_range(
+            text, shard_begins[shard], shard_begins[shard + 1], num_bits
+        );
+    });
+    if (num_shards == 1) {
+        return std::move(shards[0]);
+    }
+
+    std::size_t total = 0;
+    for (const auto &shard : shards) {
+        total += shard.first.size();
+    }
+    std::pair<PackedBitstringVector, std::vector<double>> retval{
+        PackedBitstringVector(num_bits, total), {}
+    };
+    retval.second.reserve(total);
+    auto *dest = retval.first.data();
+    for (const auto &shard : shards) {
+        const auto &bitstrings = shard.first;
+        const auto num_words = bitstrings.size() * bitstrings.words_per_bitstring();
+        dest = std::copy_n(bitstrings.data(), num_words, dest);
+        retval.second.insert(
+            retval.second.end(), shard.second.begin(), shard.second.end()
+        );
+    }
+    return retval;
+}
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // __has_include(<boost/dynamic_bitset.hpp>)
+
+#endif // QISKIT_ADDON_SQD_PARSING_HPP_
@@ -15,11 +15,16 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "qiskit/addon/sqd/bitset_full.hpp"
 #include "qiskit/addon/sqd/internal/exception-macros.hpp"
+#include "qiskit/addon/sqd/internal/simd-popcount.hpp"
 
 // QKA_SQD_IF_UNLIKELY_ private macro
 #if __cplusplus >= 202002L
@@ -68,16 +73,151 @@ class MatchesRightLeftHamming
     template <typename BitstringType>
     bool operator()(const BitstringType &bitstring) const
     {
-        QKA_SQD_IF_UNLIKELY_(bitstring.size() % 2 == 1)
+        QKA_SQD_IF_UNLIKELY_(internal::bitstring_size(bitstring) % 2 == 1)
         {
             QKA_SQD_THROW_INVALID_ARGUMENT_("`bitstring` must have even length");
         }
-        const auto left_count = (bitstring >> (bitstring.size() / 2)).count();
-        decltype(left_count) right_count = bitstring.count() - left_count;
+        const auto [right_count, left_count] =
+            internal::RightLeftHammingImpl<BitstringType>::count(bitstring);
         return right_count == right_target && left_count == left_target;
     }
+
+    /// Hamming weight required of the right half of a bitstring.
+    UnsignedType get_right_target() const
+    {
+        return right_target;
+    }
+
+    /// Hamming weight required of the left half of a bitstring.
+    UnsignedType get_left_target() const
+    {
+        return left_target;
+    }
 };
 
+namespace internal
+{
+
+template <typename WeightType>
+void _validate_postselected_weight(const WeightType &weight)
+{
+    if (std::isnan(weight)) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("NaN found in weight array");
+    }
+    if (std::isinf(weight)) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("Infinite value found in weight array");
+    }
+    if (weight < 0) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("Negative value found in weight array");
+    }
+}
+
+// Append the bitstrings that pass `filter_function`, and their weights, to the
+// output vectors, and return the sum of the appended weights.
+template <
+    typename BitstringVectorType, typename WeightVectorType, typename CallableType,
+    typename OutputBitstringVectorType, typename OutputWeightVectorType>
+typename OutputWeightVectorType::value_type _postselect_append(
+    const BitstringVectorType &bitstrings, const WeightVectorType &weights,
+    CallableType &filter_function, OutputBitstringVectorType &filtered_bitstrings,
+    OutputWeightVectorType &filtered_weights
+)
+{
+    if (bitstrings.size() != weights.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "`weights` must be same length as `bitstrings`"
+        );
+    }
+
+    auto current_bitstring = bitstrings.begin();
+    auto current_weight = weights.begin();
+    typename OutputWeightVectorType::value_type filtered_weights_sum{};
+    while (current_bitstring != bitstrings.end()) {
+        if (filter_function(*current_bitstring)) {
+            _validate_postselected_weight(*current_weight);
+            filtered_bitstrings.push_back(*current_bitstring);
+            filtered_weights.push_back(*current_weight);
+            filtered_weights_sum += *current_weight;
+        }
+        ++current_bitstring;
+        ++current_weight;
+    }
+    return filtered_weights_sum;
+}
+
+template <typename WeightVectorType>
+void _normalize_postselected_weights(
+    WeightVectorType &weights, typename WeightVectorType::value_type weights_sum
+)
+{
+    if (weights_sum != 0) {
+        for (auto &weight : weights) {
+            weight /= weights_sum;
+        }
+    }
+}
+
+// Validate the weights of the bitstrings selected by `bitmap`, then move those
+// bitstrings and weights to the front of `bitstrings` and `weights`, preserving
+// their order, and truncate both.  Every weight is checked before anything is
+// moved, so an invalid weight leaves the input untouched.  Return the sum of
+// the kept weights.
+template <typename BitstringVectorType, typename WeightVectorType>
+typename WeightVectorType::value_type _compact_postselected(
+    const std::vector<std::uint64_t> &bitmap, BitstringVectorType &bitstrings,
+    WeightVectorType &weights
+)
+{
+    for_each_set_bit(bitmap.data(), bitmap.size(), [&](std::size_t i) {
+        _validate_postselected_weight(weights[i]);
+    });
+
+    std::size_t num_filtered = 0;
+    typename WeightVectorType::value_type filtered_weights_sum{};
+    for_each_set_bit(bitmap.data(), bitmap.size(), [&](std::size_t i) {
+        if (num_filtered != i) {
+            bitstrings[num_filtered] = std::move(bitstrings[i]);
+            weights[num_filtered] = weights[i];
+        }
+        filtered_weights_sum += weights[num_filtered];
+        ++num_filtered;
+    });
+    bitstrings.resize(num_filtered);
+    weights.resize(num_filtered);
+    return filtered_weights_sum;
+}
+
+} // namespace internal
+
+/// Compute which bitstrings pass a given criteria.
+///
+/// @param[in] bitstrings Bitstrings to consider.
+/// @param[in] filter_function Callable which returns a boolean indicating whether a
+///     is to be kept.
+///
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+/// @tparam CallableType Type of `filter_function`, compatible with
+///     `bool (*f)(const BitstringType &)`.
+///
+/// @return Selection bitmap, of `(bitstrings.size() + 63) / 64` words, whose bit
+///     `i % 64` of word `i / 64` is set if `bitstrings[i]` is to be kept.
+template <typename BitstringVectorType, typename CallableType>
+std::vector<std::uint64_t> postselection_bitmap(
+    const BitstringVectorType &bitstrings, CallableType filter_function
+)
+{
+    std::vector<std::uint64_t> bitmap(internal::words_for_bits(bitstrings.size()));
+    std::size_t i = 0;
+    for (const auto &bitstring : bitstrings) {
+        if (filter_function(bitstring)) {
+            bitmap[i / 64] |= std::uint64_t{1} << (i % 64);
+        }
+        ++i;
+    }
+    return bitmap;
+}
+
 /// Post-select bitstrings based on a given criteria.
 ///
 /// @param[in] bitstrings Bitstrings to consider.
@@ -106,6 +246,46 @@ std::pair<BitstringVectorType, WeightVectorType> postselect_bitstrings(
     const BitstringVectorType &bitstrings, const WeightVectorType &weights,
     CallableType filter_function
 )
+{
+    // Filter bitstrings
+    BitstringVectorType filtered_bitstrings;
+    WeightVectorType filtered_weights;
+    const auto filtered_weights_sum = internal::_postselect_append(
+        bitstrings, weights, filter_function, filtered_bitstrings, filtered_weights
+    );
+
+    // Normalize weights
+    internal::_normalize_postselected_weights(filtered_weights, filtered_weights_sum);
+
+    return {std::move(filtered_bitstrings), std::move(filtered_weights)};
+}
+
+/// Post-select bitstrings based on a given criteria (in-place version).
+///
+/// The bitstrings that pass `filter_function` are compacted to the front of
+/// `bitstrings`, preserving their order, and both vectors are then truncated,
+/// so no second copy of the input is ever made.  The weights of all of them are
+/// validated first, so if one is invalid, both vectors are left unchanged.
+///
+/// @param[in,out] bitstrings Bitstrings to consider.  On return, contains the
+///     post-selected bitstrings.
+/// @param[in,out] weights Relative weight of each bitstring (need not be normalized
+///     to 1).  On return, contains the weights of the post-selected bitstrings,
+///     normalized to 1.
+/// @param[in] filter_function Callable which returns a boolean indicating whether a
+///     is to be kept.
+///
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+/// @tparam CallableType Type of `filter_function`, compatible with
+///     `bool (*f)(const BitstringType &)`.
+template <
+    typename BitstringVectorType, typename WeightVectorType, typename CallableType>
+void postselect_bitstrings_inplace(
+    BitstringVectorType &bitstrings, WeightVectorType &weights,
+    CallableType filter_function
+)
 {
     if (bitstrings.size() != weights.size()) {
         QKA_SQD_THROW_INVALID_ARGUMENT_(
@@ -113,41 +293,264 @@ std::pair<BitstringVectorType, WeightVectorType> postselect_bitstrings(
         );
     }
 
+    // Filter bitstrings, then move each survivor to its final position
+    const auto filtered_weights_sum = internal::_compact_postselected(
+        postselection_bitmap(bitstrings, filter_function), bitstrings, weights
+    );
+
+    // Normalize weights
+    internal::_normalize_postselected_weights(weights, filtered_weights_sum);
+}
+
+#if __has_include(<boost/dynamic_bitset.hpp>)
+
+/// Compute which packed bitstrings have given right and left Hamming weights
+/// (vectorized version).
+///
+/// The set bits of many bitstrings are counted at once, with SIMD instructions
+/// where the target supports them (see `internal/simd-popcount.hpp`).
+///
+/// @param[in] bitstrings Bitstrings to consider.
+/// @param[in] filter_function Hamming weights to match.
+///
+/// @return Selection bitmap, of `(bitstrings.size() + 63) / 64` words, whose bit
+///     `i % 64` of word `i / 64` is set if `bitstrings[i]` is to be kept.
+template <typename UnsignedType>
+std::vector<std::uint64_t> postselection_bitmap(
+    const PackedBitstringVector &bitstrings,
+    MatchesRightLeftHamming<UnsignedType> filter_function
+)
+{
+    QKA_SQD_IF_UNLIKELY_(!bitstrings.empty() && bitstrings.num_bits() % 2 == 1)
+    {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("`bitstring` must have even length");
+    }
+    std::vector<std::uint64_t> bitmap(internal::words_for_bits(bitstrings.size()));
+    internal::select_right_left_hamming(
+        bitstrings.data(), bitstrings.size(), bitstrings.words_per_bitstring(),
+        bitstrings.num_bits(), filter_function.get_right_target(),
+        filter_function.get_left_target(), bitmap.data()
+    );
+    return bitmap;
+}
+
+/// Post-select packed bitstrings based on their right and left Hamming weights
+/// (vectorized version).
+///
+/// @param[in] bitstrings Bitstrings to consider.
+/// @param[in] weights Relative weight of each bitstring (need not be normalized to 1).
+/// @param[in] filter_function Hamming weights to match.
+///
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+///
+/// @return Post-selected bitstrings and their corresponding weights, normalized to 1.
+template <typename WeightVectorType, typename UnsignedType>
+std::pair<PackedBitstringVector, WeightVectorType> postselect_bitstrings(
+    const PackedBitstringVector &bitstrings, const WeightVectorType &weights,
+    MatchesRightLeftHamming<UnsignedType> filter_function
+)
+{
+    if (bitstrings.size() != weights.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "`weights` must be same length as `bitstrings`"
+        );
+    }
+    const auto bitmap = postselection_bitmap(bitstrings, filter_function);
+    std::size_t num_filtered = 0;
+    for (const auto word : bitmap) {
+        num_filtered += internal::popcount64(word);
+    }
+
     // Filter bitstrings
-    BitstringVectorType filtered_bitstrings;
+    PackedBitstringVector filtered_bitstrings(bitstrings.num_bits());
     WeightVectorType filtered_weights;
-    auto current_bitstring = bitstrings.begin();
-    auto current_weight = weights.begin();
+    filtered_bitstrings.reserve(num_filtered);
+    filtered_weights.reserve(num_filtered);
     typename WeightVectorType::value_type filtered_weights_sum{};
-    while (current_bitstring != bitstrings.end()) {
-        if (filter_function(*current_bitstring)) {
-            if (std::isnan(*current_weight)) {
-                QKA_SQD_THROW_INVALID_ARGUMENT_("NaN found in weight array");
-            }
-            if (std::isinf(*current_weight)) {
-                QKA_SQD_THROW_INVALID_ARGUMENT_("Infinite value found in weight array");
-            }
-            if (*current_weight < 0) {
-                QKA_SQD_THROW_INVALID_ARGUMENT_("Negative value found in weight array");
-            }
-            filtered_bitstrings.push_back(*current_bitstring);
-            filtered_weights.push_back(*current_weight);
-            filtered_weights_sum += *current_weight;
-        }
-        ++current_bitstring;
-        ++current_weight;
-    }
+    internal::for_each_set_bit(bitmap.data(), bitmap.size(), [&](std::size_t i) {
+        internal::_validate_postselected_weight(weights[i]);
+        filtered_bitstrings.push_back(bitstrings[i]);
+        filtered_weights.push_back(weights[i]);
+        filtered_weights_sum += weights[i];
+    });
 
     // Normalize weights
-    if (filtered_weights_sum != 0) {
-        for (auto &weight : filtered_weights) {
-            weight /= filtered_weights_sum;
-        }
+    internal::_normalize_postselected_weights(filtered_weights, filtered_weights_sum);
+
+    return {std::move(filtered_bitstrings), std::move(filtered_weights)};
+}
+
+/// Post-select packed bitstrings based on their right and left Hamming weights
+/// (vectorized in-place version).
+///
+/// @param[in,out] bitstrings Bitstrings to consider.  On return, contains the
+///     post-selected bitstrings.
+/// @param[in,out] weights Relative weight of each bitstring (need not be normalized
+///     to 1).  On return, contains the weights of the post-selected bitstrings,
+///     normalized to 1.
+/// @param[in] filter_function Hamming weights to match.
+///
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+template <typename WeightVectorType, typename UnsignedType>
+void postselect_bitstrings_inplace(
+    PackedBitstringVector &bitstrings, WeightVectorType &weights,
+    MatchesRightLeftHamming<UnsignedType> filter_function
+)
+{
+    if (bitstrings.size() != weights.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "`weights` must be same length as `bitstrings`"
+        );
     }
 
-    return {filtered_bitstrings, filtered_weights};
+    // Filter bitstrings, then move each survivor to its final position
+    const auto filtered_weights_sum = internal::_compact_postselected(
+        postselection_bitmap(bitstrings, filter_function), bitstrings, weights
+    );
+
+    // Normalize weights
+    internal::_normalize_postselected_weights(weights, filtered_weights_sum);
+}
+
+#endif // __has_include(<boost/dynamic_bitset.hpp>)
+
+/// Post-select bitstrings based on a given criteria (version which consumes its
+/// input).
+///
+/// This overload is selected when both `bitstrings` and `weights` are rvalues.  It
+/// post-selects in place (see `postselect_bitstrings_inplace`) and moves the
+/// storage of the input vectors into the result.
+///
+/// @param[in] bitstrings Bitstrings to consider.
+/// @param[in] weights Relative weight of each bitstring (need not be normalized to 1).
+/// @param[in] filter_function Callable which returns a boolean indicating whether a
+///     is to be kept.
+///
+/// @return Post-selected bitstrings and their corresponding weights, normalized to 1.
+template <
+    typename BitstringVectorType, typename WeightVectorType, typename CallableType,
+    std::enable_if_t<
+        !std::is_reference_v<BitstringVectorType> &&
+            !std::is_reference_v<WeightVectorType>,
+        int> = 0>
+std::pair<BitstringVectorType, WeightVectorType> postselect_bitstrings(
+    BitstringVectorType &&bitstrings, WeightVectorType &&weights,
+    CallableType filter_function
+)
+{
+    postselect_bitstrings_inplace(bitstrings, weights, std::move(filter_function));
+    return {std::move(bitstrings), std::move(weights)};
 }
 
+/// Post-selects bitstrings that arrive in chunks, for instance while shots are still
+/// being produced by the sampler.
+///
+/// Each call to `push` filters a chunk and appends its survivors to the internal
+/// buffers, and keeps a running sum of their weights.  The weights are normalized
+/// only once all chunks have been seen, by `finish`.
+///
+/// @tparam BitstringVectorType Type of the post-selected bitstrings, compatible
+///     with `std::vector<boost::dynamic_bitset<>>`.
+/// @tparam WeightVectorType Type of the post-selected weights, compatible with
+///     `std::vector<double>`.
+/// @tparam CallableType Type of the filter function, compatible with
+///     `bool (*f)(const BitstringType &)`.
+///
+/// # Example
+///
+///     Qiskit::addon::sqd::StreamingPostselector<
+///         std::vector<std::bitset<6>>, std::vector<double>,
+///         Qiskit::addon::sqd::MatchesRightLeftHamming<>>
+///         postselector(Qiskit::addon::sqd::MatchesRightLeftHamming(1, 2));
+///     while (sampler_has_more_shots()) {
+///         auto [chunk_bitstrings, chunk_weights] = next_chunk_of_shots();
+///         postselector.push(chunk_bitstrings, chunk_weights);
+///     }
+///     auto [new_bitstrings, new_weights] = postselector.finish();
+template <
+    typename BitstringVectorType, typename WeightVectorType, typename CallableType>
+class StreamingPostselector
+{
+  private:
+    CallableType filter_function;
+    BitstringVectorType filtered_bitstrings;
+    WeightVectorType filtered_weights;
+    typename WeightVectorType::value_type filtered_weights_sum{};
+
+  public:
+    /// Constructor.
+    ///
+    /// @param[in] filter_function Callable which returns a boolean indicating
+    ///     whether a bitstring is to be kept.
+    explicit StreamingPostselector(CallableType filter_function)
+      : filter_function(std::move(filter_function))
+    {
+    }
+
+    /// Post-select one chunk of bitstrings.
+    ///
+    /// @param[in] bitstrings Bitstrings of this chunk.
+    /// @param[in] weights Relative weight of each bitstring of this chunk.
+    ///
+    /// @tparam ChunkBitstringVectorType Type of `bitstrings`, compatible with
+    ///     `BitstringVectorType`.
+    /// @tparam ChunkWeightVectorType Type of `weights`, compatible with
+    ///     `WeightVectorType`.
+    template <typename ChunkBitstringVectorType, typename ChunkWeightVectorType>
+    void push(
+        const ChunkBitstringVectorType &bitstrings, const ChunkWeightVectorType &weights
+    )
+    {
+        filtered_weights_sum += internal::_postselect_append(
+            bitstrings, weights, filter_function, filtered_bitstrings, filtered_weights
+        );
+    }
+
+    /// Post-selected bitstrings so far.
+    const BitstringVectorType &bitstrings() const
+    {
+        return filtered_bitstrings;
+    }
+
+    /// Weights of the post-selected bitstrings so far (not normalized).
+    const WeightVectorType &weights() const
+    {
+        return filtered_weights;
+    }
+
+    /// Running sum of the weights of the post-selected bitstrings.
+    typename WeightVectorType::value_type weights_sum() const
+    {
+        return filtered_weights_sum;
+    }
+
+    /// Number of bitstrings post-selected so far.
+    std::size_t size() const
+    {
+        return filtered_bitstrings.size();
+    }
+
+    /// Normalize the weights and return the post-selected bitstrings.
+    ///
+    /// The post-selector is left empty, ready to accept a new stream.
+    ///
+    /// @return Post-selected bitstrings and their corresponding weights, normalized
+    ///     to 1.
+    std::pair<BitstringVectorType, WeightVectorType> finish()
+    {
+        internal::_normalize_postselected_weights(
+            filtered_weights, filtered_weights_sum
+        );
+        std::pair<BitstringVectorType, WeightVectorType> result{
+            std::move(filtered_bitstrings), std::move(filtered_weights)
+        };
+        filtered_bitstrings = BitstringVectorType();
+        filtered_weights = WeightVectorType();
+        filtered_weights_sum = {};
+        return result;
+    }
+};
+
 } // namespace sqd
 
 } // namespace addon
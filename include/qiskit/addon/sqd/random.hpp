@@ -0,0 +1,488 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_RANDOM_HPP_
+#define QISKIT_ADDON_SQD_RANDOM_HPP_
+
+/// Random number generators with reproducible, independent streams, and
+/// portable distributions
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
+#include "qiskit/addon/sqd/internal/concepts.hpp"
+#include "qiskit/addon/sqd/internal/exception-macros.hpp"
+#include "qiskit/addon/sqd/internal/parallel.hpp"
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+namespace internal
+{
+
+/// Map 64 random bits to a double uniformly distributed on [0, 1), using the
+/// upper 53 bits.
+constexpr double to_unit_interval(std::uint64_t bits)
+{
+    return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+constexpr std::uint64_t rotl64(std::uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+/// Return the high and low words of the 128-bit product of `a` and `b`.
+inline std::array<std::uint64_t, 2> mulhilo64(std::uint64_t a, std::uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ using uint128 = unsigned __int128;
+    const auto product = static_cast<uint128>(a) * b;
+    return {
+        static_cast<std::uint64_t>(product >> 64), static_cast<std::uint64_t>(product)
+    };
+#elif defined(_MSC_VER) && defined(_M_X64)
+    std::uint64_t hi;
+    const std::uint64_t lo = _umul128(a, b, &hi);
+    return {hi, lo};
+#else
+    const std::uint64_t a_lo = a & 0xffffffffULL, a_hi = a >> 32;
+    const std::uint64_t b_lo = b & 0xffffffffULL, b_hi = b >> 32;
+    const std::uint64_t lo_lo = a_lo * b_lo;
+    const std::uint64_t hi_lo = a_hi * b_lo;
+    const std::uint64_t lo_hi = a_lo * b_hi;
+    const std::uint64_t hi_hi = a_hi * b_hi;
+    const std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffULL) + lo_hi;
+    return {
+        hi_hi + (hi_lo >> 32) + (cross >> 32), (cross << 32) | (lo_lo & 0xffffffffULL)
+    };
+#endif
+}
+
+/// The Philox4x64-10 block function of Salmon et al., "Parallel random numbers:
+/// as easy as 1, 2, 3" (SC '11), which maps a 256-bit counter and a 128-bit key
+/// to 256 random bits.
+inline std::array<std::uint64_t, 4>
+philox4x64_10(std::array<std::uint64_t, 4> counter, std::array<std::uint64_t, 2> key)
+{
+    constexpr std::uint64_t multiplier0 = 0xD2E7470EE14C6C93ULL;
+    constexpr std::uint64_t multiplier1 = 0xCA5A826395121157ULL;
+    constexpr std::uint64_t weyl0 = 0x9E3779B97F4A7C15ULL;
+    constexpr std::uint64_t weyl1 = 0xBB67AE8584CAA73BULL;
+    for (int round = 0; round < 10; ++round) {
+        if (round != 0) {
+            key[0] += weyl0;
+            key[1] += weyl1;
+        }
+        const auto [hi0, lo0] = mulhilo64(multiplier0, counter[0]);
+        const auto [hi1, lo1] = mulhilo64(multiplier1, counter[2]);
+        counter = {hi1 ^ counter[1] ^ key[0], lo1, hi0 ^ counter[3] ^ key[1], lo0};
+    }
+    return counter;
+}
+
+/// Number of uniformly distributed bits that `random_bits64` takes from each
+/// output of a generator with outputs in `[0, range]`.
+constexpr int uniform_bits_per_call(std::uint64_t range)
+{
+    // The largest `bits` such that 2^bits - 1 <= range
+    int bits = 0;
+    while (bits < 63 && (std::uint64_t{2} << bits) - 1 <= range) {
+        ++bits;
+    }
+    return bits;
+}
+
+/// Return the index of the first element of the ascending array
+/// `[first, first + n)` which is greater than `target`, or `n` if there is none,
+/// like `std::upper_bound`.  The search takes exactly ceil(log2(n)) + 1
+/// comparisons, which compile to conditional moves rather than branches.
+inline std::size_t
+branchless_upper_bound(const double *first, std::size_t n, double target)
+{
+    if (n == 0) {
+        return 0;
+    }
+    const double *base = first;
+    while (n > 1) {
+        const auto half = n / 2;
+        base = (base[half] <= target) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<std::size_t>(base - first) + (*base <= target);
+}
+
+} // namespace internal
+
+/// Return 64 uniformly distributed random bits from any generator.
+///
+/// Generators whose outputs span all 64 bits, such as `std::mt19937_64`,
+/// `Philox4x64` and `Xoshiro256StarStar`, are called once.  Otherwise, the
+/// outputs are concatenated, most significant first, after discarding any
+/// which fall outside the largest power-of-two range the generator covers.
+/// The result depends only on the generator's outputs, so it is the same with
+/// every standard library.
+template <QKA_SQD_CONCEPT_RNG_(RNGType)>
+std::uint64_t random_bits64(RNGType &rng)
+{
+    constexpr auto range =
+        static_cast<std::uint64_t>(RNGType::max() - RNGType::min());
+    if constexpr (range == ~std::uint64_t{0}) {
+        return static_cast<std::uint64_t>(rng() - RNGType::min());
+    } else {
+        constexpr int bits = internal::uniform_bits_per_call(range);
+        static_assert(bits > 0, "RNGType must produce at least one random bit");
+        constexpr std::uint64_t limit = std::uint64_t{1} << bits;
+        std::uint64_t result = 0;
+        for (int filled = 0; filled < 64; filled += bits) {
+            std::uint64_t value;
+            do {
+                value = static_cast<std::uint64_t>(rng() - RNGType::min());
+            } while (value >= limit);
+            result = (result << bits) | value;
+        }
+        return result;
+    }
+}
+
+/// Return a double uniformly distributed on [0, 1), with 53 random bits.
+///
+/// Unlike `std::uniform_real_distribution` and `std::generate_canonical`, whose
+/// results differ between standard libraries, this gives the same result on
+/// every platform for the same generator state.
+template <QKA_SQD_CONCEPT_RNG_(RNGType)>
+double uniform_double(RNGType &rng)
+{
+    return internal::to_unit_interval(random_bits64(rng));
+}
+
+/// Return an integer uniformly distributed on [0, `bound`), without bias.
+///
+/// This uses the nearly divisionless method of Lemire, "Fast random integer
+/// generation in an interval" (ACM TOMACS, 2019), which takes a single 64-bit
+/// multiplication per draw and only rarely a division.  Like `uniform_double`,
+/// it gives the same result on every platform.
+///
+/// @param[in,out] rng Random number generator.
+/// @param[in] bound Exclusive upper bound.  Must be nonzero.
+template <QKA_SQD_CONCEPT_RNG_(RNGType)>
+std::uint64_t uniform_below(RNGType &rng, std::uint64_t bound)
+{
+    if (bound == 0) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("Bound must be nonzero.");
+    }
+    auto product = internal::mulhilo64(random_bits64(rng), bound);
+    if (product[1] < bound) {
+        // Reject the low products which would make some results more likely
+        const std::uint64_t threshold = (0 - bound) % bound;
+        while (product[1] < threshold) {
+            product = internal::mulhilo64(random_bits64(rng), bound);
+        }
+    }
+    return product[0];
+}
+
+namespace internal
+{
+
+/// Draw an index with probability proportional to its weight, given the
+/// ascending cumulative sums of the weights, `cumulative[0..n)`.
+///
+/// Returns `n` in the rare case that rounding places the target at the total
+/// itself.  Indices whose weight is zero are never returned.
+template <QKA_SQD_CONCEPT_RNG_(RNGType)>
+std::size_t draw_categorical(const double *cumulative, std::size_t n, RNGType &rng)
+{
+    const double target = uniform_double(rng) * cumulative[n - 1];
+    return branchless_upper_bound(cumulative, n, target);
+}
+
+} // namespace internal
+
+/// Counter-based random number generator using the Philox4x64-10 block function.
+///
+/// The stream `(seed, stream_id)` is the sequence of blocks obtained by
+/// encrypting the counters 0, 1, 2, ... with the key `{seed, stream_id}`; each
+/// block yields four 64-bit outputs, in order.  The 2^64 streams of each seed
+/// are therefore independent by construction, and can be created in any order
+/// and at no cost, which makes this generator well suited to giving each task
+/// of a parallel computation its own stream.  The full state is 88 bytes, and
+/// `discard` skips ahead in constant time.
+///
+/// This is the same generator as NumPy's `numpy.random.Philox` with
+/// `key=[seed, stream_id]`, except that NumPy starts from counter 1.
+///
+/// Satisfies `std::uniform_random_bit_generator`.
+class Philox4x64
+{
+  public:
+    using result_type = std::uint64_t;
+
+  private:
+    std::array<std::uint64_t, 2> key;
+    // Counter of the next block to generate; the low 128 bits are used
+    std::array<std::uint64_t, 4> counter{0, 0, 0, 0};
+    std::array<std::uint64_t, 4> buffer{0, 0, 0, 0};
+    // Position of the next output in `buffer`, or 4 if it is used up
+    unsigned int buffer_pos = 4;
+
+    std::array<std::uint64_t, 4> next_block()
+    {
+        const auto block = internal::philox4x64_10(counter, key);
+        if (++counter[0] == 0) {
+            ++counter[1];
+        }
+        return block;
+    }
+
+  public:
+    /// Constructor
+    ///
+    /// @param[in] seed Seed of the generator.
+    /// @param[in] stream_id Index of the stream for the given seed.
+    explicit Philox4x64(std::uint64_t seed = 0, std::uint64_t stream_id = 0)
+      : key{seed, stream_id}
+    {
+    }
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return ~result_type{0};
+    }
+
+    /// Return the next 64 random bits
+    result_type operator()()
+    {
+        if (buffer_pos == 4) {
+            buffer = next_block();
+            buffer_pos = 0;
+        }
+        return buffer[buffer_pos++];
+    }
+
+    /// Advance the generator by `z` outputs, in constant time
+    void discard(unsigned long long z)
+    {
+        const auto buffered = static_cast<unsigned long long>(4 - buffer_pos);
+        if (z <= buffered) {
+            buffer_pos += static_cast<unsigned int>(z);
+            return;
+        }
+        z -= buffered;
+        const std::uint64_t skip_blocks = (z - 1) / 4;
+        counter[0] += skip_blocks;
+        if (counter[0] < skip_blocks) {
+            ++counter[1];
+        }
+        buffer = next_block();
+        buffer_pos = static_cast<unsigned int>((z - 1) % 4 + 1);
+    }
+
+    /// Fill `out` with `count` doubles uniformly distributed on [0, 1).
+    ///
+    /// The result is the same as converting the next `count` outputs of the
+    /// generator in turn, taking the upper 53 bits of each.  Whole blocks are
+    /// written directly, without going through the buffer, and have no
+    /// dependence on one another, so the processor can overlap their
+    /// computation.
+    void fill(double *out, std::size_t count)
+    {
+        for (; count != 0 && buffer_pos != 4; --count) {
+            *out++ = internal::to_unit_interval(buffer[buffer_pos++]);
+        }
+        for (; count >= 4; count -= 4) {
+            const auto block = next_block();
+            for (std::size_t j = 0; j < 4; ++j) {
+                *out++ = internal::to_unit_interval(block[j]);
+            }
+        }
+        for (; count != 0; --count) {
+            *out++ = internal::to_unit_interval((*this)());
+        }
+    }
+
+    friend bool operator==(const Philox4x64 &a, const Philox4x64 &b)
+    {
+        // Only the outputs that remain in the buffer are significant
+        if (a.key != b.key || a.counter != b.counter || a.buffer_pos != b.buffer_pos) {
+            return false;
+        }
+        for (auto i = a.buffer_pos; i < 4; ++i) {
+            if (a.buffer[i] != b.buffer[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const Philox4x64 &a, const Philox4x64 &b)
+    {
+        return !(a == b);
+    }
+};
+
+/// The xoshiro256** generator of Blackman and Vigna, "Scrambled linear
+/// pseudorandom number generators" (ACM TOMS, 2021).
+///
+/// Its state is 32 bytes, and it is among the fastest generators which pass
+/// all common statistical tests, with a period of 2^256 - 1.
+///
+/// The state of the stream `(seed, stream_id)` is four consecutive outputs of
+/// SplitMix64, starting from a seed derived from both (the same derivation
+/// that `ParallelOptions` uses for other generators).  Streams are thus
+/// placed at effectively random, distinct points of the period.  For streams
+/// which are guaranteed not to overlap, call `jump` or `long_jump` on copies of
+/// a single generator instead.
+///
+/// Satisfies `std::uniform_random_bit_generator`.
+class Xoshiro256StarStar
+{
+  public:
+    using result_type = std::uint64_t;
+
+  private:
+    std::array<std::uint64_t, 4> state;
+
+    void apply_jump(const std::array<std::uint64_t, 4> &polynomial)
+    {
+        std::array<std::uint64_t, 4> jumped{0, 0, 0, 0};
+        for (const auto word : polynomial) {
+            for (int b = 0; b < 64; ++b) {
+                if ((word >> b) & 1) {
+                    for (std::size_t i = 0; i < 4; ++i) {
+                        jumped[i] ^= state[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        state = jumped;
+    }
+
+  public:
+    /// Constructor
+    ///
+    /// @param[in] seed Seed of the generator.
+    /// @param[in] stream_id Index of the stream for the given seed.
+    explicit Xoshiro256StarStar(std::uint64_t seed = 0, std::uint64_t stream_id = 0)
+    {
+        auto splitmix_state = internal::derive_stream_seed(seed, stream_id);
+        for (auto &word : state) {
+            word = internal::splitmix64(splitmix_state);
+        }
+    }
+
+    /// Construct the generator with the given state, which must not be all zero.
+    explicit Xoshiro256StarStar(const std::array<std::uint64_t, 4> &state)
+      : state(state)
+    {
+        if ((state[0] | state[1] | state[2] | state[3]) == 0) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_("State must not be all zero.");
+        }
+    }
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return ~result_type{0};
+    }
+
+    /// Return the next 64 random bits
+    result_type operator()()
+    {
+        const auto result = internal::rotl64(state[1] * 5, 7) * 9;
+        const auto t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = internal::rotl64(state[3], 45);
+        return result;
+    }
+
+    /// Advance the generator by `z` outputs
+    void discard(unsigned long long z)
+    {
+        for (; z != 0; --z) {
+            (*this)();
+        }
+    }
+
+    /// Advance the generator by 2^128 outputs.  Up to 2^128 non-overlapping
+    /// streams can be obtained by copying the generator after each jump.
+    void jump()
+    {
+        apply_jump(
+            {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL,
+             0x39abdc4529b1661cULL}
+        );
+    }
+
+    /// Advance the generator by 2^192 outputs
+    void long_jump()
+    {
+        apply_jump(
+            {0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL,
+             0x39109bb02acbe635ULL}
+        );
+    }
+
+    /// Fill `out` with `count` doubles uniformly distributed on [0, 1).
+    ///
+    /// The result is the same as converting the next `count` outputs of the
+    /// generator in turn, taking the upper 53 bits of each.
+    void fill(double *out, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = internal::to_unit_interval((*this)());
+        }
+    }
+
+    friend bool operator==(const Xoshiro256StarStar &a, const Xoshiro256StarStar &b)
+    {
+        return a.state == b.state;
+    }
+
+    friend bool operator!=(const Xoshiro256StarStar &a, const Xoshiro256StarStar &b)
+    {
+        return !(a == b);
+    }
+};
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // QISKIT_ADDON_SQD_RANDOM_HPP_
@@ -0,0 +1,552 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_SHOT_FILE_HPP_
+#define QISKIT_ADDON_SQD_SHOT_FILE_HPP_
+
+/// Binary shot files, which are memory-mapped and read without copying
+/// (requires `boost::dynamic_bitset`)
+
+#include "qiskit/addon/sqd/packed_bitstrings.hpp"
+
+#if __has_include(<boost/dynamic_bitset.hpp>)
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+// Keep <windows.h> from defining `min` and `max` macros, which would break
+// `std::numeric_limits<T>::max()` in any header included after this.  Calls
+// here are parenthesized, in case <windows.h> was included earlier without
+// `NOMINMAX`.
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#define QKA_SQD_UNDEF_NOMINMAX_ 1
+#endif // !defined(NOMINMAX)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#define QKA_SQD_UNDEF_WIN32_LEAN_AND_MEAN_ 1
+#endif // !defined(WIN32_LEAN_AND_MEAN)
+#include <windows.h>
+#if QKA_SQD_UNDEF_NOMINMAX_
+#undef NOMINMAX
+#undef QKA_SQD_UNDEF_NOMINMAX_
+#endif // QKA_SQD_UNDEF_NOMINMAX_
+#if QKA_SQD_UNDEF_WIN32_LEAN_AND_MEAN_
+#undef WIN32_LEAN_AND_MEAN
+#undef QKA_SQD_UNDEF_WIN32_LEAN_AND_MEAN_
+#endif // QKA_SQD_UNDEF_WIN32_LEAN_AND_MEAN_
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // defined(_WIN32)
+
+#include "qiskit/addon/sqd/borrowing_vector.hpp"
+#include "qiskit/addon/sqd/internal/bitset_common.hpp"
+#include "qiskit/addon/sqd/internal/exception-macros.hpp"
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+namespace internal
+{
+
+// Layout of the 64-byte header of a shot file.  All fields are little-endian.
+constexpr char shot_file_magic[8] = {'Q', 'K', 'A', 'S', 'Q', 'D', 'B', 'S'};
+constexpr std::uint32_t shot_file_version = 1;
+constexpr std::size_t shot_file_header_size = 64;
+constexpr std::size_t shot_file_version_offset = 8;
+constexpr std::size_t shot_file_word_bits_offset = 12;
+constexpr std::size_t shot_file_num_orbitals_offset = 16;
+constexpr std::size_t shot_file_num_shots_offset = 24;
+constexpr std::size_t shot_file_weight_dtype_offset = 32;
+constexpr std::size_t shot_file_words_offset_offset = 40;
+constexpr std::size_t shot_file_weights_offset_offset = 48;
+
+// Values of the weight dtype field
+constexpr std::uint32_t shot_file_float64 = 1;
+constexpr std::uint32_t shot_file_float32 = 2;
+
+template <typename T>
+T load_little_endian(const unsigned char *bytes)
+{
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void store_little_endian(unsigned char *bytes, T value)
+{
+    std::memcpy(bytes, &value, sizeof(T));
+}
+
+/// Read-only mapping of a whole file into memory, which is unmapped on
+/// destruction.
+class FileMapping
+{
+  private:
+    const unsigned char *data_ = nullptr;
+    std::size_t size_ = 0;
+#if defined(_WIN32)
+    HANDLE mapping_ = nullptr;
+#endif // defined(_WIN32)
+
+    void unmap()
+    {
+        if (data_ == nullptr) {
+            return;
+        }
+#if defined(_WIN32)
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+#else
+        munmap(const_cast<unsigned char *>(data_), size_);
+#endif // defined(_WIN32)
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+  public:
+    FileMapping() = default;
+
+    explicit FileMapping(const std::string &path)
+    {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(
+            path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL, nullptr
+        );
+        if (file == INVALID_HANDLE_VALUE) {
+            QKA_SQD_THROW_RUNTIME_ERROR_("Cannot open shot file: " + path);
+        }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size)) {
+            CloseHandle(file);
+            QKA_SQD_THROW_RUNTIME_ERROR_("Cannot read size of shot file: " + path);
+        }
+        size_ = static_cast<std::size_t>(file_size.QuadPart);
+        if (size_ == 0) {
+            CloseHandle(file);
+            return;
+        }
+        mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping_ == nullptr) {
+            QKA_SQD_THROW_RUNTIME_ERROR_("Cannot map shot file: " + path);
+        }
+        data_ = static_cast<const unsigned char *>(
+            MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0)
+        );
+        if (data_ == nullptr) {
+            CloseHandle(mapping_);
+            mapping_ = nullptr;
+            QKA_SQD_THROW_RUNTIME_ERROR_("Cannot map shot file: " + path);
+        }
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            QKA_SQD_THROW_RUNTIME_ERROR_("Cannot open shot file: " + path);
+        }
+        struct stat status;
+        if (::fstat(fd, &status) != 0) {
+            ::close(fd);
+            QKA_SQD_THROW_RUNTIME_ERROR_("Cannot read size of shot file: " + path);
+        }
+        size_ = static_cast<std::size_t>(status.st_size);
+        if (size_ == 0) {
+            ::close(fd);
+            return;
+        }
+        void *address = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        // The mapping remains valid after the descriptor is closed
+        ::close(fd);
+        if (address == MAP_FAILED) {
+            size_ = 0;
+            QKA_SQD_THROW_RUNTIME_ERROR_("Cannot map shot file: " + path);
+        }
+        data_ = static_cast<const unsigned char *>(address);
+#endif // defined(_WIN32)
+    }
+
+    FileMapping(const FileMapping &) = delete;
+    FileMapping &operator=(const FileMapping &) = delete;
+
+    FileMapping(FileMapping &&other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0))
+#if defined(_WIN32)
+        ,
+        mapping_(std::exchange(other.mapping_, nullptr))
+#endif // defined(_WIN32)
+    {
+    }
+
+    FileMapping &operator=(FileMapping &&other) noexcept
+    {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+#if defined(_WIN32)
+            mapping_ = std::exchange(other.mapping_, nullptr);
+#endif // defined(_WIN32)
+        }
+        return *this;
+    }
+
+    ~FileMapping()
+    {
+        unmap();
+    }
+
+    const unsigned char *data() const
+    {
+        return data_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+};
+
+/// Return `true` if `count` elements of `element_size` bytes, starting at byte
+/// `offset`, lie within a file of `file_size` bytes.
+inline bool fits_in_file(
+    std::uint64_t offset, std::uint64_t count, std::uint64_t element_size,
+    std::uint64_t file_size
+)
+{
+    if (offset > file_size || count > (file_size - offset) / element_size) {
+        return false;
+    }
+    return true;
+}
+
+} // namespace internal
+
+/// Shots read from a binary shot file, which is mapped into memory rather than
+/// read into it.
+///
+/// A shot file holds a 64-byte header, then the bitstrings as a matrix of 64-bit
+/// words laid out as in a `PackedBitstringVector`, then one weight per shot.
+/// All values are little-endian.  The header holds, at the given byte offsets:
+///
+/// - 0: the magic bytes `QKASQDBS`
+/// - 8: the format version, a `uint32`, currently 1
+/// - 12: the number of bits per word, a `uint32`, currently 64
+/// - 16: the number of orbitals, a `uint64`; each bitstring has twice as many
+///   bits
+/// - 24: the number of shots, a `uint64`
+/// - 32: the type of the weights, a `uint32`: 1 for `float64`, 2 for `float32`
+/// - 40: the byte offset of the word matrix, a `uint64`
+/// - 48: the byte offset of the weights, a `uint64`
+///
+/// Both offsets must be multiples of 8.  The remaining header bytes are
+/// reserved, and are written as zero.
+///
+/// The bitstrings, and weights of type `float64`, are views into the mapped
+/// file, so opening a file which is already in the page cache takes constant
+/// time.  Weights of type `float32` are converted to `double` on opening.  The
+/// views are valid for the lifetime of the `ShotFile`, and should be accessed
+/// through const references: see `BorrowingVector`.  They can be passed
+/// directly to postselection, subsampling and configuration recovery.
+class ShotFile
+{
+  private:
+    internal::FileMapping mapping_;
+    std::uint64_t num_orbitals_ = 0;
+    PackedBitstringVector bitstrings_;
+    BorrowingVector<double> weights_;
+
+  public:
+    /// Map the shot file at `path`.
+    ///
+    /// @param[in] path Path of the shot file
+    ///
+    /// @throws std::runtime_error if the file cannot be mapped, or is not a
+    ///     valid shot file, or if the host is not little-endian.
+    explicit ShotFile(const std::string &path) : mapping_(path)
+    {
+        using internal::load_little_endian;
+        if (!internal::host_is_little_endian()) {
+            QKA_SQD_THROW_RUNTIME_ERROR_("Shot files require a little-endian host");
+        }
+        const auto *bytes = mapping_.data();
+        const auto file_size = static_cast<std::uint64_t>(mapping_.size());
+        if (file_size < internal::shot_file_header_size ||
+            std::memcmp(bytes, internal::shot_file_magic, 8) != 0) {
+            QKA_SQD_THROW_RUNTIME_ERROR_("Not a shot file: " + path);
+        }
+        if (load_little_endian<std::uint32_t>(
+                bytes + internal::shot_file_version_offset
+            ) != internal::shot_file_version) {
+            QKA_SQD_THROW_RUNTIME_ERROR_("Unsupported shot file version: " + path);
+        }
+        if (load_little_endian<std::uint32_t>(
+                bytes + internal::shot_file_word_bits_offset
+            ) != 64) {
+            QKA_SQD_THROW_RUNTIME_ERROR_("Unsupported shot file word width: " + path);
+        }
+        num_orbitals_ = load_little_endian<std::uint64_t>(
+            bytes + internal::shot_file_num_orbitals_offset
+        );
+        const auto num_shots = load_little_endian<std::uint64_t>(
+            bytes + internal::shot_file_num_shots_offset
+        );
+        const auto weight_dtype = load_little_endian<std::uint32_t>(
+            bytes + internal::shot_file_weight_dtype_offset
+        );
+        const auto words_offset = load_little_endian<std::uint64_t>(
+            bytes + internal::shot_file_words_offset_offset
+        );
+        const auto weights_offset = load_little_endian<std::uint64_t>(
+            bytes + internal::shot_file_weights_offset_offset
+        );
+        if (weight_dtype != internal::shot_file_float64 &&
+            weight_dtype != internal::shot_file_float32) {
+            QKA_SQD_THROW_RUNTIME_ERROR_("Unsupported shot file weight type: " + path);
+        }
+        const std::uint64_t weight_size =
+            weight_dtype == internal::shot_file_float64 ? 8 : 4;
+
+        // Validate the extents before computing any pointers
+        if (num_orbitals_ > (std::numeric_limits<std::uint64_t>::max)() / 2 - 63) {
+            QKA_SQD_THROW_RUNTIME_ERROR_("Corrupt shot file header: " + path);
+        }
+        const std::uint64_t words_per_shot = (2 * num_orbitals_ + 63) / 64;
+        const auto max_shots = words_per_shot == 0
+                                   ? (std::numeric_limits<std::uint64_t>::max)()
+                                   : (std::numeric_limits<std::uint64_t>::max)() /
+                                         words_per_shot;
+        if (words_offset % 8 != 0 || weights_offset % 8 != 0 ||
+            words_offset < internal::shot_file_header_size ||
+            weights_offset < internal::shot_file_header_size ||
+            num_shots > max_shots) {
+            QKA_SQD_THROW_RUNTIME_ERROR_("Corrupt shot file header: " + path);
+        }
+        const auto num_words = num_shots * words_per_shot;
+        if (!internal::fits_in_file(words_offset, num_words, 8, file_size) ||
+            !internal::fits_in_file(
+                weights_offset, num_shots, weight_size, file_size
+            )) {
+            QKA_SQD_THROW_RUNTIME_ERROR_("Shot file is truncated: " + path);
+        }
+
+        bitstrings_ = PackedBitstringVector::borrow(
+            reinterpret_cast<const std::uint64_t *>(bytes + words_offset),
+            static_cast<std::size_t>(2 * num_orbitals_),
+            static_cast<std::size_t>(num_shots)
+        );
+        if (weight_dtype == internal::shot_file_float64) {
+            weights_ = BorrowingVector<double>::borrow(
+                reinterpret_cast<const double *>(bytes + weights_offset),
+                static_cast<std::size_t>(num_shots)
+            );
+        } else {
+            const auto *weights =
+                reinterpret_cast<const float *>(bytes + weights_offset);
+            weights_ = BorrowingVector<double>(weights, weights + num_shots);
+        }
+    }
+
+    ShotFile(const ShotFile &) = delete;
+    ShotFile &operator=(const ShotFile &) = delete;
+    // The mapped memory does not move, so the views remain valid
+    ShotFile(ShotFile &&) = default;
+    ShotFile &operator=(ShotFile &&) = default;
+
+    /// Return the number of orbitals
+    std::size_t num_orbitals() const
+    {
+        return static_cast<std::size_t>(num_orbitals_);
+    }
+
+    /// Return the number of shots
+    std::size_t num_shots() const
+    {
+        return bitstrings_.size();
+    }
+
+    /// Return the bitstrings, which borrow the mapped file
+    const PackedBitstringVector &bitstrings() const
+    {
+        return bitstrings_;
+    }
+
+    /// Return the weights, which borrow the mapped file if they are stored as
+    /// `float64`
+    const BorrowingVector<double> &weights() const
+    {
+        return weights_;
+    }
+};
+
+/// Write shots to a binary shot file, as read by `ShotFile`.
+///
+/// The weights are written as `float64`.
+///
+/// @param[in] path Path of the shot file, which is overwritten if it exists
+/// @param[in] bitstrings Bitstrings, all of the same even length
+/// @param[in] weights One weight per bitstring
+///
+/// @throws std::invalid_argument if the bitstrings do not all have the same
+///     even length, or if there is not one weight per bitstring.
+/// @throws std::runtime_error if the file cannot be written.
+template <typename BitstringVectorType, typename WeightVectorType>
+void write_shot_file(
+    const std::string &path, const BitstringVectorType &bitstrings,
+    const WeightVectorType &weights
+)
+{
+    using internal::store_little_endian;
+    if (!internal::host_is_little_endian()) {
+        QKA_SQD_THROW_RUNTIME_ERROR_("Shot files require a little-endian host");
+    }
+    if (bitstrings.size() != weights.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "There must be exactly one weight per bitstring"
+        );
+    }
+    using BitstringType = std::decay_t<decltype(*std::begin(bitstrings))>;
+    std::size_t num_bits;
+    if constexpr (std::is_same_v<BitstringVectorType, PackedBitstringVector>) {
+        num_bits = bitstrings.num_bits();
+    } else if (!bitstrings.empty()) {
+        num_bits = internal::bitstring_size(*std::begin(bitstrings));
+    } else {
+        num_bits = internal::FixedSizeImpl<BitstringType>::value;
+    }
+    if (num_bits % 2 != 0) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_("Bitstrings must have an even length");
+    }
+    // Check every length before the file is opened, so that invalid input does
+    // not leave a partly written file behind
+    if constexpr (!std::is_same_v<BitstringVectorType, PackedBitstringVector>) {
+        for (const auto &bitstring : bitstrings) {
+            if (internal::bitstring_size(bitstring) != num_bits) {
+                QKA_SQD_THROW_INVALID_ARGUMENT_(
+                    "All bitstrings must have the same length"
+                );
+            }
+        }
+    }
+    const auto words_per_shot = internal::words_for_bits(num_bits);
+    const std::uint64_t num_shots = bitstrings.size();
+    const std::uint64_t words_offset = internal::shot_file_header_size;
+    const std::uint64_t weights_offset = words_offset + 8 * num_shots * words_per_shot;
+
+    unsigned char header[internal::shot_file_header_size] = {};
+    std::memcpy(header, internal::shot_file_magic, 8);
+    store_little_endian(
+        header + internal::shot_file_version_offset, internal::shot_file_version
+    );
+    store_little_endian(
+        header + internal::shot_file_word_bits_offset, std::uint32_t{64}
+    );
+    store_little_endian(
+        header + internal::shot_file_num_orbitals_offset,
+        static_cast<std::uint64_t>(num_bits / 2)
+    );
+    store_little_endian(header + internal::shot_file_num_shots_offset, num_shots);
+    store_little_endian(
+        header + internal::shot_file_weight_dtype_offset, internal::shot_file_float64
+    );
+    store_little_endian(header + internal::shot_file_words_offset_offset, words_offset);
+    store_little_endian(
+        header + internal::shot_file_weights_offset_offset, weights_offset
+    );
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        QKA_SQD_THROW_RUNTIME_ERROR_("Cannot open shot file for writing: " + path);
+    }
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+    // Write the words, and then the weights, in chunks of this many shots
+    constexpr std::size_t chunk_size = 4096;
+    if constexpr (std::is_same_v<BitstringVectorType, PackedBitstringVector>) {
+        out.write(
+            reinterpret_cast<const char *>(bitstrings.data()),
+            static_cast<std::streamsize>(8 * num_shots * words_per_shot)
+        );
+    } else {
+        std::vector<std::uint64_t> words;
+        words.reserve(chunk_size * words_per_shot);
+        for (const auto &bitstring : bitstrings) {
+            words.resize(words.size() + words_per_shot);
+            internal::WordsImpl<BitstringType>::copy(
+                bitstring, words.data() + words.size() - words_per_shot
+            );
+            if (words.size() == chunk_size * words_per_shot) {
+                out.write(
+                    reinterpret_cast<const char *>(words.data()),
+                    static_cast<std::streamsize>(8 * words.size())
+                );
+                words.clear();
+            }
+        }
+        out.write(
+            reinterpret_cast<const char *>(words.data()),
+            static_cast<std::streamsize>(8 * words.size())
+        );
+    }
+
+    std::vector<double> chunk;
+    chunk.reserve(chunk_size);
+    for (const auto &weight : weights) {
+        chunk.push_back(static_cast<double>(weight));
+        if (chunk.size() == chunk_size) {
+            out.write(
+                reinterpret_cast<const char *>(chunk.data()),
+                static_cast<std::streamsize>(8 * chunk.size())
+            );
+            chunk.clear();
+        }
+    }
+    out.write(
+        reinterpret_cast<const char *>(chunk.data()),
+        static_cast<std::streamsize>(8 * chunk.size())
+    );
+
+    out.close();
+    if (!out) {
+        QKA_SQD_THROW_RUNTIME_ERROR_("Cannot write shot file: " + path);
+    }
+}
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // __has_include(<boost/dynamic_bitset.hpp>)
+
+#endif // QISKIT_ADDON_SQD_SHOT_FILE_HPP_
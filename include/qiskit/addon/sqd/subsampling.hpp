@@ -17,12 +17,16 @@
 
 #include <cmath>
 #include <cstddef>
+#include <limits>
+#include <optional>
 #include <random>
 #include <stdexcept>
+#include <variant>
 #include <vector>
 
 #include "qiskit/addon/sqd/internal/concepts.hpp"
 #include "qiskit/addon/sqd/internal/exception-macros.hpp"
+#include "qiskit/addon/sqd/internal/parallel.hpp"
 #include "qiskit/addon/sqd/internal/sample-without-replacement.hpp"
 
 namespace Qiskit
@@ -34,13 +38,216 @@ namespace addon
 namespace sqd
 {
 
+/// Reusable sampler for drawing many batches from the same population.
+///
+/// The weights are validated and preprocessed once, upon construction.  After
+/// each batch is drawn, only the indices drawn for that batch are returned to
+/// the population, so the cost of drawing a batch does not include the O(N)
+/// setup of a fresh sampler (except with `SamplingMethod::exponential_keys`,
+/// which must generate new keys for each batch).
+///
+/// When using `SamplingMethod::exponential_keys`, `weights` must outlive the
+/// `Subsampler`.
+///
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+template <typename WeightVectorType>
+class Subsampler
+{
+  private:
+    using SamplerVariant = std::variant<
+        internal::NoReplacementSampler<WeightVectorType>,
+        internal::FenwickTreeSampler<WeightVectorType>,
+        internal::ExponentialKeySampler<WeightVectorType>>;
+    SamplerVariant sampler;
+    std::size_t population_size;
+    std::size_t nonzero_weights;
+
+    static SamplerVariant
+    make_sampler(const WeightVectorType &weights, SamplingMethod sampling_method)
+    {
+        switch (sampling_method) {
+        case SamplingMethod::fenwick_tree:
+            return SamplerVariant(std::in_place_index<1>, weights);
+        case SamplingMethod::exponential_keys:
+            return SamplerVariant(std::in_place_index<2>, weights);
+        case SamplingMethod::rejection:
+        default:
+            return SamplerVariant(std::in_place_index<0>, weights);
+        }
+    }
+
+  public:
+    /// Constructor
+    ///
+    /// @param[in] weights Relative weight of each member of the population (need
+    ///     not be normalized to 1).  Must contain only non-negative values.
+    /// @param[in] sampling_method Algorithm to use for sampling without replacement.
+    explicit Subsampler(
+        const WeightVectorType &weights,
+        SamplingMethod sampling_method = SamplingMethod::rejection
+    )
+      : sampler(make_sampler(weights, sampling_method)),
+        population_size(weights.size()),
+        nonzero_weights(std::visit(
+            [](const auto &s) {
+                return s.get_remaining_nonzero_weights();
+            },
+            sampler
+        ))
+    {
+    }
+
+    /// Return the number of members of the population
+    std::size_t size() const
+    {
+        return population_size;
+    }
+
+    /// Return the number of members of the population with nonzero weight
+    std::size_t get_nonzero_weights() const
+    {
+        return nonzero_weights;
+    }
+
+    /// Draw a single batch of bitstrings
+    ///
+    /// @param[out] batch This will be cleared and overwritten with the subsampled
+    ///     bitstrings.
+    /// @param[in] bitstrings Population of bitstrings.  Must be the same length as
+    ///     the weights passed to the constructor.
+    /// @param[in] samples_per_batch Number of samples to return in \p batch.
+    ///     Cannot be greater than the number of bitstrings with nonzero weight.
+    /// @param[in,out] rng Random number generator to use for sampling.
+    ///
+    /// @tparam BatchVectorType Type of `batch`, must be compatible with
+    ///     `std::vector<boost::dynamic_bitset<>>`.
+    /// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+    ///     `std::vector<boost::dynamic_bitset<>>`.
+    /// @tparam RNGType Type of random number generator.
+    template <
+        typename BatchVectorType, typename BitstringVectorType,
+        QKA_SQD_CONCEPT_RNG_(RNGType)>
+    void operator()(
+        BatchVectorType &batch, const BitstringVectorType &bitstrings,
+        unsigned int samples_per_batch, RNGType &rng
+    )
+    {
+        if (bitstrings.size() != population_size) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Weights vector must match the number of bitstrings"
+            );
+        }
+        check_samples_per_batch(samples_per_batch);
+
+        batch.clear();
+        batch.reserve(samples_per_batch);
+        draw(samples_per_batch, rng, [&](std::size_t idx) {
+            batch.push_back(bitstrings[idx]);
+        });
+    }
+
+    /// Draw a single batch of indices into the population
+    ///
+    /// @param[out] indices This will be cleared and overwritten with the indices of
+    ///     the subsampled members of the population.
+    /// @param[in] samples_per_batch Number of samples to return in \p indices.
+    ///     Cannot be greater than the number of members with nonzero weight.
+    /// @param[in,out] rng Random number generator to use for sampling.
+    ///
+    /// @tparam IndexVectorType Type of `indices`, must be compatible with
+    ///     `std::vector<std::size_t>` or `std::vector<std::uint32_t>`.
+    /// @tparam RNGType Type of random number generator.
+    template <typename IndexVectorType, QKA_SQD_CONCEPT_RNG_(RNGType)>
+    void sample_indices(
+        IndexVectorType &indices, unsigned int samples_per_batch, RNGType &rng
+    )
+    {
+        using IndexType = typename IndexVectorType::value_type;
+        if (population_size != 0 &&
+            population_size - 1 > std::numeric_limits<IndexType>::max()) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Index type is too narrow to address the population"
+            );
+        }
+        check_samples_per_batch(samples_per_batch);
+
+        indices.clear();
+        indices.reserve(samples_per_batch);
+        draw(samples_per_batch, rng, [&](std::size_t idx) {
+            indices.push_back(static_cast<IndexType>(idx));
+        });
+    }
+
+  private:
+    void check_samples_per_batch(unsigned int samples_per_batch) const
+    {
+        // This test is technically covered below, but we might as well bail early,
+        // with a more accurate error message, if it is true.
+        if (samples_per_batch > population_size) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Cannot draw more samples than number of bitstrings"
+            );
+        }
+        if (samples_per_batch > nonzero_weights) {
+            QKA_SQD_THROW_INVALID_ARGUMENT_(
+                "Cannot draw more samples than number of "
+                "bitstrings with nonzero weight"
+            );
+        }
+    }
+
+    template <typename RNGType, typename FunctionType>
+    void draw(unsigned int samples_per_batch, RNGType &rng, FunctionType &&func)
+    {
+        std::visit(
+            [&](auto &s) {
+                for (unsigned int i = 0; i < samples_per_batch; ++i) {
+                    func(s(rng));
+                }
+                s.reset();
+            },
+            sampler
+        );
+    }
+};
+
+namespace internal
+{
+
+// Call `func(sampler, i, rng)` for each batch index `i`, with a per-thread
+// `Subsampler` and the random number generator for stream `i`.
+template <typename RNGType, typename WeightVectorType, typename FunctionType>
+void _subsample_batches_in_parallel(
+    const WeightVectorType &weights, unsigned int num_batches,
+    ParallelOptions parallel_options, SamplingMethod sampling_method,
+    FunctionType &&func
+)
+{
+    const auto num_threads =
+        resolve_num_threads(parallel_options.num_threads, num_batches);
+    // Each thread validates and preprocesses the weights once
+    std::vector<std::optional<Subsampler<WeightVectorType>>> thread_samplers(
+        num_threads
+    );
+    parallel_for(num_batches, num_threads, [&](std::size_t i, unsigned int thread) {
+        auto &sampler = thread_samplers[thread];
+        if (!sampler) {
+            sampler.emplace(weights, sampling_method);
+        }
+        auto rng = make_stream_rng<RNGType>(parallel_options.seed, i);
+        func(*sampler, i, rng);
+    });
+}
+
+} // namespace internal
+
 /// Subsample a single batch of bitstrings (mutating version)
 ///
 /// This version can be useful if you want to avoid reallocation by re-using an
 /// existing batch vector.
 ///
-/// Note: You must de-duplicate the bitstrings before calling this, otherwise
-/// you may get duplicate bitstrings in the output.
+/// Note: You must de-duplicate the bitstrings (see `deduplicate_bitstrings`)
+/// before calling this, otherwise you may get duplicate bitstrings in the output.
 ///
 /// @param[out] batch This will be cleared and overwritten with the subsampled
 ///     bitstrings.
@@ -50,6 +257,7 @@ namespace sqd
 /// @param[in] samples_per_batch Number of samples to return in \p batch.
 ///     Cannot be greater than the number of bitstrings.
 /// @param[in,out] rng Random number generator to use for sampling.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
 ///
 /// @tparam BatchVectorType Type of `batch`, must be compatible with
 ///     `std::vector<boost::dynamic_bitset<>>`.
@@ -62,7 +270,8 @@ template <
     QKA_SQD_CONCEPT_RNG_(RNGType)>
 void subsample(
     BatchVectorType &batch, const BitstringVectorType &bitstrings,
-    const WeightVectorType &weights, unsigned int samples_per_batch, RNGType &rng
+    const WeightVectorType &weights, unsigned int samples_per_batch, RNGType &rng,
+    SamplingMethod sampling_method = SamplingMethod::rejection
 )
 {
     if (bitstrings.size() != weights.size()) {
@@ -78,27 +287,14 @@ void subsample(
         );
     }
 
-    internal::NoReplacementSampler sampler(weights);
-    if (samples_per_batch > sampler.get_remaining_nonzero_weights()) {
-        QKA_SQD_THROW_INVALID_ARGUMENT_(
-            "Cannot draw more samples than number of "
-            "bitstrings with nonzero weight"
-        );
-    }
-
-    batch.clear();
-    batch.reserve(samples_per_batch);
-
-    while (batch.size() < samples_per_batch) {
-        const auto idx = sampler(rng);
-        batch.push_back(bitstrings[idx]);
-    }
+    Subsampler<WeightVectorType> sampler(weights, sampling_method);
+    sampler(batch, bitstrings, samples_per_batch, rng);
 }
 
 /// Subsample a single batch of bitstrings
 ///
-/// Note: You must de-duplicate the bitstrings before calling this, otherwise
-/// you may get duplicate bitstrings in the output.
+/// Note: You must de-duplicate the bitstrings (see `deduplicate_bitstrings`)
+/// before calling this, otherwise you may get duplicate bitstrings in the output.
 ///
 /// @param[in] bitstrings Population of bitstrings.
 /// @param[in] weights Relative weight of each bitstring (need not be normalized to 1).
@@ -106,6 +302,7 @@ void subsample(
 /// @param[in] samples_per_batch Number of samples to return in \p batch.
 ///     Cannot be greater than the number of bitstrings.
 /// @param[in,out] rng Random number generator to use for sampling.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
 ///
 /// @tparam BitstringVectorType Type of `bitstrings`, compatible with
 ///     `std::vector<boost::dynamic_bitset<>>`.
@@ -118,11 +315,12 @@ template <
     QKA_SQD_CONCEPT_RNG_(RNGType)>
 BitstringVectorType subsample(
     const BitstringVectorType &bitstrings, const WeightVectorType &weights,
-    unsigned int samples_per_batch, RNGType &rng
+    unsigned int samples_per_batch, RNGType &rng,
+    SamplingMethod sampling_method = SamplingMethod::rejection
 )
 {
     BitstringVectorType batch;
-    subsample(batch, bitstrings, weights, samples_per_batch, rng);
+    subsample(batch, bitstrings, weights, samples_per_batch, rng, sampling_method);
     return batch;
 }
 
@@ -131,8 +329,8 @@ BitstringVectorType subsample(
 /// This version can be useful if you want to avoid reallocation by re-using
 /// existing batch vectors.
 ///
-/// Note: You must de-duplicate the bitstrings before calling this, otherwise
-/// you may get duplicate bitstrings in the output.
+/// Note: You must de-duplicate the bitstrings (see `deduplicate_bitstrings`)
+/// before calling this, otherwise you may get duplicate bitstrings in the output.
 ///
 /// @param[out] batches This will be overwritten with the batches of subsampled
 ///     bitstrings.
@@ -143,6 +341,7 @@ BitstringVectorType subsample(
 ///     Cannot be greater than the number of bitstrings.
 /// @param[in] num_batches Number of batches.
 /// @param[in,out] rng Random number generator to use for sampling.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
 ///
 /// @tparam BatchesVectorType Type of `batches`, must be compatible with
 ///     `std::vector<std::vector<boost::dynamic_bitset<>>>`.
@@ -157,19 +356,33 @@ template <
 void subsample_multiple_batches(
     BatchesVectorType &batches, const BitstringVectorType &bitstrings,
     const WeightVectorType &weights, unsigned int samples_per_batch,
-    unsigned int num_batches, RNGType &rng
+    unsigned int num_batches, RNGType &rng,
+    SamplingMethod sampling_method = SamplingMethod::rejection
 )
 {
+    if (bitstrings.size() != weights.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Weights vector must match the number of bitstrings"
+        );
+    }
+    if (samples_per_batch > bitstrings.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Cannot draw more samples than number of bitstrings"
+        );
+    }
+
+    // Validate and preprocess the weights only once for all batches
+    Subsampler<WeightVectorType> sampler(weights, sampling_method);
     batches.resize(num_batches);
     for (decltype(num_batches) i = 0; i < num_batches; ++i) {
-        subsample(batches[i], bitstrings, weights, samples_per_batch, rng);
+        sampler(batches[i], bitstrings, samples_per_batch, rng);
     }
 }
 
 /// Subsample multiple batches of bitstrings
 ///
-/// Note: You must de-duplicate the bitstrings before calling this, otherwise
-/// you may get duplicate bitstrings in the output.
+/// Note: You must de-duplicate the bitstrings (see `deduplicate_bitstrings`)
+/// before calling this, otherwise you may get duplicate bitstrings in the output.
 ///
 /// @param[in] bitstrings Population of bitstrings.
 /// @param[in] weights Relative weight of each bitstring (need not be normalized to 1).
@@ -178,6 +391,7 @@ void subsample_multiple_batches(
 ///     Cannot be greater than the number of bitstrings.
 /// @param[in] num_batches Number of batches.
 /// @param[in,out] rng Random number generator to use for sampling.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
 ///
 /// @tparam BitstringVectorType Type of `bitstrings`, compatible with
 ///     `std::vector<boost::dynamic_bitset<>>`.
@@ -190,12 +404,336 @@ template <
     QKA_SQD_CONCEPT_RNG_(RNGType)>
 std::vector<BitstringVectorType> subsample_multiple_batches(
     const BitstringVectorType &bitstrings, const WeightVectorType &weights,
-    unsigned int samples_per_batch, unsigned int num_batches, RNGType &rng
+    unsigned int samples_per_batch, unsigned int num_batches, RNGType &rng,
+    SamplingMethod sampling_method = SamplingMethod::rejection
 )
 {
     std::vector<BitstringVectorType> batches;
     subsample_multiple_batches(
-        batches, bitstrings, weights, samples_per_batch, num_batches, rng
+        batches, bitstrings, weights, samples_per_batch, num_batches, rng,
+        sampling_method
+    );
+    return batches;
+}
+
+/// Subsample multiple batches of bitstrings using multiple threads (mutating
+/// version)
+///
+/// Batch `i` is drawn using a random number generator seeded with a value
+/// derived from `parallel_options.seed` and `i`, so the output is reproducible
+/// for a given seed regardless of the number of threads used.  The
+/// `parallel_options.shard_size` is not used, as each batch is its own shard.
+///
+/// Note: You must de-duplicate the bitstrings (see `deduplicate_bitstrings`)
+/// before calling this, otherwise you may get duplicate bitstrings in the output.
+///
+/// @param[out] batches This will be overwritten with the batches of subsampled
+///     bitstrings.
+/// @param[in] bitstrings Population of bitstrings.
+/// @param[in] weights Relative weight of each bitstring (need not be normalized to 1).
+///     Must be the same length as \p bitstrings and contain only non-negative values.
+/// @param[in] samples_per_batch Number of samples to return per batch.
+///     Cannot be greater than the number of bitstrings.
+/// @param[in] num_batches Number of batches.
+/// @param[in] parallel_options Seed and number of threads.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
+///
+/// @tparam RNGType Type of random number generator used for each batch.  Must be
+///     constructible from a single seed value.
+/// @tparam BatchesVectorType Type of `batches`, must be compatible with
+///     `std::vector<std::vector<boost::dynamic_bitset<>>>`.
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+template <
+    QKA_SQD_CONCEPT_RNG_(RNGType) = std::mt19937_64, typename BatchesVectorType,
+    typename BitstringVectorType, typename WeightVectorType>
+void subsample_multiple_batches(
+    BatchesVectorType &batches, const BitstringVectorType &bitstrings,
+    const WeightVectorType &weights, unsigned int samples_per_batch,
+    unsigned int num_batches, ParallelOptions parallel_options,
+    SamplingMethod sampling_method = SamplingMethod::rejection
+)
+{
+    if (bitstrings.size() != weights.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Weights vector must match the number of bitstrings"
+        );
+    }
+    if (samples_per_batch > bitstrings.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Cannot draw more samples than number of bitstrings"
+        );
+    }
+
+    batches.resize(num_batches);
+    internal::_subsample_batches_in_parallel<RNGType>(
+        weights, num_batches, parallel_options, sampling_method,
+        [&](auto &sampler, std::size_t i, auto &rng) {
+            sampler(batches[i], bitstrings, samples_per_batch, rng);
+        }
+    );
+}
+
+/// Subsample multiple batches of bitstrings using multiple threads
+///
+/// Batch `i` is drawn using a random number generator seeded with a value
+/// derived from `parallel_options.seed` and `i`, so the output is reproducible
+/// for a given seed regardless of the number of threads used.  The
+/// `parallel_options.shard_size` is not used, as each batch is its own shard.
+///
+/// Note: You must de-duplicate the bitstrings (see `deduplicate_bitstrings`)
+/// before calling this, otherwise you may get duplicate bitstrings in the output.
+///
+/// @param[in] bitstrings Population of bitstrings.
+/// @param[in] weights Relative weight of each bitstring (need not be normalized to 1).
+///     Must be the same length as \p bitstrings and contain only non-negative values.
+/// @param[in] samples_per_batch Number of samples to return per batch.
+///     Cannot be greater than the number of bitstrings.
+/// @param[in] num_batches Number of batches.
+/// @param[in] parallel_options Seed and number of threads.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
+///
+/// @tparam RNGType Type of random number generator used for each batch.  Must be
+///     constructible from a single seed value.
+/// @tparam BitstringVectorType Type of `bitstrings`, compatible with
+///     `std::vector<boost::dynamic_bitset<>>`.
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+///
+/// @return The batches of subsampled bitstrings.
+template <
+    QKA_SQD_CONCEPT_RNG_(RNGType) = std::mt19937_64, typename BitstringVectorType,
+    typename WeightVectorType>
+std::vector<BitstringVectorType> subsample_multiple_batches(
+    const BitstringVectorType &bitstrings, const WeightVectorType &weights,
+    unsigned int samples_per_batch, unsigned int num_batches,
+    ParallelOptions parallel_options,
+    SamplingMethod sampling_method = SamplingMethod::rejection
+)
+{
+    std::vector<BitstringVectorType> batches;
+    subsample_multiple_batches<RNGType>(
+        batches, bitstrings, weights, samples_per_batch, num_batches,
+        parallel_options, sampling_method
+    );
+    return batches;
+}
+
+/// Subsample a single batch of indices into a population (mutating version)
+///
+/// This is equivalent to `subsample`, except that it returns the indices of the
+/// subsampled members of the population rather than copies of them.
+///
+/// @param[out] indices This will be cleared and overwritten with the subsampled
+///     indices.
+/// @param[in] weights Relative weight of each member of the population (need not be
+///     normalized to 1).  Must contain only non-negative values.
+/// @param[in] samples_per_batch Number of samples to return in \p indices.
+///     Cannot be greater than the size of the population.
+/// @param[in,out] rng Random number generator to use for sampling.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
+///
+/// @tparam IndexVectorType Type of `indices`, must be compatible with
+///     `std::vector<std::size_t>` or `std::vector<std::uint32_t>`.
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+/// @tparam RNGType Type of random number generator.
+template <
+    typename IndexVectorType, typename WeightVectorType, QKA_SQD_CONCEPT_RNG_(RNGType)>
+void subsample_indices(
+    IndexVectorType &indices, const WeightVectorType &weights,
+    unsigned int samples_per_batch, RNGType &rng,
+    SamplingMethod sampling_method = SamplingMethod::rejection
+)
+{
+    if (samples_per_batch > weights.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Cannot draw more samples than number of bitstrings"
+        );
+    }
+
+    Subsampler<WeightVectorType> sampler(weights, sampling_method);
+    sampler.sample_indices(indices, samples_per_batch, rng);
+}
+
+/// Subsample a single batch of indices into a population
+///
+/// This is equivalent to `subsample`, except that it returns the indices of the
+/// subsampled members of the population rather than copies of them.
+///
+/// @param[in] weights Relative weight of each member of the population (need not be
+///     normalized to 1).  Must contain only non-negative values.
+/// @param[in] samples_per_batch Number of samples to return.
+///     Cannot be greater than the size of the population.
+/// @param[in,out] rng Random number generator to use for sampling.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
+///
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+/// @tparam RNGType Type of random number generator.
+///
+/// @return The subsampled indices.
+template <typename WeightVectorType, QKA_SQD_CONCEPT_RNG_(RNGType)>
+std::vector<std::size_t> subsample_indices(
+    const WeightVectorType &weights, unsigned int samples_per_batch, RNGType &rng,
+    SamplingMethod sampling_method = SamplingMethod::rejection
+)
+{
+    std::vector<std::size_t> indices;
+    subsample_indices(indices, weights, samples_per_batch, rng, sampling_method);
+    return indices;
+}
+
+/// Subsample multiple batches of indices into a population (mutating version)
+///
+/// This is equivalent to `subsample_multiple_batches`, except that it returns the
+/// indices of the subsampled members of the population rather than copies of
+/// them.
+///
+/// @param[out] batches This will be overwritten with the batches of subsampled
+///     indices.
+/// @param[in] weights Relative weight of each member of the population (need not be
+///     normalized to 1).  Must contain only non-negative values.
+/// @param[in] samples_per_batch Number of samples to return per batch.
+///     Cannot be greater than the size of the population.
+/// @param[in] num_batches Number of batches.
+/// @param[in,out] rng Random number generator to use for sampling.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
+///
+/// @tparam IndexBatchesVectorType Type of `batches`, must be compatible with
+///     `std::vector<std::vector<std::size_t>>`.
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+/// @tparam RNGType Type of random number generator.
+template <
+    typename IndexBatchesVectorType, typename WeightVectorType,
+    QKA_SQD_CONCEPT_RNG_(RNGType)>
+void subsample_multiple_batches_indices(
+    IndexBatchesVectorType &batches, const WeightVectorType &weights,
+    unsigned int samples_per_batch, unsigned int num_batches, RNGType &rng,
+    SamplingMethod sampling_method = SamplingMethod::rejection
+)
+{
+    if (samples_per_batch > weights.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Cannot draw more samples than number of bitstrings"
+        );
+    }
+
+    // Validate and preprocess the weights only once for all batches
+    Subsampler<WeightVectorType> sampler(weights, sampling_method);
+    batches.resize(num_batches);
+    for (decltype(num_batches) i = 0; i < num_batches; ++i) {
+        sampler.sample_indices(batches[i], samples_per_batch, rng);
+    }
+}
+
+/// Subsample multiple batches of indices into a population
+///
+/// This is equivalent to `subsample_multiple_batches`, except that it returns the
+/// indices of the subsampled members of the population rather than copies of
+/// them.
+///
+/// @param[in] weights Relative weight of each member of the population (need not be
+///     normalized to 1).  Must contain only non-negative values.
+/// @param[in] samples_per_batch Number of samples to return per batch.
+///     Cannot be greater than the size of the population.
+/// @param[in] num_batches Number of batches.
+/// @param[in,out] rng Random number generator to use for sampling.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
+///
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+/// @tparam RNGType Type of random number generator.
+///
+/// @return The batches of subsampled indices.
+template <typename WeightVectorType, QKA_SQD_CONCEPT_RNG_(RNGType)>
+std::vector<std::vector<std::size_t>> subsample_multiple_batches_indices(
+    const WeightVectorType &weights, unsigned int samples_per_batch,
+    unsigned int num_batches, RNGType &rng,
+    SamplingMethod sampling_method = SamplingMethod::rejection
+)
+{
+    std::vector<std::vector<std::size_t>> batches;
+    subsample_multiple_batches_indices(
+        batches, weights, samples_per_batch, num_batches, rng, sampling_method
+    );
+    return batches;
+}
+
+/// Subsample multiple batches of indices into a population using multiple threads
+/// (mutating version)
+///
+/// This is equivalent to the multithreaded `subsample_multiple_batches`, except
+/// that it returns the indices of the subsampled members of the population rather
+/// than copies of them.
+///
+/// @param[out] batches This will be overwritten with the batches of subsampled
+///     indices.
+/// @param[in] weights Relative weight of each member of the population (need not be
+///     normalized to 1).  Must contain only non-negative values.
+/// @param[in] samples_per_batch Number of samples to return per batch.
+///     Cannot be greater than the size of the population.
+/// @param[in] num_batches Number of batches.
+/// @param[in] parallel_options Seed and number of threads.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
+///
+/// @tparam RNGType Type of random number generator used for each batch.  Must be
+///     constructible from a single seed value.
+/// @tparam IndexBatchesVectorType Type of `batches`, must be compatible with
+///     `std::vector<std::vector<std::size_t>>`.
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+template <
+    QKA_SQD_CONCEPT_RNG_(RNGType) = std::mt19937_64, typename IndexBatchesVectorType,
+    typename WeightVectorType>
+void subsample_multiple_batches_indices(
+    IndexBatchesVectorType &batches, const WeightVectorType &weights,
+    unsigned int samples_per_batch, unsigned int num_batches,
+    ParallelOptions parallel_options,
+    SamplingMethod sampling_method = SamplingMethod::rejection
+)
+{
+    if (samples_per_batch > weights.size()) {
+        QKA_SQD_THROW_INVALID_ARGUMENT_(
+            "Cannot draw more samples than number of bitstrings"
+        );
+    }
+
+    batches.resize(num_batches);
+    internal::_subsample_batches_in_parallel<RNGType>(
+        weights, num_batches, parallel_options, sampling_method,
+        [&](auto &sampler, std::size_t i, auto &rng) {
+            sampler.sample_indices(batches[i], samples_per_batch, rng);
+        }
+    );
+}
+
+/// Subsample multiple batches of indices into a population using multiple threads
+///
+/// This is equivalent to the multithreaded `subsample_multiple_batches`, except
+/// that it returns the indices of the subsampled members of the population rather
+/// than copies of them.
+///
+/// @param[in] weights Relative weight of each member of the population (need not be
+///     normalized to 1).  Must contain only non-negative values.
+/// @param[in] samples_per_batch Number of samples to return per batch.
+///     Cannot be greater than the size of the population.
+/// @param[in] num_batches Number of batches.
+/// @param[in] parallel_options Seed and number of threads.
+/// @param[in] sampling_method Algorithm to use for sampling without replacement.
+///
+/// @tparam RNGType Type of random number generator used for each batch.  Must be
+///     constructible from a single seed value.
+/// @tparam WeightVectorType Type of `weights`, compatible with `std::vector<double>`.
+///
+/// @return The batches of subsampled indices.
+template <QKA_SQD_CONCEPT_RNG_(RNGType) = std::mt19937_64, typename WeightVectorType>
+std::vector<std::vector<std::size_t>> subsample_multiple_batches_indices(
+    const WeightVectorType &weights, unsigned int samples_per_batch,
+    unsigned int num_batches, ParallelOptions parallel_options,
+    SamplingMethod sampling_method = SamplingMethod::rejection
+)
+{
+    std::vector<std::vector<std::size_t>> batches;
+    subsample_multiple_batches_indices<RNGType>(
+        batches, weights, samples_per_batch, num_batches, parallel_options,
+        sampling_method
     );
     return batches;
 }
@@ -0,0 +1,121 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_SUPPORT_BITSET2_HPP_
+#define QISKIT_ADDON_SQD_SUPPORT_BITSET2_HPP_
+
+/// Support for `Bitset2::bitset2` (optional include)
+
+#include "qiskit/addon/sqd/internal/bitset_common.hpp"
+
+// Bitset2 requires exceptions, and does not build with MSVC in C++20 mode
+#if __has_include(<bitset2.hpp>) && !QKA_SQD_DISABLE_EXCEPTIONS && \
+    !(_MSVC_LANG == 202002L)
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <bitset2.hpp>
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+namespace internal
+{
+
+template <std::size_t N, typename T>
+struct HalfSizeImpl<Bitset2::bitset2<N, T>> {
+    static_assert(N % 2 == 0, "N must be even");
+    using type = Bitset2::bitset2<N / 2, T>;
+};
+
+template <std::size_t N, typename T>
+struct FixedSizeImpl<Bitset2::bitset2<N, T>> {
+    static constexpr std::size_t value = N;
+};
+
+template <std::size_t N, typename T>
+struct RightLeftHammingImpl<Bitset2::bitset2<N, T>> {
+    static std::array<std::size_t, 2> count(const Bitset2::bitset2<N, T> &bitstring)
+    {
+        if constexpr (sizeof(T) <= sizeof(std::uint64_t)) {
+            // Count directly from the underlying array of words
+            RightLeftWordCounter<T> counter(N / 2);
+            for (const T word : bitstring.data()) {
+                counter(word);
+            }
+            return counter.counts();
+        } else {
+            const std::size_t left_count = (bitstring >> (N / 2)).count();
+            const std::size_t right_count = bitstring.count() - left_count;
+            return {right_count, left_count};
+        }
+    }
+};
+
+template <std::size_t N, typename T>
+struct WordsImpl<Bitset2::bitset2<N, T>> {
+    static void copy(const Bitset2::bitset2<N, T> &bitstring, std::uint64_t *words)
+    {
+        if constexpr (sizeof(T) <= sizeof(std::uint64_t)) {
+            WordPacker<T> packer(words);
+            for (const T word : bitstring.data()) {
+                packer(word);
+            }
+        } else {
+            std::fill(words, words + words_for_bits(N), std::uint64_t{0});
+            for (std::size_t i = 0; i < N; ++i) {
+                if (bitstring[i]) {
+                    words[i / 64] |= std::uint64_t{1} << (i % 64);
+                }
+            }
+        }
+    }
+};
+
+template <std::size_t N, typename T>
+struct AssignWordsImpl<Bitset2::bitset2<N, T>> {
+    static void assign(
+        Bitset2::bitset2<N, T> &bitstring, const std::uint64_t *words,
+        std::size_t /*num_bits*/
+    )
+    {
+        assign_fixed_size_words<N>(bitstring, words);
+    }
+};
+
+template <std::size_t N, typename T>
+std::array<HalfSize<Bitset2::bitset2<N, T>>, 2>
+split_bitstring(const Bitset2::bitset2<N, T> &bitset)
+{
+    return split_fixed_size_bitstring<N>(bitset);
+}
+
+} // namespace internal
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // __has_include(<bitset2.hpp>) && !QKA_SQD_DISABLE_EXCEPTIONS && ...
+
+#endif // QISKIT_ADDON_SQD_SUPPORT_BITSET2_HPP_
@@ -20,6 +20,13 @@
 
 #if __has_include(<boost/dynamic_bitset.hpp>)
 
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
 #include <boost/dynamic_bitset.hpp>
 
 namespace Qiskit
@@ -39,22 +46,131 @@ struct HalfSizeImpl<boost::dynamic_bitset<Block, Allocator>> {
     using type = boost::dynamic_bitset<Block, Allocator>;
 };
 
+/// Split a bitstring into its right and left halves, writing them into
+/// `right` and `left`.
+///
+/// The halves are copied and shifted a block at a time, and reuse the storage
+/// already held by `right` and `left`, so calling this repeatedly with the same
+/// output bitsets does not allocate once they are large enough.
 template <typename Block, typename Allocator>
-std::array<boost::dynamic_bitset<Block, Allocator>, 2>
-split_bitstring(const boost::dynamic_bitset<Block, Allocator> &bitset)
+void split_bitstring(
+    const boost::dynamic_bitset<Block, Allocator> &bitset,
+    boost::dynamic_bitset<Block, Allocator> &right,
+    boost::dynamic_bitset<Block, Allocator> &left
+)
 {
     if (bitset.size() % 2 != 0) {
         QKA_SQD_THROW_RUNTIME_ERROR_("Bitset size must be even");
     }
     const auto half_N = bitset.size() / 2;
-    boost::dynamic_bitset<Block, Allocator> right(half_N), left(half_N);
-    for (std::size_t i = 0; i < half_N; ++i) {
-        right[i] = bitset[i];
-        left[i] = bitset[i + half_N];
-    }
-    return {right, left};
+    right = bitset;
+    right.resize(half_N);
+    left = bitset;
+    left >>= half_N;
+    left.resize(half_N);
 }
 
+template <typename Block, typename Allocator>
+std::array<boost::dynamic_bitset<Block, Allocator>, 2>
+split_bitstring(const boost::dynamic_bitset<Block, Allocator> &bitset)
+{
+    std::array<boost::dynamic_bitset<Block, Allocator>, 2> retval;
+    split_bitstring(bitset, retval[0], retval[1]);
+    return retval;
+}
+
+// Output iterator which feeds the blocks written to it by
+// `boost::to_block_range` into a callable, such as a `RightLeftWordCounter`.
+template <typename Block, typename ConsumerType>
+class BlockOutputIterator
+{
+  private:
+    ConsumerType *consumer;
+
+  public:
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    explicit BlockOutputIterator(ConsumerType &consumer) : consumer(&consumer) {}
+
+    BlockOutputIterator &operator=(Block block)
+    {
+        (*consumer)(block);
+        return *this;
+    }
+    BlockOutputIterator &operator*()
+    {
+        return *this;
+    }
+    BlockOutputIterator &operator++()
+    {
+        return *this;
+    }
+    BlockOutputIterator operator++(int)
+    {
+        return *this;
+    }
+};
+
+template <typename Block, typename Allocator>
+struct RightLeftHammingImpl<boost::dynamic_bitset<Block, Allocator>> {
+    static std::array<std::size_t, 2>
+    count(const boost::dynamic_bitset<Block, Allocator> &bitstring)
+    {
+        // Visit the blocks in place, without materializing any temporary bitset
+        RightLeftWordCounter<Block> counter(bitstring.size() / 2);
+        boost::to_block_range(
+            bitstring,
+            BlockOutputIterator<Block, RightLeftWordCounter<Block>>(counter)
+        );
+        return counter.counts();
+    }
+};
+
+template <typename Block, typename Allocator>
+struct WordsImpl<boost::dynamic_bitset<Block, Allocator>> {
+    static void
+    copy(const boost::dynamic_bitset<Block, Allocator> &bitstring, std::uint64_t *words)
+    {
+        if constexpr (std::is_same_v<Block, std::uint64_t>) {
+            boost::to_block_range(bitstring, words);
+        } else {
+            WordPacker<Block> packer(words);
+            boost::to_block_range(
+                bitstring, BlockOutputIterator<Block, WordPacker<Block>>(packer)
+            );
+        }
+    }
+};
+
+template <typename Block, typename Allocator>
+struct AssignWordsImpl<boost::dynamic_bitset<Block, Allocator>> {
+    static void assign(
+        boost::dynamic_bitset<Block, Allocator> &bitstring, const std::uint64_t *words,
+        std::size_t num_bits
+    )
+    {
+        // Clearing keeps the storage, which the blocks are then appended to
+        bitstring.clear();
+        const auto num_words = words_for_bits(num_bits);
+        if constexpr (std::is_same_v<Block, std::uint64_t>) {
+            bitstring.append(words, words + num_words);
+        } else {
+            constexpr std::size_t bits_per_block = sizeof(Block) * CHAR_BIT;
+            static_assert(64 % bits_per_block == 0, "Block must evenly divide 64 bits");
+            for (std::size_t k = 0; k < num_words; ++k) {
+                for (std::size_t shift = 0; shift < 64; shift += bits_per_block) {
+                    bitstring.append(static_cast<Block>(words[k] >> shift));
+                }
+            }
+        }
+        bitstring.resize(num_bits);
+    }
+};
+
 } // namespace internal
 
 } // namespace sqd
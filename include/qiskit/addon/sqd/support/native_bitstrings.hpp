@@ -0,0 +1,269 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef QISKIT_ADDON_SQD_SUPPORT_NATIVE_BITSTRINGS_HPP_
+#define QISKIT_ADDON_SQD_SUPPORT_NATIVE_BITSTRINGS_HPP_
+
+/// Support for unsigned integers and `std::array<std::uint64_t, W>` as
+/// bitstrings.
+///
+/// A bitstring of either kind has exactly as many bits as its type: bit `i` of
+/// an unsigned integer `x` is `(x >> i) & 1`, and bit `i` of an array `a` is bit
+/// `i % 64` of `a[i / 64]`.  So a `std::uint64_t` holds 32 orbitals per spin
+/// sector, an `unsigned __int128` holds 64, and a `std::array<std::uint64_t, W>`
+/// holds `32 * W`.  Their halves are `std::uint32_t`, `std::uint64_t` and
+/// `std::array<std::uint64_t, W / 2>`, respectively.
+///
+/// Since the length is fixed by the type, shots of fewer orbitals must not be
+/// stored in a bare integer, whose halves would split at the wrong bit; store
+/// them in a `NativeBitstringVector` (see native_bitstring_vector.hpp), which
+/// carries their length, instead.
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "qiskit/addon/sqd/internal/bitset_common.hpp"
+
+namespace Qiskit
+{
+
+namespace addon
+{
+
+namespace sqd
+{
+
+namespace internal
+{
+
+/// Whether `T` is an unsigned integer type which may be used as a bitstring.
+template <typename T>
+struct IsNativeBitstring
+  : std::bool_constant<std::is_unsigned_v<T> && !std::is_same_v<T, bool>> {
+};
+
+#if defined(__SIZEOF_INT128__)
+__extension__ using native_uint128 = unsigned __int128;
+
+// `std::is_unsigned` may not know of this type in strict standard modes
+template <>
+struct IsNativeBitstring<native_uint128> : std::true_type {
+};
+#endif // defined(__SIZEOF_INT128__)
+
+template <typename T>
+using EnableIfNativeBitstring = std::enable_if_t<IsNativeBitstring<T>::value>;
+
+/// Number of bits of an unsigned integer type.
+template <typename T>
+constexpr std::size_t native_bits = sizeof(T) * CHAR_BIT;
+
+/// The unsigned integer type of `N` bits.
+template <std::size_t N>
+struct UnsignedOfBits;
+
+template <>
+struct UnsignedOfBits<8> {
+    using type = std::uint8_t;
+};
+
+template <>
+struct UnsignedOfBits<16> {
+    using type = std::uint16_t;
+};
+
+template <>
+struct UnsignedOfBits<32> {
+    using type = std::uint32_t;
+};
+
+template <>
+struct UnsignedOfBits<64> {
+    using type = std::uint64_t;
+};
+
+/// Count the set bits of an unsigned integer, with one instruction per 64 bits
+/// where the target has one.
+template <typename T>
+unsigned int popcount_native(T value)
+{
+    if constexpr (native_bits<T> <= 64) {
+        return popcount64(static_cast<std::uint64_t>(value));
+    } else {
+        static_assert(native_bits<T> == 128, "Integers wider than 128 bits");
+        return popcount64(static_cast<std::uint64_t>(value)) +
+               popcount64(static_cast<std::uint64_t>(value >> 64));
+    }
+}
+
+template <typename T>
+struct SizeImpl<T, EnableIfNativeBitstring<T>> {
+    static constexpr std::size_t size(T /*bitstring*/)
+    {
+        return native_bits<T>;
+    }
+};
+
+template <typename T>
+struct FixedSizeImpl<T, EnableIfNativeBitstring<T>> {
+    static constexpr std::size_t value = native_bits<T>;
+};
+
+template <typename T>
+struct FlipImpl<T, EnableIfNativeBitstring<T>> {
+    static void flip(T &bitstring, std::size_t i)
+    {
+        bitstring ^= static_cast<T>(T{1} << i);
+    }
+};
+
+// Integers of 16 bits or more split into integers of half as many bits
+template <typename T>
+struct HalfSizeImpl<
+    T, std::enable_if_t<IsNativeBitstring<T>::value && (native_bits<T> >= 16)>> {
+    using type = typename UnsignedOfBits<native_bits<T> / 2>::type;
+};
+
+template <typename T>
+struct RightLeftHammingImpl<T, EnableIfNativeBitstring<T>> {
+    static std::array<std::size_t, 2> count(T bitstring)
+    {
+        constexpr auto half_N = native_bits<T> / 2;
+        constexpr auto right_mask = static_cast<T>((T{1} << half_N) - 1);
+        return {
+            popcount_native(static_cast<T>(bitstring & right_mask)),
+            popcount_native(static_cast<T>(bitstring >> half_N))
+        };
+    }
+};
+
+template <typename T>
+struct WordsImpl<T, EnableIfNativeBitstring<T>> {
+    static void copy(T bitstring, std::uint64_t *words)
+    {
+        words[0] = static_cast<std::uint64_t>(bitstring);
+        if constexpr (native_bits<T> > 64) {
+            words[1] = static_cast<std::uint64_t>(bitstring >> 64);
+        }
+    }
+};
+
+template <typename T>
+struct AssignWordsImpl<T, EnableIfNativeBitstring<T>> {
+    static void
+    assign(T &bitstring, const std::uint64_t *words, std::size_t /*num_bits*/)
+    {
+        bitstring = static_cast<T>(words[0]);
+        if constexpr (native_bits<T> > 64) {
+            bitstring |= static_cast<T>(words[1]) << 64;
+        }
+    }
+};
+
+/// Split an unsigned integer into its right and left halves, with a single mask
+/// and a single shift.
+template <typename T, typename = EnableIfNativeBitstring<T>>
+std::array<HalfSize<T>, 2> split_bitstring(T bitstring)
+{
+    using HalfType = HalfSize<T>;
+    return {
+        static_cast<HalfType>(bitstring),
+        static_cast<HalfType>(bitstring >> native_bits<HalfType>)
+    };
+}
+
+template <std::size_t W>
+struct SizeImpl<std::array<std::uint64_t, W>> {
+    static constexpr std::size_t
+    size(const std::array<std::uint64_t, W> & /*bitstring*/)
+    {
+        return 64 * W;
+    }
+};
+
+template <std::size_t W>
+struct FixedSizeImpl<std::array<std::uint64_t, W>> {
+    static constexpr std::size_t value = 64 * W;
+};
+
+template <std::size_t W>
+struct FlipImpl<std::array<std::uint64_t, W>> {
+    static void flip(std::array<std::uint64_t, W> &bitstring, std::size_t i)
+    {
+        bitstring[i / 64] ^= std::uint64_t{1} << (i % 64);
+    }
+};
+
+template <std::size_t W>
+struct HalfSizeImpl<std::array<std::uint64_t, W>> {
+    static_assert(W % 2 == 0, "W must be even; use std::uint64_t for one word");
+    using type = std::array<std::uint64_t, W / 2>;
+};
+
+template <std::size_t W>
+struct RightLeftHammingImpl<std::array<std::uint64_t, W>> {
+    static std::array<std::size_t, 2>
+    count(const std::array<std::uint64_t, W> &bitstring)
+    {
+        RightLeftWordCounter<std::uint64_t> counter(32 * W);
+        for (const auto word : bitstring) {
+            counter(word);
+        }
+        return counter.counts();
+    }
+};
+
+template <std::size_t W>
+struct WordsImpl<std::array<std::uint64_t, W>> {
+    static void
+    copy(const std::array<std::uint64_t, W> &bitstring, std::uint64_t *words)
+    {
+        std::copy(bitstring.begin(), bitstring.end(), words);
+    }
+};
+
+template <std::size_t W>
+struct AssignWordsImpl<std::array<std::uint64_t, W>> {
+    static void assign(
+        std::array<std::uint64_t, W> &bitstring, const std::uint64_t *words,
+        std::size_t /*num_bits*/
+    )
+    {
+        std::copy(words, words + W, bitstring.begin());
+    }
+};
+
+/// Split an array of words into its right and left halves, which are its first
+/// and last `W / 2` words.
+template <std::size_t W>
+std::array<HalfSize<std::array<std::uint64_t, W>>, 2>
+split_bitstring(const std::array<std::uint64_t, W> &bitstring)
+{
+    std::array<HalfSize<std::array<std::uint64_t, W>>, 2> retval;
+    std::copy(bitstring.begin(), bitstring.begin() + W / 2, retval[0].begin());
+    std::copy(bitstring.begin() + W / 2, bitstring.end(), retval[1].begin());
+    return retval;
+}
+
+} // namespace internal
+
+} // namespace sqd
+
+} // namespace addon
+
+} // namespace Qiskit
+
+#endif // QISKIT_ADDON_SQD_SUPPORT_NATIVE_BITSTRINGS_HPP_
@@ -0,0 +1,69 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#ifndef BITSTRING_HELPERS_HPP_
+#define BITSTRING_HELPERS_HPP_
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "qiskit/addon/sqd/packed_bitstrings.hpp"
+
+// Draw `count` bitstrings of `num_bits` bits, each bit set with probability
+// `probability`
+static inline std::vector<Qiskit::addon::sqd::PackedBitstringVector::value_type>
+random_bitstrings(
+    std::size_t num_bits, std::size_t count, std::mt19937_64 &rng,
+    double probability = 0.5
+)
+{
+    using DynamicBitset = Qiskit::addon::sqd::PackedBitstringVector::value_type;
+    std::vector<DynamicBitset> bitstrings;
+    std::bernoulli_distribution coin(probability);
+    for (std::size_t i = 0; i < count; ++i) {
+        DynamicBitset bs(num_bits);
+        for (std::size_t j = 0; j < num_bits; ++j) {
+            bs[j] = coin(rng);
+        }
+        bitstrings.push_back(bs);
+    }
+    return bitstrings;
+}
+
+// Copy bitstrings into a container such as `PackedBitstringVector`
+template <typename VectorType = Qiskit::addon::sqd::PackedBitstringVector>
+static VectorType pack(
+    const std::vector<Qiskit::addon::sqd::PackedBitstringVector::value_type> &bitstrings
+)
+{
+    VectorType packed;
+    for (const auto &bs : bitstrings) {
+        packed.push_back(bs);
+    }
+    return packed;
+}
+
+// Copy the bitstrings of a container such as `PackedBitstringVector` out of it
+template <typename VectorType>
+static std::vector<Qiskit::addon::sqd::PackedBitstringVector::value_type>
+unpack(const VectorType &bitstrings)
+{
+    using DynamicBitset = Qiskit::addon::sqd::PackedBitstringVector::value_type;
+    std::vector<DynamicBitset> retval;
+    for (const auto bs : bitstrings) {
+        retval.push_back(DynamicBitset(bs));
+    }
+    return retval;
+}
+
+#endif // BITSTRING_HELPERS_HPP_
@@ -0,0 +1,263 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "qiskit/addon/sqd/bit_array.hpp"
+
+#include "doctest.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "qiskit/addon/sqd/configuration_recovery.hpp"
+#include "qiskit/addon/sqd/fermion.hpp"
+#include "qiskit/addon/sqd/postselection.hpp"
+#include "qiskit/addon/sqd/subsampling.hpp"
+
+#include "bitstring_helpers.hpp"
+
+using Qiskit::addon::sqd::BitArrayVector;
+using DynamicBitset = BitArrayVector::value_type;
+
+// Pack bitstrings into bytes by hand, as a Qiskit `BitArray` does
+static std::vector<std::uint8_t> to_bytes(const std::vector<DynamicBitset> &bitstrings)
+{
+    std::vector<std::uint8_t> bytes;
+    for (const auto &bs : bitstrings) {
+        const auto num_bytes = (bs.size() + 7) / 8;
+        std::vector<std::uint8_t> row(num_bytes, 0);
+        for (std::size_t j = 0; j < bs.size(); ++j) {
+            if (bs[j]) {
+                row[num_bytes - 1 - j / 8] |= static_cast<std::uint8_t>(1u << (j % 8));
+            }
+        }
+        bytes.insert(bytes.end(), row.begin(), row.end());
+    }
+    return bytes;
+}
+
+TEST_CASE("Bit array layout")
+{
+    // Bits 0 and 9 of a 10-bit bitstring, as in `BitArray.from_bool_array`
+    DynamicBitset bs(10);
+    bs.set(0);
+    bs.set(9);
+    const auto packed = pack<BitArrayVector>({bs});
+    REQUIRE(packed.bytes_per_bitstring() == 2);
+    CHECK(packed.data()[0] == 0x02);
+    CHECK(packed.data()[1] == 0x01);
+}
+
+TEST_CASE("Bit array vector")
+{
+    std::mt19937_64 rng;
+    for (std::size_t num_bits : {6u, 8u, 64u, 70u, 116u, 130u}) {
+        const auto bitstrings = random_bitstrings(num_bits, 20, rng);
+        const auto bytes = to_bytes(bitstrings);
+        auto packed = pack<BitArrayVector>(bitstrings);
+        CHECK(packed.size() == bitstrings.size());
+        CHECK(packed.num_bits() == num_bits);
+        CHECK(packed.bytes_per_bitstring() == (num_bits + 7) / 8);
+        CHECK(std::vector<std::uint8_t>(
+                  packed.data(), packed.data() + bytes.size()
+              ) == bytes);
+
+        const auto borrowed =
+            BitArrayVector::borrow(bytes.data(), num_bits, bitstrings.size());
+        CHECK(borrowed.is_borrowed());
+        CHECK(borrowed == packed);
+        std::size_t i = 0;
+        for (const auto &bs : borrowed) {
+            CHECK(bs.size() == num_bits);
+            CHECK(bs.count() == bitstrings[i].count());
+            CHECK(bs == bitstrings[i]);
+            CHECK(static_cast<DynamicBitset>(bs) == bitstrings[i]);
+            for (std::size_t j = 0; j < num_bits; ++j) {
+                CHECK(bs[j] == bitstrings[i][j]);
+            }
+            ++i;
+        }
+
+        SUBCASE("Mutation through references")
+        {
+            packed[0].flip(num_bits - 1);
+            auto expected = bitstrings[0];
+            expected.flip(num_bits - 1);
+            CHECK(packed[0] == expected);
+            packed[1] = packed[2];
+            CHECK(packed[1] == bitstrings[2]);
+            packed[3] = bitstrings[4];
+            CHECK(packed[3] == bitstrings[4]);
+            packed[4].set(0, !bitstrings[4][0]);
+            CHECK(packed[4][0] == !bitstrings[4][0]);
+        }
+        SUBCASE("Mutation copies borrowed bytes")
+        {
+            auto copy = borrowed;
+            copy[0].flip(0);
+            CHECK(!copy.is_borrowed());
+            CHECK(copy[0][0] == !bitstrings[0][0]);
+            CHECK(borrowed[0] == bitstrings[0]);
+            copy.push_back(borrowed[1]);
+            CHECK(copy.back() == bitstrings[1]);
+        }
+        SUBCASE("Appending an element of the same container")
+        {
+            packed.push_back(packed[5]);
+            CHECK(packed.back() == bitstrings[5]);
+        }
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+        SUBCASE("Mismatched lengths")
+        {
+            CHECK_THROWS_AS(
+                packed.push_back(DynamicBitset(num_bits + 2)), std::invalid_argument
+            );
+        }
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Bit arrays from any dynamic_bitset", BitsetType, boost::dynamic_bitset<>,
+    boost::dynamic_bitset<unsigned char>, boost::dynamic_bitset<std::uint32_t>,
+    boost::dynamic_bitset<unsigned long long>
+)
+{
+    std::mt19937_64 rng;
+    for (std::size_t num_bits : {6u, 64u, 116u, 130u}) {
+        const auto bitstrings = random_bitstrings(num_bits, 10, rng);
+        std::vector<BitsetType> converted;
+        for (const auto &bs : bitstrings) {
+            BitsetType bitset(num_bits);
+            for (std::size_t j = 0; j < num_bits; ++j) {
+                bitset[j] = bs[j];
+            }
+            converted.push_back(bitset);
+        }
+        BitArrayVector packed;
+        for (const auto &bitset : converted) {
+            packed.push_back(bitset);
+        }
+        CHECK(packed == pack<BitArrayVector>(bitstrings));
+        for (std::size_t i = 0; i < converted.size(); ++i) {
+            CHECK(packed[i] == converted[i]);
+            CHECK(converted[i] == packed[i]);
+        }
+        CHECK(!(packed[0] == BitsetType(num_bits + 1)));
+        packed[0] = converted[1];
+        CHECK(packed[0] == bitstrings[1]);
+        CHECK_THROWS_AS(packed[0] = BitsetType(num_bits + 1), std::invalid_argument);
+        CHECK_THROWS_AS(
+            packed.push_back(BitsetType(num_bits + 1)), std::invalid_argument
+        );
+    }
+}
+
+TEST_CASE("Algorithms on bit arrays")
+{
+    std::mt19937_64 rng;
+    for (std::size_t norb : {29u, 58u}) {
+        const auto bitstrings = random_bitstrings(2 * norb, 300, rng);
+        const auto bytes = to_bytes(bitstrings);
+        const auto packed =
+            BitArrayVector::borrow(bytes.data(), 2 * norb, bitstrings.size());
+        std::vector<double> weights;
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        for (std::size_t i = 0; i < bitstrings.size(); ++i) {
+            weights.push_back(dist(rng));
+        }
+        const std::uint64_t n_alpha = norb / 2, n_beta = norb / 2;
+
+        SUBCASE("Postselection")
+        {
+            const Qiskit::addon::sqd::MatchesRightLeftHamming filter(n_alpha, n_beta);
+            const auto [expected_bitstrings, expected_weights] =
+                Qiskit::addon::sqd::postselect_bitstrings(bitstrings, weights, filter);
+            const auto [new_bitstrings, new_weights] =
+                Qiskit::addon::sqd::postselect_bitstrings(packed, weights, filter);
+            CHECK(!new_bitstrings.empty());
+            CHECK(new_bitstrings == pack<BitArrayVector>(expected_bitstrings));
+            CHECK(new_weights == expected_weights);
+
+            auto inplace_bitstrings = packed;
+            auto inplace_weights = weights;
+            Qiskit::addon::sqd::postselect_bitstrings_inplace(
+                inplace_bitstrings, inplace_weights, filter
+            );
+            CHECK(inplace_bitstrings == pack<BitArrayVector>(expected_bitstrings));
+            CHECK(inplace_weights == expected_weights);
+        }
+        SUBCASE("Subsampling")
+        {
+            std::mt19937_64 rng1, rng2;
+            const auto expected =
+                Qiskit::addon::sqd::subsample(bitstrings, weights, 50, rng1);
+            const auto batch = Qiskit::addon::sqd::subsample(packed, weights, 50, rng2);
+            CHECK(batch == pack<BitArrayVector>(expected));
+        }
+        SUBCASE("Configuration recovery")
+        {
+            std::array<std::vector<double>, 2> avg_occupancies;
+            for (auto &occs : avg_occupancies) {
+                for (std::size_t i = 0; i < norb; ++i) {
+                    occs.push_back(dist(rng));
+                }
+            }
+            std::mt19937_64 rng1, rng2;
+            const auto [expected_bitstrings, expected_probs] =
+                Qiskit::addon::sqd::recover_configurations(
+                    bitstrings, weights, avg_occupancies, {n_alpha, n_beta}, rng1
+                );
+            const auto [new_bitstrings, new_probs] =
+                Qiskit::addon::sqd::recover_configurations(
+                    packed, weights, avg_occupancies, {n_alpha, n_beta}, rng2
+                );
+            CHECK(new_bitstrings == pack<BitArrayVector>(expected_bitstrings));
+            CHECK(new_probs == expected_probs);
+
+            Qiskit::addon::sqd::ConfigurationRecoverer recoverer(
+                packed, weights, {n_alpha, n_beta}
+            );
+            recoverer.update_occupancies(avg_occupancies);
+            recoverer.run(rng2);
+            const auto [expected_reused_bitstrings, expected_reused_probs] =
+                Qiskit::addon::sqd::recover_configurations(
+                    bitstrings, weights, avg_occupancies, {n_alpha, n_beta}, rng1
+                );
+            const auto [reused_bitstrings, reused_probs] = recoverer.result();
+            CHECK(
+                reused_bitstrings == pack<BitArrayVector>(expected_reused_bitstrings)
+            );
+            CHECK(reused_probs == expected_reused_probs);
+        }
+        SUBCASE("CI strings")
+        {
+            const auto expected =
+                Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(
+                    bitstrings
+                );
+            const auto ci_strings =
+                Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(packed);
+            CHECK(
+                std::unordered_set<DynamicBitset>(
+                    ci_strings.begin(), ci_strings.end()
+                ) == std::unordered_set<DynamicBitset>(expected.begin(), expected.end())
+            );
+        }
+        CHECK(packed.is_borrowed());
+    }
+}
@@ -11,11 +11,16 @@
 // that they have been altered from the originals.
 
 #include "doctest.h"
+#include "qiskit/addon/sqd/bitset_full.hpp"
 #include "qiskit/addon/sqd/configuration_recovery.hpp"
 
 #include <array>
 #include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <map>
 #include <random>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -130,6 +135,31 @@ TEST_CASE("Configuration recovery tests from python addon")
         CHECK(probs_rec.size() == 1);
         CHECK(probs_rec[0] == 1.0);
     }
+    SUBCASE("Each sampling method yields the desired Hamming weights")
+    {
+        using Qiskit::addon::sqd::SamplingMethod;
+        constexpr auto num_orbs = 8;
+        constexpr auto half_orbs = num_orbs / 2;
+        const std::vector<std::bitset<num_orbs>> bitstrings{
+            0b00000000, 0b11111111, 0b10100101, 0b00010001
+        };
+        const std::vector<double> probs(bitstrings.size(), 1.0);
+        std::array<std::vector<double>, 2> occs{
+            std::vector<double>{0.9, 0.1, 0.5, 0.3},
+            std::vector<double>{0.2, 0.4, 0.8, 0.6}
+        };
+        for (auto method :
+             {SamplingMethod::rejection, SamplingMethod::fenwick_tree,
+              SamplingMethod::exponential_keys}) {
+            auto [mat_rec, probs_rec] =
+                recover_configurations(bitstrings, probs, occs, {2, 3}, rng, method);
+            CHECK(!mat_rec.empty());
+            for (const auto &bitstring : mat_rec) {
+                CHECK((bitstring & std::bitset<num_orbs>(0b1111)).count() == 2);
+                CHECK((bitstring >> half_orbs).count() == 3);
+            }
+        }
+    }
     SUBCASE("Bad Hamming right")
     {
         constexpr auto num_orbs = 4;
@@ -177,3 +207,768 @@ TEST_CASE_TEMPLATE(
     Qiskit::addon::sqd::internal::mask_lower_n_bits_inplace(bs, 3);
     CHECK(bs == bs_expected);
 }
+
+TEST_CASE_TEMPLATE(
+    "Parallel configuration recovery", BitstringType, std::bitset<8>,
+    boost::dynamic_bitset<>
+)
+{
+    constexpr unsigned int N = 8;
+    std::mt19937_64 rng;
+    std::uniform_int_distribution<unsigned int> bits_dist(0, (1u << N) - 1);
+    std::uniform_real_distribution<double> real_dist(0.0, 1.0);
+    std::vector<BitstringType> bitstrings;
+    std::vector<double> probabilities;
+    for (unsigned int i = 0; i < 1000; ++i) {
+        BitstringType bs;
+        set_bitset(N, bs, bits_dist(rng));
+        bitstrings.push_back(bs);
+        probabilities.push_back(real_dist(rng));
+    }
+    std::array<std::vector<double>, 2> avg_occupancies;
+    for (auto &occs : avg_occupancies) {
+        for (unsigned int i = 0; i < N / 2; ++i) {
+            occs.push_back(real_dist(rng));
+        }
+    }
+    const std::array<std::uint64_t, 2> num_elec{2, 1};
+
+    Qiskit::addon::sqd::ParallelOptions options;
+    options.seed = 12345;
+    options.shard_size = 64;
+    options.num_threads = 1;
+    const auto [expected_bitstrings, expected_probs] = recover_configurations(
+        bitstrings, probabilities, avg_occupancies, num_elec, options
+    );
+    CHECK(expected_bitstrings.size() == expected_probs.size());
+    double total = 0.0;
+    for (std::size_t i = 0; i < expected_bitstrings.size(); ++i) {
+        const auto [right, left] =
+            Qiskit::addon::sqd::internal::split_bitstring(expected_bitstrings[i]);
+        CHECK(right.count() == num_elec[0]);
+        CHECK(left.count() == num_elec[1]);
+        total += expected_probs[i];
+    }
+    CHECK(total == doctest::Approx(1.0));
+
+    SUBCASE("Output does not depend on the number of threads")
+    {
+        for (unsigned int num_threads : {2u, 3u, 8u}) {
+            options.num_threads = num_threads;
+            const auto [bitstrings_out, probs_out] = recover_configurations(
+                bitstrings, probabilities, avg_occupancies, num_elec, options
+            );
+            CHECK(bitstrings_out == expected_bitstrings);
+            CHECK(probs_out == expected_probs);
+        }
+    }
+    SUBCASE("Output depends on the seed")
+    {
+        options.seed = 54321;
+        const auto [bitstrings_out, probs_out] = recover_configurations(
+            bitstrings, probabilities, avg_occupancies, num_elec, options
+        );
+        CHECK(probs_out != expected_probs);
+    }
+    SUBCASE("Invalid arguments")
+    {
+        options.shard_size = 0;
+        CHECK_THROWS_AS(
+            std::ignore = recover_configurations(
+                bitstrings, probabilities, avg_occupancies, num_elec, options
+            ),
+            std::invalid_argument
+        );
+        options.shard_size = 64;
+        probabilities.pop_back();
+        CHECK_THROWS_AS(
+            std::ignore = recover_configurations(
+                bitstrings, probabilities, avg_occupancies, num_elec, options
+            ),
+            std::invalid_argument
+        );
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Words of a bitstring", BitstringType, std::bitset<8>, std::bitset<64>,
+    std::bitset<130>, boost::dynamic_bitset<>, boost::dynamic_bitset<std::uint8_t>
+)
+{
+    std::mt19937_64 rng;
+    std::bernoulli_distribution coin;
+    for (std::size_t num_bits : {8u, 64u, 130u}) {
+        BitstringType bitstring;
+        if constexpr (std::is_same_v<BitstringType, std::bitset<8>>) {
+            num_bits = 8;
+        } else if constexpr (std::is_same_v<BitstringType, std::bitset<64>>) {
+            num_bits = 64;
+        } else if constexpr (std::is_same_v<BitstringType, std::bitset<130>>) {
+            num_bits = 130;
+        } else {
+            bitstring.resize(num_bits);
+        }
+        for (std::size_t j = 0; j < num_bits; ++j) {
+            bitstring.set(j, coin(rng));
+        }
+        const auto num_words = Qiskit::addon::sqd::internal::words_for_bits(num_bits);
+        std::vector<std::uint64_t> words(num_words, ~std::uint64_t{0});
+        Qiskit::addon::sqd::internal::WordsImpl<BitstringType>::copy(
+            bitstring, words.data()
+        );
+        for (std::size_t j = 0; j < 64 * num_words; ++j) {
+            const bool expected = j < num_bits && bitstring[j];
+            CHECK(bool((words[j / 64] >> (j % 64)) & 1) == expected);
+        }
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Sort-and-reduce aggregation", BitstringType, std::bitset<8>,
+    boost::dynamic_bitset<>
+)
+{
+    constexpr unsigned int N = 8;
+    std::mt19937_64 rng;
+    std::uniform_int_distribution<unsigned int> bits_dist(0, (1u << N) - 1);
+    std::uniform_real_distribution<double> real_dist(0.0, 1.0);
+    std::vector<BitstringType> bitstrings;
+    std::vector<double> probabilities;
+    for (unsigned int i = 0; i < 1000; ++i) {
+        BitstringType bs;
+        set_bitset(N, bs, bits_dist(rng));
+        bitstrings.push_back(bs);
+        probabilities.push_back(real_dist(rng));
+    }
+    std::array<std::vector<double>, 2> avg_occupancies;
+    for (auto &occs : avg_occupancies) {
+        for (unsigned int i = 0; i < N / 2; ++i) {
+            occs.push_back(real_dist(rng));
+        }
+    }
+    const std::array<std::uint64_t, 2> num_elec{2, 1};
+    using Qiskit::addon::sqd::AggregationMethod;
+    using Qiskit::addon::sqd::SamplingMethod;
+
+    const auto to_map = [](const auto &bitstrings_out, const auto &probs_out) {
+        std::map<std::uint64_t, double> result;
+        for (std::size_t i = 0; i < bitstrings_out.size(); ++i) {
+            std::uint64_t word;
+            Qiskit::addon::sqd::internal::WordsImpl<BitstringType>::copy(
+                bitstrings_out[i], &word
+            );
+            result[word] = probs_out[i];
+        }
+        return result;
+    };
+    const auto check_sorted = [](const auto &bitstrings_out) {
+        for (std::size_t i = 1; i < bitstrings_out.size(); ++i) {
+            std::uint64_t a, b;
+            Qiskit::addon::sqd::internal::WordsImpl<BitstringType>::copy(
+                bitstrings_out[i - 1], &a
+            );
+            Qiskit::addon::sqd::internal::WordsImpl<BitstringType>::copy(
+                bitstrings_out[i], &b
+            );
+            CHECK(a < b);
+        }
+    };
+    const auto check_same = [](const auto &a, const auto &b) {
+        REQUIRE(a.size() == b.size());
+        for (auto it_a = a.begin(), it_b = b.begin(); it_a != a.end(); ++it_a, ++it_b) {
+            CHECK(it_a->first == it_b->first);
+            CHECK(it_a->second == doctest::Approx(it_b->second));
+        }
+    };
+
+    SUBCASE("Single-threaded")
+    {
+        std::mt19937_64 rng1(7), rng2(7);
+        const auto [hashed_bitstrings, hashed_probs] = recover_configurations(
+            bitstrings, probabilities, avg_occupancies, num_elec, rng1,
+            SamplingMethod::rejection, AggregationMethod::hash_map
+        );
+        const auto [sorted_bitstrings, sorted_probs] = recover_configurations(
+            bitstrings, probabilities, avg_occupancies, num_elec, rng2,
+            SamplingMethod::rejection, AggregationMethod::sort_reduce
+        );
+        check_sorted(sorted_bitstrings);
+        check_same(
+            to_map(sorted_bitstrings, sorted_probs),
+            to_map(hashed_bitstrings, hashed_probs)
+        );
+    }
+    SUBCASE("Multithreaded")
+    {
+        Qiskit::addon::sqd::ParallelOptions options;
+        options.seed = 12345;
+        options.shard_size = 64;
+        options.num_threads = 1;
+        const auto [hashed_bitstrings, hashed_probs] = recover_configurations(
+            bitstrings, probabilities, avg_occupancies, num_elec, options,
+            SamplingMethod::rejection, AggregationMethod::hash_map
+        );
+        const auto [sorted_bitstrings, sorted_probs] = recover_configurations(
+            bitstrings, probabilities, avg_occupancies, num_elec, options,
+            SamplingMethod::rejection, AggregationMethod::sort_reduce
+        );
+        check_sorted(sorted_bitstrings);
+        check_same(
+            to_map(sorted_bitstrings, sorted_probs),
+            to_map(hashed_bitstrings, hashed_probs)
+        );
+        for (unsigned int num_threads : {2u, 3u}) {
+            options.num_threads = num_threads;
+            const auto [bitstrings_out, probs_out] = recover_configurations(
+                bitstrings, probabilities, avg_occupancies, num_elec, options,
+                SamplingMethod::rejection, AggregationMethod::sort_reduce
+            );
+            CHECK(bitstrings_out == sorted_bitstrings);
+            CHECK(probs_out == sorted_probs);
+        }
+    }
+}
+
+TEST_CASE("Flat hash map of bitstring words")
+{
+    using Qiskit::addon::sqd::internal::FlatBitstringMap;
+    std::mt19937_64 rng;
+    for (std::size_t words_per_key : {1u, 2u, 3u}) {
+        // Draw keys from a small range so that there are many duplicates
+        std::uniform_int_distribution<std::uint64_t> word_dist(0, 40);
+        std::vector<std::uint64_t> keys(2000 * words_per_key);
+        for (auto &word : keys) {
+            word = word_dist(rng);
+        }
+        const auto key_vector = [&](const std::uint64_t *key) {
+            return std::vector<std::uint64_t>(key, key + words_per_key);
+        };
+
+        std::map<std::vector<std::uint64_t>, std::size_t> expected;
+        FlatBitstringMap<std::size_t> map(words_per_key);
+        for (std::size_t i = 0; i < 2000; ++i) {
+            const auto *key = keys.data() + i * words_per_key;
+            const auto [index, inserted] = map.try_emplace(key, 0);
+            CHECK(inserted == (expected.count(key_vector(key)) == 0));
+            ++map.value(index);
+            ++expected[key_vector(key)];
+        }
+        REQUIRE(map.size() == expected.size());
+        for (std::size_t j = 0; j < map.size(); ++j) {
+            CHECK(map.value(j) == expected[key_vector(map.key(j))]);
+            CHECK(map.find(map.key(j)) == j);
+        }
+        const std::vector<std::uint64_t> absent(words_per_key, 1000);
+        CHECK(map.find(absent.data()) == FlatBitstringMap<std::size_t>::npos);
+
+        // Split the keys between two maps, and merge them in order
+        {
+            FlatBitstringMap<std::size_t> first(words_per_key);
+            FlatBitstringMap<std::size_t> second(words_per_key, 50);
+            for (std::size_t i = 0; i < 2000; ++i) {
+                auto &half = i < 1000 ? first : second;
+                const auto [index, inserted] =
+                    half.try_emplace(keys.data() + i * words_per_key, 0);
+                ++half.value(index);
+            }
+            const auto first_size = first.size();
+            std::size_t num_inserted = 0;
+            first.merge(second, [&](std::size_t j, std::size_t index, bool inserted) {
+                CHECK(first.hash(index) == second.hash(j));
+                if (inserted) {
+                    ++num_inserted;
+                } else {
+                    first.value(index) += second.value(j);
+                }
+            });
+            CHECK(first.values() == map.values());
+            CHECK(first_size + num_inserted == map.size());
+        }
+        // Clear, and reuse, the map
+        {
+            map.clear();
+            CHECK(map.empty());
+            CHECK(map.find(keys.data()) == FlatBitstringMap<std::size_t>::npos);
+            CHECK(map.try_emplace(keys.data(), 5).second);
+            CHECK(map.value(0) == 5);
+        }
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Reusable configuration recovery", BitstringType, std::bitset<8>,
+    boost::dynamic_bitset<>
+)
+{
+    constexpr unsigned int N = 8;
+    std::mt19937_64 rng;
+    std::uniform_int_distribution<unsigned int> bits_dist(0, (1u << N) - 1);
+    std::uniform_real_distribution<double> real_dist(0.0, 1.0);
+    std::vector<BitstringType> bitstrings;
+    std::vector<double> probabilities;
+    for (unsigned int i = 0; i < 500; ++i) {
+        BitstringType bs;
+        set_bitset(N, bs, bits_dist(rng));
+        bitstrings.push_back(bs);
+        probabilities.push_back(real_dist(rng));
+    }
+    const std::array<std::uint64_t, 2> num_elec{2, 1};
+    using Qiskit::addon::sqd::SamplingMethod;
+
+    for (auto sampling_method :
+         {SamplingMethod::rejection, SamplingMethod::fenwick_tree}) {
+        Qiskit::addon::sqd::ConfigurationRecoverer recoverer(
+            bitstrings, probabilities, num_elec, sampling_method
+        );
+        CHECK_THROWS_AS(recoverer.run(rng), std::runtime_error);
+
+        std::mt19937_64 rng1(11), rng2(11);
+        for (int iteration = 0; iteration < 3; ++iteration) {
+            std::array<std::vector<double>, 2> avg_occupancies;
+            for (auto &occs : avg_occupancies) {
+                for (unsigned int i = 0; i < N / 2; ++i) {
+                    occs.push_back(real_dist(rng));
+                }
+            }
+            const auto [expected_bitstrings, expected_probs] = recover_configurations(
+                bitstrings, probabilities, avg_occupancies, num_elec, rng1,
+                sampling_method
+            );
+            recoverer.update_occupancies(avg_occupancies);
+            recoverer.run(rng2);
+            REQUIRE(recoverer.size() == expected_bitstrings.size());
+            for (std::size_t j = 0; j < recoverer.size(); ++j) {
+                CHECK(recoverer.bitstring(j) == expected_bitstrings[j]);
+            }
+            // Duplicate valid bitstrings are summed in advance, so the
+            // probabilities may differ in rounding
+            for (std::size_t j = 0; j < recoverer.size(); ++j) {
+                CHECK(
+                    recoverer.probabilities()[j] == doctest::Approx(expected_probs[j])
+                );
+            }
+            const auto [bitstrings_out, probs_out] = recoverer.result();
+            CHECK(bitstrings_out == expected_bitstrings);
+            CHECK(probs_out == recoverer.probabilities());
+        }
+    }
+
+    SUBCASE("Invalid arguments")
+    {
+        const std::vector<double> short_probabilities(
+            probabilities.begin() + 1, probabilities.end()
+        );
+        CHECK_THROWS_AS(
+            Qiskit::addon::sqd::ConfigurationRecoverer(
+                bitstrings, short_probabilities, num_elec
+            ),
+            std::invalid_argument
+        );
+        Qiskit::addon::sqd::ConfigurationRecoverer recoverer(
+            bitstrings, probabilities, num_elec
+        );
+        const std::array<std::vector<double>, 2> wrong_size{
+            std::vector<double>(3, 0.5), std::vector<double>(3, 0.5)
+        };
+        CHECK_THROWS_AS(
+            recoverer.update_occupancies(wrong_size), std::invalid_argument
+        );
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Valid bitstrings skip correction", BitstringType, std::bitset<8>,
+    boost::dynamic_bitset<>
+)
+{
+    constexpr unsigned int N = 8;
+    const std::array<std::uint64_t, 2> num_elec{2, 1};
+    const std::array<std::vector<double>, 2> avg_occupancies{
+        std::vector<double>{0.9, 0.1, 0.6, 0.4}, std::vector<double>{0.2, 0.3, 0.1, 0.4}
+    };
+    // Every bitstring has two bits set on the right and one on the left
+    std::vector<BitstringType> bitstrings;
+    for (unsigned int value : {0b00010011u, 0b01000101u, 0b00010011u, 0b10001100u}) {
+        BitstringType bs;
+        set_bitset(N, bs, value);
+        bitstrings.push_back(bs);
+    }
+    const std::vector<double> probabilities{0.1, 0.2, 0.3, 0.4};
+    using Qiskit::addon::sqd::AggregationMethod;
+    using Qiskit::addon::sqd::SamplingMethod;
+
+    for (auto aggregation_method :
+         {AggregationMethod::hash_map, AggregationMethod::sort_reduce}) {
+        std::mt19937_64 rng(5);
+        const auto [bitstrings_out, probs_out] = recover_configurations(
+            bitstrings, probabilities, avg_occupancies, num_elec, rng,
+            SamplingMethod::rejection, aggregation_method
+        );
+        // No random numbers are drawn for bitstrings which need no correction
+        CHECK(rng == std::mt19937_64(5));
+        REQUIRE(bitstrings_out.size() == 3);
+        for (std::size_t j = 0; j < bitstrings_out.size(); ++j) {
+            double expected = 0.0;
+            for (std::size_t i = 0; i < bitstrings.size(); ++i) {
+                if (bitstrings[i] == bitstrings_out[j]) {
+                    expected += probabilities[i];
+                }
+            }
+            CHECK(probs_out[j] == doctest::Approx(expected));
+        }
+    }
+
+    // The invalid bitstrings alone are corrected, drawing the same random
+    // numbers as if the valid ones were absent
+    std::vector<BitstringType> mixed = bitstrings;
+    std::vector<double> mixed_probabilities = probabilities;
+    std::vector<BitstringType> invalid;
+    for (unsigned int value : {0b11110000u, 0b00000001u}) {
+        BitstringType bs;
+        set_bitset(N, bs, value);
+        mixed.insert(mixed.begin() + 1, bs);
+        mixed_probabilities.insert(mixed_probabilities.begin() + 1, 0.25);
+        invalid.insert(invalid.begin(), bs);
+    }
+    std::mt19937_64 rng1(17), rng2(17), rng3(17);
+    const auto [expected_bitstrings, expected_probs] = recover_configurations(
+        invalid, std::vector<double>(invalid.size(), 0.25), avg_occupancies, num_elec,
+        rng1
+    );
+    const auto [mixed_bitstrings, mixed_probs] = recover_configurations(
+        mixed, mixed_probabilities, avg_occupancies, num_elec, rng2
+    );
+    CHECK(rng1 == rng2);
+    for (const auto &bs : expected_bitstrings) {
+        CHECK(std::find(mixed_bitstrings.begin(), mixed_bitstrings.end(), bs) !=
+              mixed_bitstrings.end());
+    }
+
+    Qiskit::addon::sqd::ConfigurationRecoverer recoverer(
+        mixed, mixed_probabilities, num_elec
+    );
+    recoverer.update_occupancies(avg_occupancies);
+    recoverer.run(rng3);
+    CHECK(rng3 == rng2);
+    const auto [reused_bitstrings, reused_probs] = recoverer.result();
+    CHECK(reused_bitstrings == mixed_bitstrings);
+    REQUIRE(reused_probs.size() == mixed_probs.size());
+    for (std::size_t j = 0; j < reused_probs.size(); ++j) {
+        CHECK(reused_probs[j] == doctest::Approx(mixed_probs[j]));
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Configuration recovery from counts", BitstringType, std::bitset<8>,
+    boost::dynamic_bitset<>
+)
+{
+    constexpr unsigned int N = 8;
+    std::mt19937_64 rng;
+    std::uniform_int_distribution<std::uint64_t> count_dist(0, 6);
+    std::uniform_real_distribution<double> real_dist(0.0, 1.0);
+    std::vector<BitstringType> bitstrings, expanded;
+    std::vector<std::uint64_t> multiplicities;
+    std::vector<double> probabilities, expanded_probabilities;
+    for (unsigned int value = 0; value < (1u << N); value += 3) {
+        BitstringType bs;
+        set_bitset(N, bs, value);
+        const auto multiplicity = count_dist(rng);
+        const auto probability = real_dist(rng);
+        bitstrings.push_back(bs);
+        multiplicities.push_back(multiplicity);
+        probabilities.push_back(probability);
+        for (std::uint64_t k = 0; k < multiplicity; ++k) {
+            expanded.push_back(bs);
+            expanded_probabilities.push_back(probability / multiplicity);
+        }
+    }
+    std::array<std::vector<double>, 2> avg_occupancies;
+    for (auto &occs : avg_occupancies) {
+        for (unsigned int i = 0; i < N / 2; ++i) {
+            occs.push_back(real_dist(rng));
+        }
+    }
+    const std::array<std::uint64_t, 2> num_elec{2, 1};
+    using Qiskit::addon::sqd::AggregationMethod;
+    using Qiskit::addon::sqd::SamplingMethod;
+
+    // These samplers draw the same indices after a reset as when new, so the
+    // result matches that of the expanded input exactly
+    for (auto sampling_method :
+         {SamplingMethod::rejection, SamplingMethod::exponential_keys}) {
+        for (auto aggregation_method :
+             {AggregationMethod::hash_map, AggregationMethod::sort_reduce}) {
+            std::mt19937_64 rng1(3), rng2(3);
+            const auto [expected_bitstrings, expected_probs] = recover_configurations(
+                expanded, expanded_probabilities, avg_occupancies, num_elec, rng1,
+                sampling_method, aggregation_method
+            );
+            const auto [bitstrings_out, probs_out] = recover_configurations(
+                bitstrings, multiplicities, probabilities, avg_occupancies, num_elec,
+                rng2, sampling_method, aggregation_method
+            );
+            CHECK(rng1 == rng2);
+            CHECK(bitstrings_out == expected_bitstrings);
+            REQUIRE(probs_out.size() == expected_probs.size());
+            for (std::size_t j = 0; j < probs_out.size(); ++j) {
+                CHECK(probs_out[j] == doctest::Approx(expected_probs[j]));
+            }
+        }
+    }
+
+    {
+        std::mt19937_64 rng1(3);
+        const auto [bitstrings_out, probs_out] = recover_configurations(
+            bitstrings, multiplicities, probabilities, avg_occupancies, num_elec, rng1,
+            SamplingMethod::fenwick_tree
+        );
+        double total = 0.0;
+        for (std::size_t j = 0; j < bitstrings_out.size(); ++j) {
+            CHECK(bitstrings_out[j].count() == 3);
+            total += probs_out[j];
+        }
+        CHECK(total == doctest::Approx(1.0));
+    }
+
+    const std::vector<std::uint64_t> short_multiplicities(
+        multiplicities.begin() + 1, multiplicities.end()
+    );
+    CHECK_THROWS_AS(
+        std::ignore = recover_configurations(
+            bitstrings, short_multiplicities, probabilities, avg_occupancies, num_elec,
+            rng
+        ),
+        std::invalid_argument
+    );
+}
+
+TEST_CASE("Flip candidates")
+{
+    std::mt19937_64 rng;
+    std::bernoulli_distribution coin(0.3);
+    std::uniform_real_distribution<double> real_dist(0.0, 1.0);
+    Qiskit::addon::sqd::internal::CorrectionScratch scratch;
+    for (std::size_t norb : {3, 63, 64, 70, 130}) {
+        std::array<std::array<std::vector<double>, 2>, 2> probs_table;
+        for (auto &sector : probs_table) {
+            for (auto &probs : sector) {
+                for (std::size_t j = 0; j < norb; ++j) {
+                    probs.push_back(real_dist(rng));
+                }
+            }
+        }
+        for (int trial = 0; trial < 10; ++trial) {
+            boost::dynamic_bitset<> bitstring(2 * norb);
+            for (std::size_t j = 0; j < 2 * norb; ++j) {
+                bitstring[j] = coin(rng);
+            }
+            const std::array<std::uint64_t, 2> num_elec{norb / 3, norb / 4};
+            const auto num_flip = Qiskit::addon::sqd::internal::_gather_flip_candidates(
+                bitstring, probs_table, num_elec, scratch
+            );
+            for (std::size_t s = 0; s < 2; ++s) {
+                std::uint64_t weight = 0;
+                for (std::size_t j = 0; j < norb; ++j) {
+                    weight += bitstring[s * norb + j];
+                }
+                const bool flip = weight > num_elec[s];
+                std::vector<std::size_t> expected_indices;
+                std::vector<double> expected_weights;
+                if (weight != num_elec[s]) {
+                    for (std::size_t j = 0; j < norb; ++j) {
+                        if (bitstring[s * norb + j] == flip) {
+                            expected_indices.push_back(s * norb + j);
+                            expected_weights.push_back(probs_table[s][flip][j]);
+                        }
+                    }
+                }
+                CHECK(
+                    num_flip[s] ==
+                    (flip ? weight - num_elec[s] : num_elec[s] - weight)
+                );
+                CHECK(scratch.indices[s] == expected_indices);
+                CHECK(scratch.weights[s] == expected_weights);
+            }
+        }
+    }
+}
+
+TEST_CASE("Correctors flip the same bits")
+{
+    using Qiskit::addon::sqd::SamplingMethod;
+    namespace internal = Qiskit::addon::sqd::internal;
+    std::mt19937_64 rng;
+    std::bernoulli_distribution coin(0.4);
+    std::uniform_real_distribution<double> real_dist(0.0, 1.0);
+    internal::CorrectionScratch scratch;
+    for (std::size_t norb : {3, 16, 20, 64, 70, 128, 130}) {
+        std::array<std::vector<double>, 2> avg_occupancies;
+        for (auto &occupancies : avg_occupancies) {
+            for (std::size_t j = 0; j < norb; ++j) {
+                occupancies.push_back(real_dist(rng));
+            }
+        }
+        const std::array<std::uint64_t, 2> num_elec{norb / 3, norb / 4};
+        const auto probs_table = internal::_make_probs_table(avg_occupancies, num_elec);
+        internal::WordsCorrector words_corrector(probs_table, num_elec);
+        for (const auto method :
+             {SamplingMethod::rejection, SamplingMethod::exponential_keys}) {
+            for (int trial = 0; trial < 10; ++trial) {
+                boost::dynamic_bitset<> bitstring(2 * norb);
+                for (std::size_t j = 0; j < 2 * norb; ++j) {
+                    bitstring[j] = coin(rng);
+                }
+                std::vector<std::uint64_t> words(internal::words_for_bits(2 * norb));
+                internal::WordsImpl<boost::dynamic_bitset<>>::copy(
+                    bitstring, words.data()
+                );
+                auto fixed_words = words;
+
+                auto rng1 = rng, rng2 = rng;
+                internal::_bipartite_bitstring_correcting(
+                    bitstring, probs_table, num_elec, scratch, rng, method
+                );
+                words_corrector.correct(words.data(), rng1, method);
+                internal::visit_corrector<boost::dynamic_bitset<>>(
+                    probs_table, num_elec,
+                    [&](auto &corrector) {
+                        corrector.correct(fixed_words.data(), rng2, method);
+                    }
+                );
+
+                std::vector<std::uint64_t> expected(words.size());
+                internal::WordsImpl<boost::dynamic_bitset<>>::copy(
+                    bitstring, expected.data()
+                );
+                CHECK(words == expected);
+                CHECK(fixed_words == expected);
+                CHECK(rng1 == rng);
+                CHECK(rng2 == rng);
+            }
+        }
+    }
+}
+
+TEST_CASE("Configuration recovery with std::bitset and boost::dynamic_bitset")
+{
+    using Qiskit::addon::sqd::AggregationMethod;
+    using Qiskit::addon::sqd::ParallelOptions;
+    constexpr std::size_t norb = 20;
+    std::mt19937_64 rng;
+    std::bernoulli_distribution coin(0.3);
+    std::uniform_real_distribution<double> real_dist(0.0, 1.0);
+    std::vector<std::bitset<2 * norb>> bitstrings;
+    std::vector<boost::dynamic_bitset<>> dynamic_bitstrings;
+    std::vector<double> probabilities;
+    for (int i = 0; i < 500; ++i) {
+        std::bitset<2 * norb> bitstring;
+        for (std::size_t j = 0; j < 2 * norb; ++j) {
+            bitstring[j] = coin(rng);
+        }
+        bitstrings.push_back(bitstring);
+        dynamic_bitstrings.emplace_back(2 * norb, bitstring.to_ullong());
+        probabilities.push_back(real_dist(rng));
+    }
+    std::array<std::vector<double>, 2> avg_occupancies;
+    for (auto &occupancies : avg_occupancies) {
+        for (std::size_t j = 0; j < norb; ++j) {
+            occupancies.push_back(real_dist(rng));
+        }
+    }
+    const std::array<std::uint64_t, 2> num_elec{5, 6};
+
+    const auto check_same = [&](const auto &result, const auto &dynamic_result) {
+        REQUIRE(result.first.size() == dynamic_result.first.size());
+        for (std::size_t i = 0; i < result.first.size(); ++i) {
+            CHECK(result.first[i].to_ullong() == dynamic_result.first[i].to_ulong());
+        }
+        CHECK(result.second == dynamic_result.second);
+    };
+    for (const auto aggregation :
+         {AggregationMethod::hash_map, AggregationMethod::sort_reduce}) {
+        auto rng1 = rng, rng2 = rng;
+        check_same(
+            recover_configurations(
+                bitstrings, probabilities, avg_occupancies, num_elec, rng1,
+                Qiskit::addon::sqd::SamplingMethod::rejection, aggregation
+            ),
+            recover_configurations(
+                dynamic_bitstrings, probabilities, avg_occupancies, num_elec, rng2,
+                Qiskit::addon::sqd::SamplingMethod::rejection, aggregation
+            )
+        );
+
+        ParallelOptions parallel_options;
+        parallel_options.num_threads = 3;
+        parallel_options.shard_size = 64;
+        check_same(
+            recover_configurations(
+                bitstrings, probabilities, avg_occupancies, num_elec,
+                parallel_options, Qiskit::addon::sqd::SamplingMethod::rejection,
+                aggregation
+            ),
+            recover_configurations(
+                dynamic_bitstrings, probabilities, avg_occupancies, num_elec,
+                parallel_options, Qiskit::addon::sqd::SamplingMethod::rejection,
+                aggregation
+            )
+        );
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Configuration recovery of no bitstrings of a fixed size", BitstringType,
+    std::bitset<8>, std::uint64_t
+)
+{
+    using Qiskit::addon::sqd::AggregationMethod;
+    namespace internal = Qiskit::addon::sqd::internal;
+
+    // The occupancies do not match the size of the type, which cannot be
+    // checked without any bitstrings
+    const std::array<std::vector<double>, 2> avg_occupancies{
+        std::vector<double>(40, 0.5), std::vector<double>(40, 0.5)
+    };
+    const std::array<std::uint64_t, 2> num_elec{20, 20};
+    const std::vector<BitstringType> bitstrings;
+    const std::vector<double> probabilities;
+    std::mt19937_64 rng;
+    for (const auto aggregation :
+         {AggregationMethod::hash_map, AggregationMethod::sort_reduce}) {
+        const auto [new_bitstrings, new_probs] = recover_configurations(
+            bitstrings, probabilities, avg_occupancies, num_elec, rng,
+            Qiskit::addon::sqd::SamplingMethod::rejection, aggregation
+        );
+        CHECK(new_bitstrings.empty());
+        CHECK(new_probs.empty());
+
+        Qiskit::addon::sqd::ParallelOptions options;
+        options.num_threads = 2;
+        const auto [parallel_bitstrings, parallel_probs] = recover_configurations(
+            bitstrings, probabilities, avg_occupancies, num_elec, options,
+            Qiskit::addon::sqd::SamplingMethod::rejection, aggregation
+        );
+        CHECK(parallel_bitstrings.empty());
+        CHECK(parallel_probs.empty());
+    }
+
+    Qiskit::addon::sqd::ConfigurationRecoverer recoverer(
+        bitstrings, probabilities, num_elec
+    );
+    recoverer.update_occupancies(avg_occupancies);
+    recoverer.run(rng);
+    CHECK(recoverer.size() == 0);
+
+    // A table which does not match the type gets a corrector sized for it
+    const auto probs_table = internal::_make_probs_table(avg_occupancies, num_elec);
+    using ExactCorrector = internal::FixedSizeCorrector<
+        internal::FixedSizeImpl<BitstringType>::value / 2, true>;
+    internal::visit_corrector<BitstringType>(
+        probs_table, num_elec,
+        [](const auto &corrector) {
+            using CorrectorType = std::decay_t<decltype(corrector)>;
+            CHECK(!std::is_same_v<CorrectorType, ExactCorrector>);
+        }
+    );
+}
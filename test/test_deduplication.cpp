@@ -0,0 +1,300 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "qiskit/addon/sqd/deduplication.hpp"
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "qiskit/addon/sqd/configuration_recovery.hpp"
+#include "qiskit/addon/sqd/subsampling.hpp"
+
+#include "bitstring_helpers.hpp"
+
+using Qiskit::addon::sqd::AggregationMethod;
+using Qiskit::addon::sqd::PackedBitstringVector;
+using DynamicBitset = PackedBitstringVector::value_type;
+
+namespace
+{
+
+// Raw shots drawn from a small population, so that most are duplicates
+std::vector<DynamicBitset>
+random_shots(std::size_t num_bits, std::size_t num_shots, std::mt19937_64 &rng)
+{
+    const auto population = random_bitstrings(num_bits, 50, rng);
+    std::uniform_int_distribution<std::size_t> pick(0, population.size() - 1);
+    std::vector<DynamicBitset> shots;
+    for (std::size_t i = 0; i < num_shots; ++i) {
+        shots.push_back(population[pick(rng)]);
+    }
+    return shots;
+}
+
+// Ascending order, regarding each bitstring as an unsigned integer
+bool less_as_integer(const DynamicBitset &a, const DynamicBitset &b)
+{
+    for (auto i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) {
+            return b[i];
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_CASE("Deduplicate bitstrings")
+{
+    std::mt19937_64 rng;
+    for (const std::size_t num_bits : {6u, 64u, 130u}) {
+        const auto shots = random_shots(num_bits, 2000, rng);
+        std::vector<double> weights;
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        for (std::size_t i = 0; i < shots.size(); ++i) {
+            weights.push_back(dist(rng));
+        }
+
+        // Sum the weights of each bitstring in order of occurrence, as expected
+        std::vector<DynamicBitset> expected_bitstrings;
+        std::vector<double> expected_weights;
+        std::vector<std::uint64_t> expected_counts;
+        std::map<DynamicBitset, std::size_t> index;
+        for (std::size_t i = 0; i < shots.size(); ++i) {
+            const auto [it, inserted] =
+                index.emplace(shots[i], expected_weights.size());
+            if (inserted) {
+                expected_bitstrings.push_back(shots[i]);
+                expected_weights.push_back(0.0);
+                expected_counts.push_back(0);
+            }
+            expected_weights[it->second] += weights[i];
+            ++expected_counts[it->second];
+        }
+
+        SUBCASE("In order of first occurrence")
+        {
+            const auto [bitstrings, new_weights] =
+                Qiskit::addon::sqd::deduplicate_bitstrings(shots, weights);
+            CHECK(bitstrings == expected_bitstrings);
+            CHECK(new_weights == expected_weights);
+
+            const auto [counted_bitstrings, counts] =
+                Qiskit::addon::sqd::deduplicate_bitstrings(shots);
+            CHECK(counted_bitstrings == expected_bitstrings);
+            CHECK(counts == expected_counts);
+
+            const auto [packed_bitstrings, packed_weights] =
+                Qiskit::addon::sqd::deduplicate_bitstrings(pack(shots), weights);
+            CHECK(packed_bitstrings == pack(expected_bitstrings));
+            CHECK(packed_weights == expected_weights);
+        }
+        SUBCASE("In ascending order")
+        {
+            std::vector<std::size_t> order(expected_bitstrings.size());
+            for (std::size_t j = 0; j < order.size(); ++j) {
+                order[j] = j;
+            }
+            std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                return less_as_integer(expected_bitstrings[a], expected_bitstrings[b]);
+            });
+            std::vector<DynamicBitset> sorted_bitstrings;
+            std::vector<double> sorted_weights;
+            std::vector<std::uint64_t> sorted_counts;
+            for (const auto j : order) {
+                sorted_bitstrings.push_back(expected_bitstrings[j]);
+                sorted_weights.push_back(expected_weights[j]);
+                sorted_counts.push_back(expected_counts[j]);
+            }
+
+            const auto [bitstrings, new_weights] =
+                Qiskit::addon::sqd::deduplicate_bitstrings(
+                    shots, weights, AggregationMethod::sort_reduce
+                );
+            CHECK(bitstrings == sorted_bitstrings);
+            CHECK(new_weights == sorted_weights);
+
+            const auto [counted_bitstrings, counts] =
+                Qiskit::addon::sqd::deduplicate_bitstrings(
+                    pack(shots), AggregationMethod::sort_reduce
+                );
+            CHECK(counted_bitstrings == pack(sorted_bitstrings));
+            CHECK(counts == sorted_counts);
+        }
+        SUBCASE("On multiple threads")
+        {
+            for (const auto method :
+                 {AggregationMethod::hash_map, AggregationMethod::sort_reduce}) {
+                const auto expected =
+                    Qiskit::addon::sqd::deduplicate_bitstrings(shots, weights, method);
+                const auto expected_counted =
+                    Qiskit::addon::sqd::deduplicate_bitstrings(shots, method);
+                for (const unsigned int num_threads : {1u, 3u, 8u}) {
+                    for (const std::size_t shard_size : {1u, 37u, 5000u}) {
+                        Qiskit::addon::sqd::ParallelOptions options;
+                        options.num_threads = num_threads;
+                        options.shard_size = shard_size;
+                        CHECK(
+                            Qiskit::addon::sqd::deduplicate_bitstrings(
+                                shots, weights, options, method
+                            ) == expected
+                        );
+                        CHECK(
+                            Qiskit::addon::sqd::deduplicate_bitstrings(
+                                shots, options, method
+                            ) == expected_counted
+                        );
+                        const auto [packed_bitstrings, packed_counts] =
+                            Qiskit::addon::sqd::deduplicate_bitstrings(
+                                pack(shots), options, method
+                            );
+                        CHECK(packed_bitstrings == pack(expected_counted.first));
+                        CHECK(packed_counts == expected_counted.second);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Deduplicate native bitstrings")
+{
+    const std::vector<std::uint64_t> shots{5, 3, 5, 9, 3, 5};
+    const auto [bitstrings, counts] = Qiskit::addon::sqd::deduplicate_bitstrings(shots);
+    CHECK(bitstrings == std::vector<std::uint64_t>{5, 3, 9});
+    CHECK(counts == std::vector<std::uint64_t>{3, 2, 1});
+
+    Qiskit::addon::sqd::ParallelOptions options;
+    options.num_threads = 2;
+    options.shard_size = 2;
+    const auto [sorted_bitstrings, sorted_counts] =
+        Qiskit::addon::sqd::deduplicate_bitstrings(
+            shots, options, AggregationMethod::sort_reduce
+        );
+    CHECK(sorted_bitstrings == std::vector<std::uint64_t>{3, 5, 9});
+    CHECK(sorted_counts == std::vector<std::uint64_t>{2, 3, 1});
+}
+
+TEST_CASE("Deduplicate bitstrings with the default block type")
+{
+    std::mt19937_64 rng;
+    const auto shots = random_shots(70, 500, rng);
+    std::vector<boost::dynamic_bitset<>> default_shots;
+    for (const auto &bs : shots) {
+        boost::dynamic_bitset<> converted(bs.size());
+        for (std::size_t j = 0; j < bs.size(); ++j) {
+            converted[j] = bs[j];
+        }
+        default_shots.push_back(converted);
+    }
+    const auto [expected_bitstrings, expected_counts] =
+        Qiskit::addon::sqd::deduplicate_bitstrings(shots);
+    const auto [bitstrings, counts] =
+        Qiskit::addon::sqd::deduplicate_bitstrings(default_shots);
+    CHECK(counts == expected_counts);
+    REQUIRE(bitstrings.size() == expected_bitstrings.size());
+    for (std::size_t i = 0; i < bitstrings.size(); ++i) {
+        CHECK(bitstrings[i].size() == expected_bitstrings[i].size());
+        CHECK(bitstrings[i].count() == expected_bitstrings[i].count());
+    }
+
+    // The default block type can be packed and deduplicated as well
+    PackedBitstringVector packed;
+    for (const auto &bs : default_shots) {
+        packed.push_back(bs);
+    }
+    CHECK(packed == pack(shots));
+    const auto [packed_bitstrings, packed_counts] =
+        Qiskit::addon::sqd::deduplicate_bitstrings(packed);
+    CHECK(packed_bitstrings == pack(expected_bitstrings));
+    CHECK(packed_counts == expected_counts);
+    for (std::size_t i = 0; i < bitstrings.size(); ++i) {
+        CHECK(packed_bitstrings[i] == bitstrings[i]);
+    }
+}
+
+TEST_CASE("Deduplicate empty input")
+{
+    const std::vector<DynamicBitset> shots;
+    const auto [bitstrings, weights] =
+        Qiskit::addon::sqd::deduplicate_bitstrings(shots, std::vector<double>{});
+    CHECK(bitstrings.empty());
+    CHECK(weights.empty());
+    const Qiskit::addon::sqd::ParallelOptions options;
+    const auto [counted_bitstrings, counts] =
+        Qiskit::addon::sqd::deduplicate_bitstrings(shots, options);
+    CHECK(counted_bitstrings.empty());
+    CHECK(counts.empty());
+}
+
+TEST_CASE("Deduplicated shots as input to other routines")
+{
+    std::mt19937_64 rng;
+    const std::size_t norb = 8;
+    const auto shots = random_shots(2 * norb, 500, rng);
+    const auto [bitstrings, counts] = Qiskit::addon::sqd::deduplicate_bitstrings(shots);
+    const std::vector<double> weights(counts.begin(), counts.end());
+
+    // Subsampling draws from the unique bitstrings
+    const auto batch = Qiskit::addon::sqd::subsample(bitstrings, weights, 20, rng);
+    std::map<DynamicBitset, int> seen;
+    for (const auto &bs : batch) {
+        CHECK(++seen[bs] == 1);
+    }
+
+    // Configuration recovery takes the counts as multiplicities
+    const std::array<std::vector<double>, 2> avg_occupancies{
+        std::vector<double>(norb, 0.4), std::vector<double>(norb, 0.6)
+    };
+    const auto [recovered_bitstrings, recovered_probs] =
+        Qiskit::addon::sqd::recover_configurations(
+            bitstrings, counts, weights, avg_occupancies, {3, 5}, rng
+        );
+    CHECK(!recovered_bitstrings.empty());
+    double total = 0.0;
+    for (std::size_t i = 0; i < recovered_bitstrings.size(); ++i) {
+        const auto &bs = recovered_bitstrings[i];
+        CHECK((bs & DynamicBitset(2 * norb, (1u << norb) - 1)).count() == 3);
+        CHECK(bs.count() == 8);
+        total += recovered_probs[i];
+    }
+    CHECK(total == doctest::Approx(1.0));
+}
+
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+TEST_CASE("Deduplicate invalid input")
+{
+    const std::vector<DynamicBitset> shots{DynamicBitset(4, 1), DynamicBitset(6, 1)};
+    using Qiskit::addon::sqd::deduplicate_bitstrings;
+    CHECK_THROWS_AS(
+        std::ignore = deduplicate_bitstrings(shots, std::vector<double>{1.0}),
+        std::invalid_argument
+    );
+    CHECK_THROWS_AS(std::ignore = deduplicate_bitstrings(shots), std::invalid_argument);
+    Qiskit::addon::sqd::ParallelOptions options;
+    options.shard_size = 0;
+    CHECK_THROWS_AS(
+        std::ignore = deduplicate_bitstrings(shots, options), std::invalid_argument
+    );
+}
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
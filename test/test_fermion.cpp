@@ -12,8 +12,19 @@
 
 #include "qiskit/addon/sqd/fermion.hpp"
 
+#include <algorithm>
 #include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "bitset_compat.hpp"
@@ -22,6 +33,42 @@
 
 using Qiskit::addon::sqd::internal::HalfSize;
 
+#if !QKA_SQD_DISABLE_EXCEPTIONS && !(_MSVC_LANG == 202002L)
+#define BITSET2_IF_AVAILABLE , Bitset2::bitset2<6>, Bitset2::bitset2<130, std::uint8_t>
+#else
+#define BITSET2_IF_AVAILABLE
+#endif
+
+namespace
+{
+
+template <typename T, typename = void>
+struct IsResizable : std::false_type {
+};
+
+template <typename T>
+struct IsResizable<T, std::void_t<decltype(std::declval<T &>().resize(0))>>
+  : std::true_type {
+};
+
+// Draw a random bitstring of `num_bits` bits, or of the size of `BitstringType`
+// if it is fixed.
+template <typename BitstringType>
+BitstringType random_bitstring(std::size_t num_bits, std::mt19937_64 &rng)
+{
+    std::bernoulli_distribution coin;
+    BitstringType bitstring;
+    if constexpr (IsResizable<BitstringType>::value) {
+        bitstring.resize(num_bits);
+    }
+    for (std::size_t i = 0; i < bitstring.size(); ++i) {
+        bitstring.set(i, coin(rng));
+    }
+    return bitstring;
+}
+
+} // namespace
+
 TEST_CASE_TEMPLATE(
     "Bitstrings to CI strings", BitstringType, std::bitset<6>, boost::dynamic_bitset<>
 )
@@ -47,3 +94,156 @@ TEST_CASE_TEMPLATE(
     }
     CHECK(expected.empty());
 }
+
+TEST_CASE_TEMPLATE(
+    "Splitting bitstrings", BitstringType, std::bitset<6>, std::bitset<64>,
+    std::bitset<130>, boost::dynamic_bitset<>,
+    boost::dynamic_bitset<std::uint8_t> BITSET2_IF_AVAILABLE
+)
+{
+    using Qiskit::addon::sqd::internal::split_bitstring;
+    std::mt19937_64 rng;
+    HalfSize<BitstringType> right_out, left_out;
+    for (std::size_t num_bits : {0u, 6u, 64u, 66u, 130u}) {
+        const auto bitstring = random_bitstring<BitstringType>(num_bits, rng);
+        const auto half_N = bitstring.size() / 2;
+        const auto [right, left] = split_bitstring(bitstring);
+        REQUIRE(right.size() == half_N);
+        REQUIRE(left.size() == half_N);
+        for (std::size_t i = 0; i < half_N; ++i) {
+            CHECK(right[i] == bitstring[i]);
+            CHECK(left[i] == bitstring[i + half_N]);
+        }
+        if constexpr (IsResizable<BitstringType>::value) {
+            // Split into existing bitsets, reusing their storage
+            split_bitstring(bitstring, right_out, left_out);
+            CHECK(right_out == right);
+            CHECK(left_out == left);
+        }
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Bitstrings to CI strings counts duplicates", BitstringType, std::bitset<130>,
+    boost::dynamic_bitset<>, boost::dynamic_bitset<std::uint8_t>
+)
+{
+    constexpr std::size_t N = 130;
+    std::mt19937_64 rng;
+    // Draw from a small pool, so that many CI strings repeat
+    std::vector<BitstringType> pool;
+    for (std::size_t i = 0; i < 20; ++i) {
+        pool.push_back(random_bitstring<BitstringType>(N, rng));
+    }
+    std::uniform_int_distribution<std::size_t> index_dist(0, pool.size() - 1);
+    std::vector<BitstringType> bitstrings;
+    std::map<std::vector<bool>, unsigned int> expected_counts;
+    for (std::size_t i = 0; i < 500; ++i) {
+        const auto &bitstring = pool[index_dist(rng)];
+        bitstrings.push_back(bitstring);
+        for (std::size_t s = 0; s < 2; ++s) {
+            std::vector<bool> ci_string(N / 2);
+            for (std::size_t j = 0; j < N / 2; ++j) {
+                ci_string[j] = bitstring[s * N / 2 + j];
+            }
+            ++expected_counts[ci_string];
+        }
+    }
+
+    const auto ci_strings =
+        Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(bitstrings);
+    REQUIRE(ci_strings.size() == expected_counts.size());
+    unsigned int previous_count = static_cast<unsigned int>(bitstrings.size());
+    for (const auto &ci_string : ci_strings) {
+        REQUIRE(ci_string.size() == N / 2);
+        std::vector<bool> bits(N / 2);
+        for (std::size_t j = 0; j < N / 2; ++j) {
+            bits[j] = ci_string[j];
+        }
+        // The CI strings are returned in order of decreasing count
+        const auto count = expected_counts.at(bits);
+        CHECK(count <= previous_count);
+        previous_count = count;
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Bitstrings to CI strings ties and truncation", BitstringType, std::bitset<6>,
+    boost::dynamic_bitset<>
+)
+{
+    constexpr unsigned int N = 6;
+    std::vector<BitstringType> bitstrings;
+    BitstringType bs;
+    set_bitset(N, bs, 0b001010);
+    bitstrings.push_back(bs);
+    set_bitset(N, bs, 0b100010);
+    bitstrings.push_back(bs);
+    std::vector<HalfSize<BitstringType>> expected(3);
+    set_bitset(N / 2, expected[0], 0b010);
+    set_bitset(N / 2, expected[1], 0b001);
+    set_bitset(N / 2, expected[2], 0b100);
+
+    // Equal counts are ordered by first occurrence
+    CHECK(
+        Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(bitstrings) ==
+        expected
+    );
+    for (unsigned int max_dimension : {0u, 1u, 2u, 3u, 4u}) {
+        auto truncated = expected;
+        truncated.resize(std::min<std::size_t>(max_dimension, expected.size()));
+        CHECK(
+            Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(
+                bitstrings, max_dimension
+            ) == truncated
+        );
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Parallel bitstrings to CI strings", BitstringType, std::bitset<130>,
+    boost::dynamic_bitset<>
+)
+{
+    using Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin;
+    constexpr std::size_t N = 130;
+    std::mt19937_64 rng;
+    std::vector<BitstringType> pool;
+    for (std::size_t i = 0; i < 50; ++i) {
+        pool.push_back(random_bitstring<BitstringType>(N, rng));
+    }
+    std::uniform_int_distribution<std::size_t> index_dist(0, pool.size() - 1);
+    std::vector<BitstringType> bitstrings;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        bitstrings.push_back(pool[index_dist(rng)]);
+    }
+    const std::vector<HalfSize<BitstringType>> include{
+        random_bitstring<HalfSize<BitstringType>>(N / 2, rng)
+    };
+
+    Qiskit::addon::sqd::ParallelOptions options;
+    for (std::optional<unsigned int> max_dimension :
+         {std::optional<unsigned int>(), std::optional<unsigned int>(10)}) {
+        const auto expected = bitstrings_to_ci_strings_symmetrize_spin(
+            bitstrings, max_dimension, std::cref(include)
+        );
+        CHECK(expected.front() == include.front());
+        for (std::size_t shard_size : {1u, 64u, 5000u}) {
+            for (unsigned int num_threads : {1u, 3u}) {
+                options.shard_size = shard_size;
+                options.num_threads = num_threads;
+                CHECK(
+                    bitstrings_to_ci_strings_symmetrize_spin(
+                        bitstrings, options, max_dimension, std::cref(include)
+                    ) == expected
+                );
+            }
+        }
+    }
+
+    options.shard_size = 0;
+    CHECK_THROWS_AS(
+        std::ignore = bitstrings_to_ci_strings_symmetrize_spin(bitstrings, options),
+        std::invalid_argument
+    );
+}
@@ -0,0 +1,530 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "qiskit/addon/sqd/support/native_bitstrings.hpp"
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "qiskit/addon/sqd/configuration_recovery.hpp"
+#include "qiskit/addon/sqd/deduplication.hpp"
+#include "qiskit/addon/sqd/fermion.hpp"
+#include "qiskit/addon/sqd/native_bitstring_vector.hpp"
+#include "qiskit/addon/sqd/postselection.hpp"
+#include "qiskit/addon/sqd/subsampling.hpp"
+
+namespace internal = Qiskit::addon::sqd::internal;
+using internal::HalfSize;
+using Qiskit::addon::sqd::NativeBitstring;
+using Qiskit::addon::sqd::NativeBitstringVector;
+
+static_assert(std::is_same_v<HalfSize<std::uint64_t>, std::uint32_t>);
+static_assert(std::is_same_v<HalfSize<std::uint16_t>, std::uint8_t>);
+static_assert(std::is_same_v<
+              HalfSize<std::array<std::uint64_t, 4>>, std::array<std::uint64_t, 2>>);
+static_assert(std::is_same_v<
+              HalfSize<NativeBitstring<std::uint64_t>>,
+              NativeBitstring<std::uint32_t>>);
+#if defined(__SIZEOF_INT128__)
+static_assert(std::is_same_v<HalfSize<internal::native_uint128>, std::uint64_t>);
+#endif // defined(__SIZEOF_INT128__)
+
+namespace
+{
+
+// A native bitstring type, and the `std::bitset` of the same size
+template <typename NativeType, std::size_t N>
+struct NativeAndBitset {
+    using Native = NativeType;
+    using Bitset = std::bitset<N>;
+    static constexpr std::size_t num_bits = N;
+};
+
+template <typename BitstringType>
+std::vector<std::uint64_t> to_words(const BitstringType &bitstring)
+{
+    std::vector<std::uint64_t> words(
+        internal::words_for_bits(internal::bitstring_size(bitstring))
+    );
+    internal::WordsImpl<BitstringType>::copy(bitstring, words.data());
+    return words;
+}
+
+template <typename BitstringType>
+std::vector<std::vector<std::uint64_t>>
+to_words(const std::vector<BitstringType> &bitstrings)
+{
+    std::vector<std::vector<std::uint64_t>> retval;
+    for (const auto &bitstring : bitstrings) {
+        retval.push_back(to_words(bitstring));
+    }
+    return retval;
+}
+
+template <typename T>
+std::vector<std::vector<std::uint64_t>>
+to_words(const NativeBitstringVector<T> &bitstrings)
+{
+    std::vector<std::vector<std::uint64_t>> retval;
+    for (const auto &bitstring : bitstrings) {
+        retval.push_back(to_words(bitstring));
+    }
+    return retval;
+}
+
+// Draw bitstrings of `num_bits` bits, each set with probability 0.3, as both
+// types.
+template <typename NativeType, typename BitsetType>
+std::pair<std::vector<NativeType>, std::vector<BitsetType>>
+random_bitstrings(std::size_t num_bits, std::size_t count, std::mt19937_64 &rng)
+{
+    std::bernoulli_distribution coin(0.3);
+    std::vector<NativeType> natives(count);
+    std::vector<BitsetType> bitsets(count);
+    std::vector<std::uint64_t> words(internal::words_for_bits(num_bits));
+    for (std::size_t i = 0; i < count; ++i) {
+        std::fill(words.begin(), words.end(), std::uint64_t{0});
+        for (std::size_t j = 0; j < num_bits; ++j) {
+            if (coin(rng)) {
+                words[j / 64] |= std::uint64_t{1} << (j % 64);
+            }
+        }
+        using internal::AssignWordsImpl;
+        AssignWordsImpl<NativeType>::assign(natives[i], words.data(), num_bits);
+        AssignWordsImpl<BitsetType>::assign(bitsets[i], words.data(), num_bits);
+    }
+    return {std::move(natives), std::move(bitsets)};
+}
+
+} // namespace
+
+#if defined(__SIZEOF_INT128__)
+#define INT128_IF_AVAILABLE , NativeAndBitset<internal::native_uint128, 128>
+#else
+#define INT128_IF_AVAILABLE
+#endif
+
+#define NATIVE_BITSTRING_TYPES                                                      \
+    NativeAndBitset<std::uint32_t, 32>, NativeAndBitset<std::uint64_t, 64>,           \
+        NativeAndBitset<std::array<std::uint64_t, 2>, 128>,                           \
+        NativeAndBitset<std::array<std::uint64_t, 4>, 256> INT128_IF_AVAILABLE
+
+TEST_CASE_TEMPLATE("Native bitstring traits", Types, NATIVE_BITSTRING_TYPES)
+{
+    using Native = typename Types::Native;
+    using Bitset = typename Types::Bitset;
+    constexpr auto N = Types::num_bits;
+    std::mt19937_64 rng;
+    const auto [natives, bitsets] = random_bitstrings<Native, Bitset>(N, 100, rng);
+
+    CHECK(internal::FixedSizeImpl<Native>::value == N);
+    for (std::size_t i = 0; i < natives.size(); ++i) {
+        const auto &native = natives[i];
+        const auto &bitset = bitsets[i];
+        CHECK(internal::bitstring_size(native) == N);
+        CHECK(to_words(native) == to_words(bitset));
+        CHECK(
+            internal::RightLeftHammingImpl<Native>::count(native) ==
+            internal::RightLeftHammingImpl<Bitset>::count(bitset)
+        );
+
+        const auto [right, left] = internal::split_bitstring(native);
+        const auto [expected_right, expected_left] = internal::split_bitstring(bitset);
+        CHECK(to_words(right) == to_words(expected_right));
+        CHECK(to_words(left) == to_words(expected_left));
+
+        for (const std::size_t j : {std::size_t{0}, N / 2 - 1, N / 2, N - 1}) {
+            auto flipped = native;
+            auto expected = bitset;
+            internal::FlipImpl<Native>::flip(flipped, j);
+            expected.flip(j);
+            CHECK(to_words(flipped) == to_words(expected));
+        }
+    }
+}
+
+TEST_CASE_TEMPLATE("Algorithms on native bitstrings", Types, NATIVE_BITSTRING_TYPES)
+{
+    using Native = typename Types::Native;
+    using Bitset = typename Types::Bitset;
+    constexpr auto N = Types::num_bits;
+    constexpr auto norb = N / 2;
+    constexpr std::uint64_t n_alpha = norb * 3 / 10, n_beta = norb * 3 / 10 + 1;
+    std::mt19937_64 rng;
+    const auto [natives, bitsets] = random_bitstrings<Native, Bitset>(N, 500, rng);
+    std::vector<double> weights;
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    for (std::size_t i = 0; i < natives.size(); ++i) {
+        weights.push_back(dist(rng));
+    }
+
+    SUBCASE("Postselection")
+    {
+        const Qiskit::addon::sqd::MatchesRightLeftHamming filter(n_alpha, n_beta);
+        const auto [expected_bitstrings, expected_weights] =
+            Qiskit::addon::sqd::postselect_bitstrings(bitsets, weights, filter);
+        const auto [new_bitstrings, new_weights] =
+            Qiskit::addon::sqd::postselect_bitstrings(natives, weights, filter);
+        CHECK(!new_bitstrings.empty());
+        CHECK(to_words(new_bitstrings) == to_words(expected_bitstrings));
+        CHECK(new_weights == expected_weights);
+    }
+    SUBCASE("Subsampling")
+    {
+        std::mt19937_64 rng1, rng2;
+        const auto expected = Qiskit::addon::sqd::subsample(bitsets, weights, 50, rng1);
+        const auto batch = Qiskit::addon::sqd::subsample(natives, weights, 50, rng2);
+        CHECK(to_words(batch) == to_words(expected));
+    }
+    SUBCASE("Configuration recovery")
+    {
+        std::array<std::vector<double>, 2> avg_occupancies;
+        for (auto &occs : avg_occupancies) {
+            for (std::size_t i = 0; i < norb; ++i) {
+                occs.push_back(dist(rng));
+            }
+        }
+        std::mt19937_64 rng1, rng2;
+        const auto [expected_bitstrings, expected_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                bitsets, weights, avg_occupancies, {n_alpha, n_beta}, rng1
+            );
+        const auto [new_bitstrings, new_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                natives, weights, avg_occupancies, {n_alpha, n_beta}, rng2
+            );
+        CHECK(to_words(new_bitstrings) == to_words(expected_bitstrings));
+        CHECK(new_probs == expected_probs);
+
+        const std::vector<unsigned int> multiplicities(natives.size(), 3);
+        const auto [expected_repeated_bitstrings, expected_repeated_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                bitsets, multiplicities, weights, avg_occupancies, {n_alpha, n_beta},
+                rng1
+            );
+        const auto [repeated_bitstrings, repeated_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                natives, multiplicities, weights, avg_occupancies, {n_alpha, n_beta},
+                rng2
+            );
+        CHECK(
+            to_words(repeated_bitstrings) == to_words(expected_repeated_bitstrings)
+        );
+        CHECK(repeated_probs == expected_repeated_probs);
+
+        Qiskit::addon::sqd::ParallelOptions options;
+        options.num_threads = 2;
+        options.shard_size = 64;
+        const auto [expected_parallel_bitstrings, expected_parallel_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                bitsets, weights, avg_occupancies, {n_alpha, n_beta}, options
+            );
+        const auto [parallel_bitstrings, parallel_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                natives, weights, avg_occupancies, {n_alpha, n_beta}, options
+            );
+        CHECK(
+            to_words(parallel_bitstrings) == to_words(expected_parallel_bitstrings)
+        );
+        CHECK(parallel_probs == expected_parallel_probs);
+
+        Qiskit::addon::sqd::ConfigurationRecoverer recoverer(
+            natives, weights, {n_alpha, n_beta}
+        );
+        recoverer.update_occupancies(avg_occupancies);
+        recoverer.run(rng2);
+        Qiskit::addon::sqd::ConfigurationRecoverer expected_recoverer(
+            bitsets, weights, {n_alpha, n_beta}
+        );
+        expected_recoverer.update_occupancies(avg_occupancies);
+        expected_recoverer.run(rng1);
+        CHECK(
+            to_words(recoverer.result().first) ==
+            to_words(expected_recoverer.result().first)
+        );
+        CHECK(recoverer.result().second == expected_recoverer.result().second);
+    }
+    SUBCASE("CI strings")
+    {
+        const auto expected =
+            Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(bitsets);
+        const auto ci_strings =
+            Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(natives);
+        CHECK(to_words(ci_strings) == to_words(expected));
+
+        Qiskit::addon::sqd::ParallelOptions options;
+        options.num_threads = 2;
+        options.shard_size = 64;
+        auto expected_top = to_words(expected);
+        expected_top.resize(std::min<std::size_t>(expected_top.size(), 20));
+        const auto top =
+            Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(
+                natives, options, 20
+            );
+        CHECK(to_words(top) == expected_top);
+    }
+}
+
+#if defined(__SIZEOF_INT128__)
+#define SIZED_INT128_IF_AVAILABLE , NativeAndBitset<internal::native_uint128, 100>
+#else
+#define SIZED_INT128_IF_AVAILABLE
+#endif
+
+// Bitstrings shorter than their integer type, as well as one which fills it
+#define SIZED_NATIVE_BITSTRING_TYPES                                                \
+    NativeAndBitset<std::uint16_t, 10>, NativeAndBitset<std::uint32_t, 28>,           \
+        NativeAndBitset<std::uint64_t, 60>,                                           \
+        NativeAndBitset<std::uint64_t, 64> SIZED_INT128_IF_AVAILABLE
+
+TEST_CASE_TEMPLATE(
+    "Native bitstrings of a run-time length", Types, SIZED_NATIVE_BITSTRING_TYPES
+)
+{
+    using Native = typename Types::Native;
+    using Bitset = typename Types::Bitset;
+    using Sized = NativeBitstring<Native>;
+    using Ref = typename NativeBitstringVector<Native>::reference;
+    constexpr auto N = Types::num_bits;
+    std::mt19937_64 rng;
+    const auto [natives, bitsets] = random_bitstrings<Native, Bitset>(N, 100, rng);
+
+    CHECK(internal::FixedSizeImpl<Sized>::value == 0);
+    NativeBitstringVector<Native> vec;
+    for (std::size_t i = 0; i < natives.size(); ++i) {
+        const Sized native(natives[i], N);
+        const auto &bitset = bitsets[i];
+        vec.push_back(native);
+        CHECK(internal::bitstring_size(native) == N);
+        CHECK(native.count() == bitset.count());
+        CHECK(to_words(native) == to_words(bitset));
+        CHECK(
+            internal::RightLeftHammingImpl<Sized>::count(native) ==
+            internal::RightLeftHammingImpl<Bitset>::count(bitset)
+        );
+
+        const auto [right, left] = internal::split_bitstring(native);
+        const auto [expected_right, expected_left] = internal::split_bitstring(bitset);
+        CHECK(right.size() == N / 2);
+        CHECK(to_words(right) == to_words(expected_right));
+        CHECK(to_words(left) == to_words(expected_left));
+
+        for (const std::size_t j : {std::size_t{0}, N / 2 - 1, N / 2, N - 1}) {
+            auto flipped = native;
+            auto expected = bitset;
+            internal::FlipImpl<Sized>::flip(flipped, j);
+            expected.flip(j);
+            CHECK(to_words(flipped) == to_words(expected));
+        }
+    }
+
+    // The elements of a non-const container are references
+    CHECK(vec.num_bits() == N);
+    CHECK(vec.size() == natives.size());
+    for (std::size_t i = 0; i < natives.size(); ++i) {
+        const Ref ref = vec[i];
+        CHECK(ref == Sized(natives[i], N));
+        CHECK(vec.data()[i] == natives[i]);
+        CHECK(to_words(ref) == to_words(bitsets[i]));
+        CHECK(
+            internal::RightLeftHammingImpl<Ref>::count(ref) ==
+            internal::RightLeftHammingImpl<Bitset>::count(bitsets[i])
+        );
+    }
+    vec[0] = vec[1];
+    CHECK(vec[0] == Sized(natives[1], N));
+    vec[0].flip(N - 1);
+    auto expected = bitsets[1];
+    expected.flip(N - 1);
+    CHECK(to_words(vec[0]) == to_words(expected));
+    CHECK(
+        NativeBitstringVector<Native>(N, std::vector<Native>(natives)) ==
+        NativeBitstringVector<Native>(N, std::vector<Native>(natives))
+    );
+}
+
+TEST_CASE_TEMPLATE(
+    "Algorithms on native bitstrings of a run-time length", Types,
+    SIZED_NATIVE_BITSTRING_TYPES
+)
+{
+    using Native = typename Types::Native;
+    using Bitset = typename Types::Bitset;
+    constexpr auto N = Types::num_bits;
+    constexpr auto norb = N / 2;
+    constexpr std::uint64_t n_alpha = norb * 3 / 10, n_beta = norb * 3 / 10 + 1;
+    std::mt19937_64 rng;
+    const auto [raw_natives, bitsets] = random_bitstrings<Native, Bitset>(N, 500, rng);
+    const NativeBitstringVector<Native> natives(N, raw_natives);
+    std::vector<double> weights;
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    for (std::size_t i = 0; i < natives.size(); ++i) {
+        weights.push_back(dist(rng));
+    }
+
+    SUBCASE("Postselection")
+    {
+        const Qiskit::addon::sqd::MatchesRightLeftHamming filter(n_alpha, n_beta);
+        const auto [expected_bitstrings, expected_weights] =
+            Qiskit::addon::sqd::postselect_bitstrings(bitsets, weights, filter);
+        const auto [new_bitstrings, new_weights] =
+            Qiskit::addon::sqd::postselect_bitstrings(natives, weights, filter);
+        CHECK(!new_bitstrings.empty());
+        CHECK(new_bitstrings.num_bits() == N);
+        CHECK(to_words(new_bitstrings) == to_words(expected_bitstrings));
+        CHECK(new_weights == expected_weights);
+
+        auto inplace_bitstrings = natives;
+        auto inplace_weights = weights;
+        Qiskit::addon::sqd::postselect_bitstrings_inplace(
+            inplace_bitstrings, inplace_weights, filter
+        );
+        CHECK(inplace_bitstrings == new_bitstrings);
+        CHECK(inplace_weights == new_weights);
+    }
+    SUBCASE("Subsampling")
+    {
+        std::mt19937_64 rng1, rng2;
+        const auto expected = Qiskit::addon::sqd::subsample(bitsets, weights, 50, rng1);
+        const auto batch = Qiskit::addon::sqd::subsample(natives, weights, 50, rng2);
+        CHECK(to_words(batch) == to_words(expected));
+    }
+    SUBCASE("Deduplication")
+    {
+        const auto [expected_bitstrings, expected_counts] =
+            Qiskit::addon::sqd::deduplicate_bitstrings(bitsets);
+        const auto [new_bitstrings, counts] =
+            Qiskit::addon::sqd::deduplicate_bitstrings(natives);
+        CHECK(to_words(new_bitstrings) == to_words(expected_bitstrings));
+        CHECK(counts == expected_counts);
+    }
+    SUBCASE("Configuration recovery")
+    {
+        std::array<std::vector<double>, 2> avg_occupancies;
+        for (auto &occs : avg_occupancies) {
+            for (std::size_t i = 0; i < norb; ++i) {
+                occs.push_back(dist(rng));
+            }
+        }
+        std::mt19937_64 rng1, rng2;
+        const auto [expected_bitstrings, expected_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                bitsets, weights, avg_occupancies, {n_alpha, n_beta}, rng1
+            );
+        const auto [new_bitstrings, new_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                natives, weights, avg_occupancies, {n_alpha, n_beta}, rng2
+            );
+        CHECK(to_words(new_bitstrings) == to_words(expected_bitstrings));
+        CHECK(new_probs == expected_probs);
+
+        Qiskit::addon::sqd::ParallelOptions options;
+        options.num_threads = 2;
+        options.shard_size = 64;
+        const auto [expected_parallel_bitstrings, expected_parallel_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                bitsets, weights, avg_occupancies, {n_alpha, n_beta}, options
+            );
+        const auto [parallel_bitstrings, parallel_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                natives, weights, avg_occupancies, {n_alpha, n_beta}, options
+            );
+        CHECK(
+            to_words(parallel_bitstrings) == to_words(expected_parallel_bitstrings)
+        );
+        CHECK(parallel_probs == expected_parallel_probs);
+
+        Qiskit::addon::sqd::ConfigurationRecoverer recoverer(
+            natives, weights, {n_alpha, n_beta}
+        );
+        recoverer.update_occupancies(avg_occupancies);
+        recoverer.run(rng2);
+        Qiskit::addon::sqd::ConfigurationRecoverer expected_recoverer(
+            bitsets, weights, {n_alpha, n_beta}
+        );
+        expected_recoverer.update_occupancies(avg_occupancies);
+        expected_recoverer.run(rng1);
+        CHECK(
+            to_words(recoverer.result().first) ==
+            to_words(expected_recoverer.result().first)
+        );
+        CHECK(recoverer.result().second == expected_recoverer.result().second);
+    }
+    SUBCASE("CI strings")
+    {
+        const auto expected =
+            Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(bitsets);
+        const auto ci_strings =
+            Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(natives);
+        CHECK(to_words(ci_strings) == to_words(expected));
+        for (const auto &ci_string : ci_strings) {
+            CHECK(ci_string.size() == norb);
+        }
+
+        Qiskit::addon::sqd::ParallelOptions options;
+        options.num_threads = 2;
+        options.shard_size = 64;
+        const auto parallel_ci_strings =
+            Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(
+                natives, options
+            );
+        CHECK(parallel_ci_strings == ci_strings);
+    }
+}
+
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+TEST_CASE("Invalid native bitstrings of a run-time length")
+{
+    CHECK_THROWS_AS(
+        NativeBitstring<std::uint64_t>(std::uint64_t{1} << 60, 60),
+        std::invalid_argument
+    );
+    CHECK_THROWS_AS(NativeBitstring<std::uint32_t>(0, 33), std::invalid_argument);
+    CHECK_THROWS_AS(NativeBitstringVector<std::uint32_t>(33), std::invalid_argument);
+    CHECK_THROWS_AS(
+        NativeBitstringVector<std::uint64_t>(60, std::vector<std::uint64_t>{1, ~0ull}),
+        std::invalid_argument
+    );
+
+    NativeBitstringVector<std::uint64_t> vec(60);
+    CHECK_THROWS_AS(
+        vec.push_back(NativeBitstring<std::uint64_t>(1, 62)), std::invalid_argument
+    );
+    vec.push_back(NativeBitstring<std::uint64_t>(1, 60));
+    CHECK_THROWS_AS(
+        vec[0] = NativeBitstring<std::uint64_t>(1, 62), std::invalid_argument
+    );
+
+    // Recovery checks the length carried by the bitstrings
+    std::mt19937_64 rng;
+    const std::array<std::vector<double>, 2> avg_occupancies{
+        std::vector<double>(32, 0.5), std::vector<double>(32, 0.5)
+    };
+    CHECK_THROWS_AS(
+        std::ignore = Qiskit::addon::sqd::recover_configurations(
+            vec, std::vector<double>{1.0}, avg_occupancies, {3, 3}, rng
+        ),
+        std::invalid_argument
+    );
+}
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
@@ -0,0 +1,269 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "qiskit/addon/sqd/packed_bitstrings.hpp"
+
+#include "doctest.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "qiskit/addon/sqd/configuration_recovery.hpp"
+#include "qiskit/addon/sqd/fermion.hpp"
+#include "qiskit/addon/sqd/postselection.hpp"
+#include "qiskit/addon/sqd/subsampling.hpp"
+
+#include "bitstring_helpers.hpp"
+
+using Qiskit::addon::sqd::PackedBitstringVector;
+using DynamicBitset = PackedBitstringVector::value_type;
+
+TEST_CASE("Packed bitstring vector")
+{
+    std::mt19937_64 rng;
+    for (std::size_t num_bits : {6u, 64u, 116u, 130u}) {
+        const auto bitstrings = random_bitstrings(num_bits, 20, rng);
+        auto packed = pack(bitstrings);
+        CHECK(packed.size() == bitstrings.size());
+        CHECK(packed.num_bits() == num_bits);
+        CHECK(packed.words_per_bitstring() == (num_bits + 63) / 64);
+        std::size_t i = 0;
+        for (const auto &bs : packed) {
+            CHECK(bs.size() == num_bits);
+            CHECK(bs.count() == bitstrings[i].count());
+            CHECK(bs == bitstrings[i]);
+            CHECK(static_cast<DynamicBitset>(bs) == bitstrings[i]);
+            for (std::size_t j = 0; j < num_bits; ++j) {
+                CHECK(bs[j] == bitstrings[i][j]);
+            }
+            ++i;
+        }
+
+        SUBCASE("Mutation through references")
+        {
+            packed[0].flip(num_bits - 1);
+            auto expected = bitstrings[0];
+            expected.flip(num_bits - 1);
+            CHECK(packed[0] == expected);
+            packed[1] = packed[2];
+            CHECK(packed[1] == bitstrings[2]);
+            packed[3] = bitstrings[4];
+            CHECK(packed[3] == bitstrings[4]);
+        }
+        SUBCASE("Appending an element of the same container")
+        {
+            packed.push_back(packed[5]);
+            CHECK(packed.back() == bitstrings[5]);
+        }
+        SUBCASE("Mismatched lengths")
+        {
+            CHECK_THROWS_AS(
+                packed.push_back(DynamicBitset(num_bits + 2)), std::invalid_argument
+            );
+        }
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Packed bitstrings from any dynamic_bitset", BitsetType, boost::dynamic_bitset<>,
+    boost::dynamic_bitset<unsigned char>, boost::dynamic_bitset<std::uint32_t>,
+    boost::dynamic_bitset<unsigned long long>
+)
+{
+    std::mt19937_64 rng;
+    for (std::size_t num_bits : {6u, 64u, 116u, 130u}) {
+        const auto bitstrings = random_bitstrings(num_bits, 10, rng);
+        std::vector<BitsetType> converted;
+        for (const auto &bs : bitstrings) {
+            BitsetType bitset(num_bits);
+            for (std::size_t j = 0; j < num_bits; ++j) {
+                bitset[j] = bs[j];
+            }
+            converted.push_back(bitset);
+        }
+        PackedBitstringVector packed;
+        for (const auto &bitset : converted) {
+            packed.push_back(bitset);
+        }
+        CHECK(packed == pack(bitstrings));
+        for (std::size_t i = 0; i < converted.size(); ++i) {
+            CHECK(packed[i] == converted[i]);
+            CHECK(converted[i] == packed[i]);
+        }
+        CHECK(!(packed[0] == BitsetType(num_bits + 1)));
+        packed[0] = converted[1];
+        CHECK(packed[0] == bitstrings[1]);
+        CHECK_THROWS_AS(packed[0] = BitsetType(num_bits + 1), std::invalid_argument);
+        CHECK_THROWS_AS(
+            packed.push_back(BitsetType(num_bits + 1)), std::invalid_argument
+        );
+    }
+}
+
+TEST_CASE("Algorithms on packed bitstrings")
+{
+    std::mt19937_64 rng;
+    constexpr std::size_t norb = 58;
+    const auto bitstrings = random_bitstrings(2 * norb, 200, rng);
+    const auto packed = pack(bitstrings);
+    std::vector<double> weights;
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    for (std::size_t i = 0; i < bitstrings.size(); ++i) {
+        weights.push_back(dist(rng));
+    }
+
+    SUBCASE("Postselection")
+    {
+        const auto [expected_bitstrings, expected_weights] =
+            Qiskit::addon::sqd::postselect_bitstrings(
+                bitstrings, weights,
+                Qiskit::addon::sqd::MatchesRightLeftHamming(29u, 29u)
+            );
+        const auto [new_bitstrings, new_weights] =
+            Qiskit::addon::sqd::postselect_bitstrings(
+                packed, weights, Qiskit::addon::sqd::MatchesRightLeftHamming(29u, 29u)
+            );
+        CHECK(new_bitstrings == pack(expected_bitstrings));
+        CHECK(new_weights == expected_weights);
+
+        auto inplace_bitstrings = packed;
+        auto inplace_weights = weights;
+        Qiskit::addon::sqd::postselect_bitstrings_inplace(
+            inplace_bitstrings, inplace_weights,
+            Qiskit::addon::sqd::MatchesRightLeftHamming(29u, 29u)
+        );
+        CHECK(inplace_bitstrings == pack(expected_bitstrings));
+        CHECK(inplace_weights == expected_weights);
+
+        // An invalid weight of the last survivor leaves the input unchanged
+        const auto bitmap = Qiskit::addon::sqd::postselection_bitmap(
+            packed, Qiskit::addon::sqd::MatchesRightLeftHamming(29u, 29u)
+        );
+        std::size_t last = 0;
+        Qiskit::addon::sqd::internal::for_each_set_bit(
+            bitmap.data(), bitmap.size(), [&](std::size_t i) { last = i; }
+        );
+        REQUIRE(last > 0);
+        auto invalid_weights = weights;
+        invalid_weights[last] = -1.0;
+        inplace_bitstrings = packed;
+        inplace_weights = invalid_weights;
+        CHECK_THROWS_AS(
+            Qiskit::addon::sqd::postselect_bitstrings_inplace(
+                inplace_bitstrings, inplace_weights,
+                Qiskit::addon::sqd::MatchesRightLeftHamming(29u, 29u)
+            ),
+            std::invalid_argument
+        );
+        CHECK(inplace_bitstrings == packed);
+        CHECK(inplace_weights == invalid_weights);
+    }
+    SUBCASE("Subsampling")
+    {
+        std::mt19937_64 rng1, rng2;
+        const auto expected =
+            Qiskit::addon::sqd::subsample(bitstrings, weights, 50, rng1);
+        const auto batch = Qiskit::addon::sqd::subsample(packed, weights, 50, rng2);
+        CHECK(batch == pack(expected));
+    }
+    SUBCASE("Configuration recovery")
+    {
+        std::array<std::vector<double>, 2> avg_occupancies;
+        for (auto &occs : avg_occupancies) {
+            for (std::size_t i = 0; i < norb; ++i) {
+                occs.push_back(dist(rng));
+            }
+        }
+        std::mt19937_64 rng1, rng2;
+        const auto [expected_bitstrings, expected_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                bitstrings, weights, avg_occupancies, {10, 12}, rng1
+            );
+        const auto [new_bitstrings, new_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                packed, weights, avg_occupancies, {10, 12}, rng2
+            );
+        CHECK(new_bitstrings == pack(expected_bitstrings));
+        CHECK(new_probs == expected_probs);
+
+        const auto [expected_sorted_bitstrings, expected_sorted_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                bitstrings, weights, avg_occupancies, {10, 12}, rng1,
+                Qiskit::addon::sqd::SamplingMethod::rejection,
+                Qiskit::addon::sqd::AggregationMethod::sort_reduce
+            );
+        const auto [sorted_bitstrings, sorted_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                packed, weights, avg_occupancies, {10, 12}, rng2,
+                Qiskit::addon::sqd::SamplingMethod::rejection,
+                Qiskit::addon::sqd::AggregationMethod::sort_reduce
+            );
+        CHECK(sorted_bitstrings == pack(expected_sorted_bitstrings));
+        CHECK(sorted_probs == expected_sorted_probs);
+
+        const auto [expected_reused_bitstrings, expected_reused_probs] =
+            Qiskit::addon::sqd::recover_configurations(
+                bitstrings, weights, avg_occupancies, {10, 12}, rng1
+            );
+        Qiskit::addon::sqd::ConfigurationRecoverer recoverer(packed, weights, {10, 12});
+        recoverer.update_occupancies(avg_occupancies);
+        recoverer.run(rng2);
+        const auto [reused_bitstrings, reused_probs] = recoverer.result();
+        CHECK(reused_bitstrings == pack(expected_reused_bitstrings));
+        CHECK(reused_probs == expected_reused_probs);
+    }
+    SUBCASE("CI strings")
+    {
+        const auto expected =
+            Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(bitstrings);
+        const auto ci_strings =
+            Qiskit::addon::sqd::bitstrings_to_ci_strings_symmetrize_spin(packed);
+        CHECK(
+            std::unordered_set<DynamicBitset>(ci_strings.begin(), ci_strings.end()) ==
+            std::unordered_set<DynamicBitset>(expected.begin(), expected.end())
+        );
+    }
+}
+
+TEST_CASE("Vectorized postselection of packed bitstrings")
+{
+    std::mt19937_64 rng;
+    // Sparse bitstrings, so that many of them share the same Hamming weights
+    std::bernoulli_distribution coin(0.03);
+    for (std::size_t num_bits : {2u, 6u, 64u, 66u, 116u, 128u, 130u, 200u}) {
+        for (std::size_t count : {0u, 1u, 63u, 64u, 65u, 300u}) {
+            PackedBitstringVector packed(num_bits, count);
+            for (auto bitstring : packed) {
+                for (std::size_t j = 0; j < num_bits; ++j) {
+                    bitstring.set(j, coin(rng));
+                }
+            }
+            using Targets = std::array<unsigned int, 2>;
+            for (const auto &[right, left] :
+                 {Targets{0, 0}, Targets{1, 0}, Targets{1, 2}, Targets{2, 2}}) {
+                const Qiskit::addon::sqd::MatchesRightLeftHamming filter(right, left);
+                const auto bitmap =
+                    Qiskit::addon::sqd::postselection_bitmap(packed, filter);
+                const auto expected = Qiskit::addon::sqd::postselection_bitmap(
+                    packed, [&](const auto &bitstring) { return filter(bitstring); }
+                );
+                CHECK(bitmap == expected);
+            }
+        }
+    }
+}
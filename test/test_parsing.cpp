@@ -0,0 +1,229 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "qiskit/addon/sqd/parsing.hpp"
+
+#include "doctest.h"
+
+#include <clocale>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "qiskit/addon/sqd/postselection.hpp"
+
+#include "bitstring_helpers.hpp"
+
+using Qiskit::addon::sqd::PackedBitstringVector;
+using DynamicBitset = PackedBitstringVector::value_type;
+
+namespace
+{
+
+std::string to_hex(const DynamicBitset &bitstring)
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string retval;
+    for (std::size_t i = 0; i < bitstring.size(); i += 4) {
+        int value = 0;
+        for (std::size_t j = 0; j < 4 && i + j < bitstring.size(); ++j) {
+            value |= bitstring[i + j] << j;
+        }
+        retval.insert(retval.begin(), digits[value]);
+    }
+    return "0x" + retval;
+}
+
+} // namespace
+
+TEST_CASE("Parse binary digits")
+{
+    // Every length around the block sizes of the vectorized and scalar paths
+    std::mt19937_64 rng;
+    std::bernoulli_distribution coin;
+    for (std::size_t num_bits = 1; num_bits <= 200; ++num_bits) {
+        DynamicBitset expected(num_bits);
+        for (std::size_t j = 0; j < num_bits; ++j) {
+            expected[j] = coin(rng);
+        }
+        std::string key;
+        boost::to_string(expected, key);
+        std::vector<std::uint64_t> words(
+            Qiskit::addon::sqd::internal::words_for_bits(num_bits)
+        );
+        REQUIRE(Qiskit::addon::sqd::internal::parse_binary_digits(
+            key.data(), key.size(), words.data()
+        ));
+        DynamicBitset actual(words.begin(), words.end());
+        actual.resize(num_bits);
+        CHECK(actual == expected);
+
+        // A stray character anywhere is rejected
+        for (const std::size_t p : {std::size_t{0}, num_bits / 2, num_bits - 1}) {
+            auto bad_key = key;
+            bad_key[p] = '2';
+            std::fill(words.begin(), words.end(), std::uint64_t{0});
+            CHECK(!Qiskit::addon::sqd::internal::parse_binary_digits(
+                bad_key.data(), bad_key.size(), words.data()
+            ));
+        }
+    }
+}
+
+TEST_CASE("Parse counts")
+{
+    const std::vector<std::string> expected_keys{"0110", "1001", "1111"};
+    const std::vector<double> expected_weights{12, 3, 0.5};
+    const auto check = [&](const std::string &text, std::size_t num_bits = 0) {
+        const auto [bitstrings, weights] =
+            Qiskit::addon::sqd::parse_counts(text, num_bits);
+        std::vector<std::string> keys;
+        for (const auto &bs : unpack(bitstrings)) {
+            std::string key;
+            boost::to_string(bs, key);
+            keys.push_back(key);
+        }
+        CHECK(keys == expected_keys);
+        CHECK(weights == expected_weights);
+    };
+
+    check(R"({"0110": 12, "1001": 3, "1111": 0.5})");
+    check("{\n  \"0110\": 12,\n  \"1001\": 3,\n  \"1111\": 5e-1\n}\n");
+    check("bitstring,count\n0110,12\n1001,3\n1111,0.5\n");
+    check("0110 12\r\n1001\t3\r\n1111 0.5");
+    check(R"({"01 10": 12, "10 01": 3, "11 11": 0.5})");
+    check(R"({"0x6": 12, "0x9": 3, "0xF": 0.5})", 4);
+    check(R"({"0x06": 12, "0x9": 3, "1111": 0.5})", 4);
+
+    const auto [empty_bitstrings, empty_weights] =
+        Qiskit::addon::sqd::parse_counts("{}");
+    CHECK(empty_bitstrings.empty());
+    CHECK(empty_weights.empty());
+
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+    using Qiskit::addon::sqd::parse_counts;
+    CHECK_THROWS_AS(parse_counts(R"({"0110": 12, "101": 3})"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_counts(R"({"0120": 12})"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_counts(R"({"0110": x})"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_counts(R"({"0110": -3})"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_counts(R"({"0110": nan})"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_counts(R"({"0110: 12})"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_counts(R"({"0x1f": 12})"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_counts(R"({"0x1f": 12})", 4), std::invalid_argument);
+    CHECK_THROWS_AS(parse_counts(R"({"0xg": 12})", 4), std::invalid_argument);
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
+}
+
+TEST_CASE("Parse count values")
+{
+    const auto parse = [](const std::string &text, double &value) {
+        return Qiskit::addon::sqd::internal::parse_count(
+            text.data(), text.data() + text.size(), value
+        );
+    };
+    const std::vector<std::pair<std::string, double>> valid{
+        {"0", 0.0},
+        {"12", 12.0},
+        {"0.5", 0.5},
+        {"1.25", 1.25},
+        {"2.5e-3", 2.5e-3},
+        {"7E+2", 700.0},
+        {"1e0", 1.0},
+        {"0.0e5", 0.0},
+        {"12345678901234567890123", 12345678901234567890123.0},
+        {"0.1000000000000000055511151231257827", 0.1},
+        {"1.7976931348623157e308", 1.7976931348623157e308},
+    };
+    for (const auto &[text, expected] : valid) {
+        double value = -1.0;
+        CHECK(parse(text, value));
+        CHECK(value == expected);
+    }
+    for (const std::string text :
+         {"", "-3", "+3", "-0.5", "nan", "NaN", "inf", "-inf", "infinity", "1e999",
+          "1.", ".5", "1e", "1e+", "0x10", "1,5", "1.5.2", "3 "}) {
+        double value = 0.0;
+        CHECK(!parse(text, value));
+    }
+
+    // The C locale does not change how counts are read
+    if (std::setlocale(LC_NUMERIC, "de_DE.UTF-8") != nullptr) {
+        double value = 0.0;
+        CHECK(parse("1.5", value));
+        CHECK(value == 1.5);
+        CHECK(parse("1.0000000000000000000001e1", value));
+        CHECK(value == 10.0);
+        std::setlocale(LC_NUMERIC, "C");
+    }
+}
+
+TEST_CASE("Parse counts on multiple threads")
+{
+    std::mt19937_64 rng;
+    std::bernoulli_distribution coin;
+    for (const std::size_t num_bits : {7u, 64u, 100u}) {
+        std::vector<DynamicBitset> expected_bitstrings;
+        std::vector<double> expected_weights;
+        std::ostringstream json, csv;
+        json << "{";
+        csv << "key,count\n";
+        for (std::size_t i = 0; i < 1000; ++i) {
+            DynamicBitset bs(num_bits);
+            for (std::size_t j = 0; j < num_bits; ++j) {
+                bs[j] = coin(rng);
+            }
+            std::string key;
+            boost::to_string(bs, key);
+            const auto key_text = i % 3 == 0 ? to_hex(bs) : key;
+            json << (i == 0 ? "" : ", ") << '"' << key_text << "\": " << i;
+            csv << key_text << ',' << i << '\n';
+            expected_bitstrings.push_back(bs);
+            expected_weights.push_back(static_cast<double>(i));
+        }
+        json << "}";
+
+        for (const auto &text : {json.str(), csv.str()}) {
+            for (const std::size_t shard_size : {1u, 7u, 100u, 5000u}) {
+                Qiskit::addon::sqd::ParallelOptions options;
+                options.num_threads = 4;
+                options.shard_size = shard_size;
+                const auto [bitstrings, weights] =
+                    Qiskit::addon::sqd::parse_counts(text, num_bits, options);
+                CHECK(unpack(bitstrings) == expected_bitstrings);
+                CHECK(weights == expected_weights);
+            }
+            const auto [bitstrings, weights] =
+                Qiskit::addon::sqd::parse_counts(text, num_bits);
+            CHECK(unpack(bitstrings) == expected_bitstrings);
+            CHECK(weights == expected_weights);
+        }
+    }
+}
+
+TEST_CASE("Postselect parsed counts")
+{
+    const auto [bitstrings, weights] = Qiskit::addon::sqd::parse_counts(
+        R"({"000011": 5, "001001": 2, "010010": 1, "110000": 4})"
+    );
+    const auto [filtered_bitstrings, filtered_weights] =
+        Qiskit::addon::sqd::postselect_bitstrings(
+            bitstrings, weights, Qiskit::addon::sqd::MatchesRightLeftHamming(1u, 1u)
+        );
+    CHECK(filtered_bitstrings.size() == 2);
+    CHECK(filtered_weights == std::vector<double>{2.0 / 3, 1.0 / 3});
+}
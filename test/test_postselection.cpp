@@ -14,8 +14,14 @@
 
 #include "doctest.h"
 
+#include <algorithm>
+#include <array>
 #include <bitset>
 #include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include <iostream>
@@ -50,3 +56,176 @@ TEST_CASE_TEMPLATE(
         CHECK(new_weights[i] == doctest::Approx(expected_weights[i]));
     }
 }
+
+TEST_CASE_TEMPLATE(
+    "In-place and streaming postselection", BitstringType, std::bitset<N>,
+    boost::dynamic_bitset<>
+)
+{
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<unsigned int> value_dist(0, (1u << N) - 1);
+    std::uniform_real_distribution<double> weight_dist(0.0, 1.0);
+    std::vector<BitstringType> bitstrings(1000);
+    std::vector<double> weights;
+    for (auto &bitstring : bitstrings) {
+        set_bitset(N, bitstring, value_dist(rng));
+        weights.push_back(weight_dist(rng));
+    }
+    const Qiskit::addon::sqd::MatchesRightLeftHamming filter(1u, 2u);
+    const auto [expected_bitstrings, expected_weights] =
+        Qiskit::addon::sqd::postselect_bitstrings(bitstrings, weights, filter);
+    REQUIRE(!expected_bitstrings.empty());
+
+    SUBCASE("In-place")
+    {
+        auto new_bitstrings = bitstrings;
+        auto new_weights = weights;
+        Qiskit::addon::sqd::postselect_bitstrings_inplace(
+            new_bitstrings, new_weights, filter
+        );
+        CHECK(new_bitstrings == expected_bitstrings);
+        CHECK(new_weights == expected_weights);
+    }
+    SUBCASE("Rvalue input")
+    {
+        auto bitstrings_copy = bitstrings;
+        auto weights_copy = weights;
+        const auto [new_bitstrings, new_weights] =
+            Qiskit::addon::sqd::postselect_bitstrings(
+                std::move(bitstrings_copy), std::move(weights_copy), filter
+            );
+        CHECK(new_bitstrings == expected_bitstrings);
+        CHECK(new_weights == expected_weights);
+    }
+    SUBCASE("Streaming")
+    {
+        Qiskit::addon::sqd::StreamingPostselector<
+            std::vector<BitstringType>, std::vector<double>,
+            Qiskit::addon::sqd::MatchesRightLeftHamming<unsigned int>>
+            postselector(filter);
+        constexpr std::size_t chunk_size = 64;
+        double expected_weights_sum = 0.0;
+        for (std::size_t begin = 0; begin < bitstrings.size(); begin += chunk_size) {
+            const auto end = std::min(begin + chunk_size, bitstrings.size());
+            const std::vector<BitstringType> chunk_bitstrings(
+                bitstrings.begin() + begin, bitstrings.begin() + end
+            );
+            const std::vector<double> chunk_weights(
+                weights.begin() + begin, weights.begin() + end
+            );
+            postselector.push(chunk_bitstrings, chunk_weights);
+            for (std::size_t i = begin; i < end; ++i) {
+                expected_weights_sum += filter(bitstrings[i]) ? weights[i] : 0.0;
+            }
+            CHECK(postselector.weights_sum() == doctest::Approx(expected_weights_sum));
+        }
+        CHECK(postselector.size() == expected_bitstrings.size());
+        const auto [new_bitstrings, new_weights] = postselector.finish();
+        CHECK(new_bitstrings == expected_bitstrings);
+        REQUIRE(new_weights.size() == expected_weights.size());
+        for (std::size_t i = 0; i < new_weights.size(); ++i) {
+            CHECK(new_weights[i] == doctest::Approx(expected_weights[i]));
+        }
+        CHECK(postselector.size() == 0);
+        CHECK(postselector.weights_sum() == 0.0);
+    }
+    SUBCASE("Invalid weight after survivors")
+    {
+        // The earlier survivors would already have been moved, were the weights
+        // validated while compacting
+        set_bitset(N, bitstrings.back(), 0b011010);
+        weights.back() = -1.0;
+        auto new_bitstrings = bitstrings;
+        auto new_weights = weights;
+        CHECK_THROWS_AS(
+            Qiskit::addon::sqd::postselect_bitstrings_inplace(
+                new_bitstrings, new_weights, filter
+            ),
+            std::invalid_argument
+        );
+        CHECK(new_bitstrings == bitstrings);
+        CHECK(new_weights == weights);
+    }
+    SUBCASE("Invalid weights")
+    {
+        weights[0] = -1.0;
+        set_bitset(N, bitstrings[0], 0b011010);
+        CHECK_THROWS_AS(
+            Qiskit::addon::sqd::postselect_bitstrings_inplace(
+                bitstrings, weights, filter
+            ),
+            std::invalid_argument
+        );
+        weights.pop_back();
+        CHECK_THROWS_AS(
+            Qiskit::addon::sqd::postselect_bitstrings_inplace(
+                bitstrings, weights, filter
+            ),
+            std::invalid_argument
+        );
+    }
+}
+
+#if !QKA_SQD_DISABLE_EXCEPTIONS && !(_MSVC_LANG == 202002L)
+#define BITSET2_IF_AVAILABLE                                                           \
+    , Bitset2::bitset2<130>, Bitset2::bitset2<66, std::uint32_t>
+#else
+#define BITSET2_IF_AVAILABLE
+#endif
+
+template <typename BitstringType>
+static std::array<std::size_t, 2>
+naive_right_left_hamming(const BitstringType &bitstring)
+{
+    const auto half_N = bitstring.size() / 2;
+    std::array<std::size_t, 2> counts{0, 0};
+    for (std::size_t i = 0; i < bitstring.size(); ++i) {
+        counts[i < half_N ? 0 : 1] += bitstring[i] ? 1 : 0;
+    }
+    return counts;
+}
+
+template <typename BitstringType, typename RNGType>
+static void check_right_left_hamming(BitstringType &bitstring, RNGType &rng)
+{
+    using Qiskit::addon::sqd::internal::RightLeftHammingImpl;
+    std::bernoulli_distribution coin;
+    for (int trial = 0; trial < 20; ++trial) {
+        for (std::size_t i = 0; i < bitstring.size(); ++i) {
+            bitstring.set(i, coin(rng));
+        }
+        const auto expected = naive_right_left_hamming(bitstring);
+        CHECK(RightLeftHammingImpl<BitstringType>::count(bitstring) == expected);
+        CHECK(Qiskit::addon::sqd::MatchesRightLeftHamming(expected[0], expected[1])(
+            bitstring
+        ));
+        CHECK(!Qiskit::addon::sqd::MatchesRightLeftHamming(
+            expected[0] + 1, expected[1]
+        )(bitstring));
+    }
+}
+
+TEST_CASE_TEMPLATE(
+    "Right and left Hamming weights of fixed-size bitsets", BitstringType,
+    std::bitset<2>, std::bitset<6>, std::bitset<64>, std::bitset<66>, std::bitset<116>,
+    std::bitset<130> BITSET2_IF_AVAILABLE
+)
+{
+    std::mt19937_64 rng(1234);
+    BitstringType bitstring;
+    check_right_left_hamming(bitstring, rng);
+}
+
+TEST_CASE_TEMPLATE(
+    "Right and left Hamming weights of dynamic bitsets", BitstringType,
+    boost::dynamic_bitset<>, boost::dynamic_bitset<std::uint8_t>,
+    boost::dynamic_bitset<std::uint64_t>
+)
+{
+    std::mt19937_64 rng(1234);
+    // Sizes for which the halves fall on, and straddle, block boundaries
+    for (std::size_t num_bits : {0u, 2u, 6u, 16u, 18u, 64u, 66u, 116u, 128u, 130u}) {
+        BitstringType bitstring(num_bits);
+        check_right_left_hamming(bitstring, rng);
+    }
+}
@@ -0,0 +1,322 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "qiskit/addon/sqd/random.hpp"
+
+#include "doctest.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "qiskit/addon/sqd/subsampling.hpp"
+
+using Qiskit::addon::sqd::Philox4x64;
+using Qiskit::addon::sqd::Xoshiro256StarStar;
+
+#if QKA_SQD_USE_CONCEPTS
+static_assert(std::uniform_random_bit_generator<Philox4x64>);
+static_assert(std::uniform_random_bit_generator<Xoshiro256StarStar>);
+#endif
+
+TEST_CASE("Philox4x64 known answers")
+{
+    // Block 0 with the zero key, from the Random123 known-answer tests
+    CHECK(
+        Qiskit::addon::sqd::internal::philox4x64_10({0, 0, 0, 0}, {0, 0}) ==
+        std::array<std::uint64_t, 4>{
+            0x16554d9eca36314cULL, 0xdb20fe9d672d0fdcULL, 0xd7e772cee186176bULL,
+            0x7e68b68aec7ba23bULL
+        }
+    );
+    // The carry into the second word of the counter, as in NumPy
+    CHECK(
+        Qiskit::addon::sqd::internal::philox4x64_10({0, 1, 0, 0}, {123, 456}) ==
+        std::array<std::uint64_t, 4>{
+            0x031ddc213298529dULL, 0xa6d959d6179addcdULL, 0xf4059d9dc07d5e5cULL,
+            0xdaa80210b5729473ULL
+        }
+    );
+
+    Philox4x64 rng(123, 456);
+    const std::vector<std::uint64_t> expected{
+        0x3cdcad1fb4763de7ULL, 0xf94cc91d1fab146bULL, 0x3aa7490df501df51ULL,
+        0x458f65a8c046a6faULL, 0x182a33ef112a55c6ULL, 0x7fa21420170db5b7ULL
+    };
+    for (const auto value : expected) {
+        CHECK(rng() == value);
+    }
+}
+
+TEST_CASE("Xoshiro256StarStar known answers")
+{
+    const std::array<std::uint64_t, 4> state{1, 2, 3, 4};
+    Xoshiro256StarStar rng(state);
+    const std::vector<std::uint64_t> expected{
+        11520, 0, 1509978240, 1215971899390074240ULL, 1216172134540287360ULL,
+        607988272756665600ULL
+    };
+    for (const auto value : expected) {
+        CHECK(rng() == value);
+    }
+
+    // Jumps of 2^128 and 2^192 outputs, checked against powers of the
+    // transition matrix
+    Xoshiro256StarStar jumped(state);
+    jumped.jump();
+    CHECK(
+        jumped == Xoshiro256StarStar({0x8c7a153956b5f3d1ULL, 0x701f1a713401d85eULL,
+                                      0x6527f66a65469085ULL, 0x8386b786c4408050ULL})
+    );
+    Xoshiro256StarStar long_jumped(state);
+    long_jumped.long_jump();
+    CHECK(
+        long_jumped ==
+        Xoshiro256StarStar({0x096a8eb71295a400ULL, 0xdbf84991e50f4516ULL,
+                            0x534ee745810d2a0eULL, 0x31655ca1a2215bf1ULL})
+    );
+
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+    CHECK_THROWS_AS(Xoshiro256StarStar({0, 0, 0, 0}), std::invalid_argument);
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
+}
+
+TEST_CASE_TEMPLATE("Bulk fill and discard", RNGType, Philox4x64, Xoshiro256StarStar)
+{
+    // Start from every position within a block of Philox4x64
+    for (unsigned int offset = 0; offset < 5; ++offset) {
+        for (std::size_t count : {0, 1, 3, 4, 5, 8, 13, 100}) {
+            RNGType rng(7, 3);
+            rng.discard(offset);
+            auto expected_rng = rng;
+
+            std::vector<double> values(count);
+            rng.fill(values.data(), count);
+            for (const auto value : values) {
+                const auto bits = expected_rng();
+                CHECK(value == static_cast<double>(bits >> 11) * 0x1.0p-53);
+                CHECK(value >= 0.0);
+                CHECK(value < 1.0);
+            }
+            CHECK(rng == expected_rng);
+
+            RNGType discarded(7, 3);
+            discarded.discard(offset);
+            discarded.discard(count);
+            CHECK(discarded == rng);
+            CHECK(discarded() == expected_rng());
+        }
+    }
+}
+
+TEST_CASE_TEMPLATE("Streams", RNGType, Philox4x64, Xoshiro256StarStar)
+{
+    RNGType a(1, 0), b(1, 1), c(2, 0), a_again(1, 0);
+    CHECK(a == a_again);
+    CHECK(a != b);
+    CHECK(a != c);
+    const auto first = a();
+    CHECK(first == a_again());
+    CHECK(first != b());
+    CHECK(first != c());
+
+    // The shards of parallel routines are the streams of the seed
+    auto rng = Qiskit::addon::sqd::internal::make_stream_rng<RNGType>(1, 1);
+    RNGType expected(1, 1);
+    CHECK(rng == expected);
+}
+
+TEST_CASE_TEMPLATE(
+    "Parallel subsampling with built-in generators", RNGType, Philox4x64,
+    Xoshiro256StarStar
+)
+{
+    std::vector<double> weights;
+    for (unsigned int i = 0; i < 50; ++i) {
+        weights.push_back(i % 7);
+    }
+    Qiskit::addon::sqd::ParallelOptions options;
+    options.seed = 11;
+    options.num_threads = 1;
+    const auto expected =
+        Qiskit::addon::sqd::subsample_multiple_batches_indices<RNGType>(
+            weights, 10, 20, options
+        );
+    CHECK(expected.size() == 20);
+    options.num_threads = 3;
+    CHECK(
+        Qiskit::addon::sqd::subsample_multiple_batches_indices<RNGType>(
+            weights, 10, 20, options
+        ) == expected
+    );
+}
+
+TEST_CASE("Random bits from generators of any range")
+{
+    using Qiskit::addon::sqd::random_bits64;
+    {
+        // Two 32-bit outputs, most significant first
+        std::mt19937 rng(5), expected(5);
+        const std::uint64_t hi = expected(), lo = expected();
+        CHECK(random_bits64(rng) == ((hi << 32) | lo));
+    }
+    {
+        // Outputs in [1, 2^31 - 2] give 30 bits each, and those at or above
+        // 2^30 are discarded
+        std::minstd_rand rng(9), expected(9);
+        std::uint64_t value = 0;
+        for (int filled = 0; filled < 64; filled += 30) {
+            std::uint64_t x;
+            do {
+                x = expected() - std::minstd_rand::min();
+            } while (x >= (std::uint64_t{1} << 30));
+            value = (value << 30) | x;
+        }
+        CHECK(random_bits64(rng) == value);
+        CHECK(rng == expected);
+    }
+    {
+        Philox4x64 rng(3), expected(3);
+        CHECK(random_bits64(rng) == expected());
+    }
+}
+
+TEST_CASE("Uniform doubles")
+{
+    using Qiskit::addon::sqd::uniform_double;
+    Xoshiro256StarStar rng(4), expected(4);
+    std::vector<double> filled(1000);
+    expected.fill(filled.data(), filled.size());
+    for (const auto value : filled) {
+        CHECK(uniform_double(rng) == value);
+    }
+
+    std::mt19937 rng32(1);
+    double sum = 0.0;
+    for (int i = 0; i < 10000; ++i) {
+        const auto value = uniform_double(rng32);
+        REQUIRE(value >= 0.0);
+        REQUIRE(value < 1.0);
+        sum += value;
+    }
+    CHECK(sum / 10000 == doctest::Approx(0.5).epsilon(0.02));
+}
+
+TEST_CASE("Bounded integers")
+{
+    using Qiskit::addon::sqd::uniform_below;
+    namespace internal = Qiskit::addon::sqd::internal;
+
+    // Compare with a direct statement of the method: multiply, and reject the
+    // low products below 2^64 mod bound
+    for (const std::uint64_t bound :
+         {std::uint64_t{1}, std::uint64_t{6}, std::uint64_t{1000003},
+          (std::uint64_t{1} << 63) + 1, ~std::uint64_t{0}}) {
+        Philox4x64 rng(bound), expected(bound);
+        const std::uint64_t threshold = (0 - bound) % bound;
+        for (int i = 0; i < 1000; ++i) {
+            std::array<std::uint64_t, 2> product;
+            do {
+                product = internal::mulhilo64(expected(), bound);
+            } while (product[1] < threshold);
+            const auto value = uniform_below(rng, bound);
+            CHECK(value == product[0]);
+            CHECK(value < bound);
+        }
+        CHECK(rng == expected);
+    }
+
+    std::array<int, 6> counts{};
+    Xoshiro256StarStar rng(8);
+    for (int i = 0; i < 60000; ++i) {
+        ++counts[uniform_below(rng, 6)];
+    }
+    for (const auto count : counts) {
+        CHECK(count == doctest::Approx(10000).epsilon(0.05));
+    }
+
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+    CHECK_THROWS_AS(uniform_below(rng, 0), std::invalid_argument);
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
+}
+
+TEST_CASE("Categorical draws")
+{
+    namespace internal = Qiskit::addon::sqd::internal;
+    std::mt19937_64 rng(2);
+    std::uniform_int_distribution<int> value_dist(0, 5);
+    for (std::size_t n = 0; n < 40; ++n) {
+        std::vector<double> sorted;
+        for (std::size_t i = 0; i < n; ++i) {
+            sorted.push_back(value_dist(rng));
+        }
+        std::sort(sorted.begin(), sorted.end());
+        for (double target = -1.0; target <= 6.0; target += 0.5) {
+            const auto expected = static_cast<std::size_t>(
+                std::upper_bound(sorted.begin(), sorted.end(), target) - sorted.begin()
+            );
+            CHECK(
+                internal::branchless_upper_bound(sorted.data(), n, target) == expected
+            );
+        }
+    }
+
+    // Zero weights are never drawn
+    const std::vector<double> weights{0, 1, 0, 0, 3, 0};
+    std::vector<double> cumulative;
+    double total = 0.0;
+    for (const auto weight : weights) {
+        cumulative.push_back(total += weight);
+    }
+    std::array<int, 6> counts{};
+    Philox4x64 philox(1);
+    for (int i = 0; i < 40000; ++i) {
+        ++counts[internal::draw_categorical(
+            cumulative.data(), cumulative.size(), philox
+        )];
+    }
+    CHECK(counts[0] == 0);
+    CHECK(counts[2] == 0);
+    CHECK(counts[3] == 0);
+    CHECK(counts[5] == 0);
+    CHECK(counts[1] == doctest::Approx(10000).epsilon(0.05));
+    CHECK(counts[4] == doctest::Approx(30000).epsilon(0.05));
+}
+
+TEST_CASE("Samplers draw the same indices on every platform")
+{
+    // These samplers use only portable arithmetic, so the indices they draw
+    // are fixed by the generator.  `SamplingMethod::exponential_keys` also
+    // depends on `std::log`, and is not checked here.
+    using Qiskit::addon::sqd::SamplingMethod;
+    const std::vector<double> weights{0.5, 1, 0, 2, 0.25, 3, 1, 0, 4, 0.125};
+    const std::vector<std::pair<SamplingMethod, std::vector<std::size_t>>> cases{
+        {SamplingMethod::rejection, {3, 8, 1, 5, 4, 6, 0}},
+        {SamplingMethod::fenwick_tree, {3, 8, 4, 1, 5, 6, 0}},
+    };
+    for (const auto &[method, expected] : cases) {
+        Philox4x64 rng(2025);
+        std::vector<std::size_t> drawn;
+        const auto draw = [&](auto &sampler) {
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                drawn.push_back(sampler(rng));
+            }
+        };
+        Qiskit::addon::sqd::internal::visit_sampler(method, weights, draw);
+        CHECK(drawn == expected);
+    }
+}
@@ -0,0 +1,316 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2025.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "qiskit/addon/sqd/shot_file.hpp"
+
+#include "doctest.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "qiskit/addon/sqd/configuration_recovery.hpp"
+#include "qiskit/addon/sqd/postselection.hpp"
+#include "qiskit/addon/sqd/subsampling.hpp"
+
+#include "bitstring_helpers.hpp"
+
+namespace sqd = Qiskit::addon::sqd;
+using sqd::BorrowingVector;
+using sqd::PackedBitstringVector;
+using DynamicBitset = PackedBitstringVector::value_type;
+
+namespace
+{
+
+// Path of a file in a fresh temporary directory, removed on destruction
+class TemporaryPath
+{
+  private:
+    std::filesystem::path directory_;
+
+  public:
+    TemporaryPath()
+    {
+        std::random_device rd;
+        directory_ = std::filesystem::temp_directory_path() /
+                     ("qka-sqd-test-" + std::to_string(rd()));
+        std::filesystem::create_directories(directory_);
+    }
+    ~TemporaryPath()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(directory_, ec);
+    }
+    std::string file(const std::string &name) const
+    {
+        return (directory_ / name).string();
+    }
+};
+
+std::vector<double> random_weights(std::size_t count, std::mt19937_64 &rng)
+{
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    std::vector<double> weights;
+    for (std::size_t i = 0; i < count; ++i) {
+        weights.push_back(dist(rng));
+    }
+    return weights;
+}
+
+std::string read_file(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+// Overwrite `size` bytes at `offset` of the file at `path`
+void patch_file(
+    const std::string &path, std::size_t offset, const void *bytes, std::size_t size
+)
+{
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(static_cast<const char *>(bytes), static_cast<std::streamsize>(size));
+}
+
+} // namespace
+
+TEST_CASE("Borrowing vector")
+{
+    const std::vector<double> source{1.0, 2.0, 3.0};
+    const auto borrowed = BorrowingVector<double>::borrow(source.data(), 3);
+    CHECK(borrowed.is_borrowed());
+    CHECK(borrowed.size() == 3);
+    CHECK(borrowed.data() == source.data());
+    CHECK(borrowed[1] == 2.0);
+
+    // Copies borrow the same elements
+    auto copy = borrowed;
+    CHECK(copy.is_borrowed());
+    CHECK(copy == borrowed);
+
+    // Mutation copies the borrowed elements first
+    copy.push_back(4.0);
+    CHECK(!copy.is_borrowed());
+    CHECK(copy != borrowed);
+    CHECK(copy.size() == 4);
+    CHECK(copy[3] == 4.0);
+    copy[0] = 5.0;
+    CHECK(source[0] == 1.0);
+
+    copy.clear();
+    CHECK(copy.empty());
+    CHECK(!copy.is_borrowed());
+}
+
+TEST_CASE("Shot file round trip")
+{
+    std::mt19937_64 rng;
+    TemporaryPath tmp;
+
+    for (const std::size_t norb : {0, 5, 32, 40, 100}) {
+        const auto bitstrings = random_bitstrings(2 * norb, 300, rng, 0.3);
+        const auto weights = random_weights(bitstrings.size(), rng);
+        const auto path = tmp.file("shots-" + std::to_string(norb) + ".bin");
+        sqd::write_shot_file(path, bitstrings, weights);
+
+        // The fast path for packed bitstrings writes the same file
+        PackedBitstringVector packed(2 * norb);
+        for (const auto &bs : bitstrings) {
+            packed.push_back(bs);
+        }
+        const auto packed_path = tmp.file("packed.bin");
+        sqd::write_shot_file(packed_path, packed, weights);
+        CHECK(read_file(packed_path) == read_file(path));
+
+        const sqd::ShotFile file(path);
+        CHECK(file.num_orbitals() == norb);
+        CHECK(file.num_shots() == bitstrings.size());
+        CHECK(file.bitstrings().is_borrowed());
+        CHECK(file.weights().is_borrowed());
+        CHECK(unpack(file.bitstrings()) == bitstrings);
+        CHECK(std::vector<double>(file.weights().begin(), file.weights().end()) ==
+              weights);
+
+        // Write the mapped shots back out, without copying them
+        const auto copy_path = tmp.file("copy.bin");
+        sqd::write_shot_file(copy_path, file.bitstrings(), file.weights());
+        const sqd::ShotFile copy(copy_path);
+        CHECK(copy.bitstrings() == file.bitstrings());
+        CHECK(copy.weights() == file.weights());
+    }
+}
+
+TEST_CASE("Shot file empty")
+{
+    TemporaryPath tmp;
+    const auto path = tmp.file("empty.bin");
+    sqd::write_shot_file(
+        path, std::vector<std::array<std::uint64_t, 2>>{}, std::vector<double>{}
+    );
+    const sqd::ShotFile file(path);
+    CHECK(file.num_orbitals() == 64);
+    CHECK(file.num_shots() == 0);
+    CHECK(file.bitstrings().empty());
+    CHECK(file.weights().empty());
+}
+
+TEST_CASE("Shot file with float32 weights")
+{
+    std::mt19937_64 rng;
+    TemporaryPath tmp;
+    const auto path = tmp.file("float32.bin");
+    const auto bitstrings = random_bitstrings(20, 50, rng, 0.3);
+    const std::vector<double> weights(bitstrings.size(), 0.25);
+    sqd::write_shot_file(path, bitstrings, weights);
+
+    // Rewrite the weights in place as float32, which is legal since the float64
+    // column has room for them
+    const std::uint32_t float32 = 2;
+    patch_file(path, 32, &float32, sizeof(float32));
+    std::vector<float> float_weights(weights.size(), 0.25f);
+    const std::uint64_t weights_offset = 64 + 8 * bitstrings.size();
+    patch_file(
+        path, weights_offset, float_weights.data(), 4 * float_weights.size()
+    );
+
+    const sqd::ShotFile file(path);
+    CHECK(unpack(file.bitstrings()) == bitstrings);
+    CHECK(!file.weights().is_borrowed());
+    CHECK(std::vector<double>(file.weights().begin(), file.weights().end()) ==
+          weights);
+}
+
+TEST_CASE("Algorithms on mapped shots")
+{
+    constexpr std::size_t norb = 40;
+    constexpr std::uint64_t n_alpha = 12, n_beta = 12;
+    std::mt19937_64 rng;
+    TemporaryPath tmp;
+    const auto bitstrings = random_bitstrings(2 * norb, 2000, rng, 0.3);
+    const auto weights = random_weights(bitstrings.size(), rng);
+    PackedBitstringVector packed;
+    for (const auto &bs : bitstrings) {
+        packed.push_back(bs);
+    }
+    const BorrowingVector<double> owned_weights(weights.begin(), weights.end());
+    const auto path = tmp.file("shots.bin");
+    sqd::write_shot_file(path, packed, weights);
+    const sqd::ShotFile file(path);
+    const auto &mapped_bitstrings = file.bitstrings();
+    const auto &mapped_weights = file.weights();
+
+    SUBCASE("Postselection")
+    {
+        const sqd::MatchesRightLeftHamming filter(n_alpha, n_beta);
+        const auto [expected_bitstrings, expected_weights] =
+            sqd::postselect_bitstrings(packed, owned_weights, filter);
+        const auto [new_bitstrings, new_weights] =
+            sqd::postselect_bitstrings(mapped_bitstrings, mapped_weights, filter);
+        CHECK(!new_bitstrings.empty());
+        CHECK(!new_bitstrings.is_borrowed());
+        CHECK(new_bitstrings == expected_bitstrings);
+        CHECK(new_weights == expected_weights);
+    }
+    SUBCASE("Subsampling")
+    {
+        std::mt19937_64 rng1, rng2;
+        const auto expected = sqd::subsample(packed, owned_weights, 100, rng1);
+        const auto batch = sqd::subsample(mapped_bitstrings, mapped_weights, 100, rng2);
+        CHECK(batch == expected);
+    }
+    SUBCASE("Configuration recovery")
+    {
+        std::array<std::vector<double>, 2> avg_occupancies;
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        for (auto &occs : avg_occupancies) {
+            for (std::size_t i = 0; i < norb; ++i) {
+                occs.push_back(dist(rng));
+            }
+        }
+        std::mt19937_64 rng1, rng2;
+        const auto [expected_bitstrings, expected_probs] = sqd::recover_configurations(
+            packed, owned_weights, avg_occupancies, {n_alpha, n_beta}, rng1
+        );
+        const auto [new_bitstrings, new_probs] = sqd::recover_configurations(
+            mapped_bitstrings, mapped_weights, avg_occupancies, {n_alpha, n_beta}, rng2
+        );
+        CHECK(new_bitstrings == expected_bitstrings);
+        CHECK(new_probs == expected_probs);
+    }
+    CHECK(mapped_bitstrings.is_borrowed());
+    CHECK(mapped_weights.is_borrowed());
+}
+
+#if !QKA_SQD_DISABLE_EXCEPTIONS
+TEST_CASE("Shot file errors")
+{
+    std::mt19937_64 rng;
+    TemporaryPath tmp;
+    const auto bitstrings = random_bitstrings(20, 10, rng, 0.3);
+    const auto weights = random_weights(bitstrings.size(), rng);
+    const auto path = tmp.file("shots.bin");
+
+    CHECK_THROWS_AS(sqd::ShotFile(tmp.file("missing.bin")), std::runtime_error);
+    CHECK_THROWS_AS(
+        sqd::write_shot_file(path, bitstrings, std::vector<double>(3)),
+        std::invalid_argument
+    );
+    CHECK_THROWS_AS(
+        sqd::write_shot_file(path, random_bitstrings(21, 10, rng, 0.3), weights),
+        std::invalid_argument
+    );
+    // A mismatched length is found before an existing file is overwritten
+    sqd::write_shot_file(path, bitstrings, weights);
+    const auto contents = read_file(path);
+    auto mixed = bitstrings;
+    mixed.back().resize(22);
+    CHECK_THROWS_AS(sqd::write_shot_file(path, mixed, weights), std::invalid_argument);
+    CHECK(read_file(path) == contents);
+
+    const auto expect_corrupt = [&](std::size_t offset, auto value) {
+        sqd::write_shot_file(path, bitstrings, weights);
+        patch_file(path, offset, &value, sizeof(value));
+        CHECK_THROWS_AS(sqd::ShotFile{path}, std::runtime_error);
+    };
+    const auto max = ~std::uint64_t{0};
+    expect_corrupt(0, std::uint64_t{0});          // magic
+    expect_corrupt(8, std::uint32_t{2});          // version
+    expect_corrupt(12, std::uint32_t{32});        // word width
+    expect_corrupt(16, std::uint64_t{1000});      // orbitals
+    expect_corrupt(16, max);                      // orbitals
+    expect_corrupt(24, std::uint64_t{11});        // shots
+    expect_corrupt(24, max / 2);                  // shots
+    expect_corrupt(32, std::uint32_t{3});         // weight type
+    expect_corrupt(40, std::uint64_t{68});        // misaligned words
+    expect_corrupt(40, std::uint64_t{0});         // words overlap the header
+    expect_corrupt(48, std::uint64_t{1} << 20);   // weights out of bounds
+    expect_corrupt(48, max - 7);                  // weights out of bounds
+
+    // A truncated file
+    sqd::write_shot_file(path, bitstrings, weights);
+    std::filesystem::resize_file(path, 64 + 8 * bitstrings.size() + 8);
+    CHECK_THROWS_AS(sqd::ShotFile{path}, std::runtime_error);
+    std::filesystem::resize_file(path, 10);
+    CHECK_THROWS_AS(sqd::ShotFile{path}, std::runtime_error);
+}
+#endif // !QKA_SQD_DISABLE_EXCEPTIONS
@@ -14,7 +14,9 @@
 
 #include "doctest.h"
 
+#include <algorithm>
 #include <bitset>
+#include <cstdint>
 #include <unordered_set>
 #include <vector>
 
@@ -55,3 +57,250 @@ TEST_CASE_TEMPLATE(
         }
     }
 }
+
+TEST_CASE("Sampling methods")
+{
+    using Qiskit::addon::sqd::SamplingMethod;
+    const std::vector<double> weights{1, 0, 2, 3, 0, 4};
+    for (auto method :
+         {SamplingMethod::rejection, SamplingMethod::fenwick_tree,
+          SamplingMethod::exponential_keys}) {
+        SUBCASE("Draw every index with nonzero weight")
+        {
+            std::mt19937 rng;
+            Qiskit::addon::sqd::internal::visit_sampler(
+                method, weights,
+                [&](auto &sampler) {
+                    CHECK(sampler.get_remaining_nonzero_weights() == 4);
+                    std::unordered_set<std::size_t> drawn;
+                    for (int i = 0; i < 4; ++i) {
+                        const auto idx = sampler(rng);
+                        CHECK(weights[idx] != 0);
+                        CHECK(drawn.insert(idx).second);
+                    }
+                    CHECK(sampler.get_remaining_nonzero_weights() == 0);
+                    CHECK_THROWS_AS(sampler(rng), std::runtime_error);
+                }
+            );
+        }
+        SUBCASE("First draw follows the weights")
+        {
+            std::mt19937 rng;
+            constexpr int num_trials = 40000;
+            std::vector<int> counts(weights.size());
+            for (int trial = 0; trial < num_trials; ++trial) {
+                Qiskit::addon::sqd::internal::visit_sampler(
+                    method, weights,
+                    [&](auto &sampler) {
+                        ++counts[sampler(rng)];
+                    }
+                );
+            }
+            for (std::size_t i = 0; i < weights.size(); ++i) {
+                CHECK(
+                    static_cast<double>(counts[i]) / num_trials ==
+                    doctest::Approx(weights[i] / 10).epsilon(0.02)
+                );
+            }
+        }
+        SUBCASE("Inline and heap storage draw the same indices")
+        {
+            using Qiskit::addon::sqd::internal::HeapStorage;
+            using Qiskit::addon::sqd::internal::InlineStorage;
+            std::mt19937 weight_rng;
+            std::uniform_real_distribution<double> dist(0.0, 1.0);
+            std::vector<double> many_weights(100);
+            for (auto &weight : many_weights) {
+                weight = dist(weight_rng) < 0.2 ? 0.0 : dist(weight_rng);
+            }
+            const auto draw_all = [&](auto storage) {
+                using Storage = decltype(storage);
+                std::mt19937 rng(3);
+                std::vector<std::size_t> drawn;
+                Qiskit::addon::sqd::internal::visit_sampler_with_storage<Storage>(
+                    method, many_weights,
+                    [&](auto &sampler) {
+                        for (int pass = 0; pass < 2; ++pass) {
+                            sampler.reset();
+                            while (sampler.get_remaining_nonzero_weights() != 0) {
+                                drawn.push_back(sampler(rng));
+                            }
+                        }
+                    }
+                );
+                return drawn;
+            };
+            const auto num_nonzero =
+                many_weights.size() -
+                std::count(many_weights.begin(), many_weights.end(), 0.0);
+            const auto heap_drawn = draw_all(HeapStorage{});
+            CHECK(heap_drawn.size() == 2 * static_cast<std::size_t>(num_nonzero));
+            CHECK(draw_all(InlineStorage<100>{}) == heap_drawn);
+        }
+        SUBCASE("Subsample")
+        {
+            std::vector<std::bitset<4>> bitstrings;
+            for (unsigned int i = 0; i < weights.size(); ++i) {
+                bitstrings.emplace_back(i);
+            }
+            std::mt19937 rng;
+            const auto batch = Qiskit::addon::sqd::subsample(
+                bitstrings, weights, 4, rng, method
+            );
+            CHECK(batch.size() == 4);
+            std::unordered_set<std::bitset<4>> bitstrings_drawn;
+            for (const auto &bitstring : batch) {
+                CHECK(bitstrings_drawn.insert(bitstring).second);
+                CHECK(weights[bitstring.to_ulong()] != 0);
+            }
+            CHECK_THROWS_AS(
+                Qiskit::addon::sqd::subsample(bitstrings, weights, 5, rng, method),
+                std::invalid_argument
+            );
+        }
+    }
+}
+
+TEST_CASE("Reusable subsampler")
+{
+    using Qiskit::addon::sqd::SamplingMethod;
+    std::vector<std::bitset<5>> bitstrings;
+    std::vector<double> weights;
+    for (unsigned int i = 0; i < 20; ++i) {
+        bitstrings.emplace_back(i);
+        weights.push_back(i % 4);
+    }
+    constexpr unsigned int samples_per_batch = 12;
+
+    SUBCASE("Matches fresh subsample calls")
+    {
+        std::mt19937 rng1, rng2;
+        Qiskit::addon::sqd::Subsampler sampler(weights);
+        CHECK(sampler.size() == 20);
+        CHECK(sampler.get_nonzero_weights() == 15);
+        std::vector<std::bitset<5>> batch;
+        for (int i = 0; i < 10; ++i) {
+            sampler(batch, bitstrings, samples_per_batch, rng1);
+            const auto expected = Qiskit::addon::sqd::subsample(
+                bitstrings, weights, samples_per_batch, rng2
+            );
+            CHECK(batch == expected);
+        }
+    }
+    for (auto method :
+         {SamplingMethod::rejection, SamplingMethod::fenwick_tree,
+          SamplingMethod::exponential_keys}) {
+        SUBCASE("Every batch is valid")
+        {
+            std::mt19937 rng;
+            Qiskit::addon::sqd::Subsampler sampler(weights, method);
+            std::vector<std::bitset<5>> batch;
+            for (int i = 0; i < 10; ++i) {
+                sampler(batch, bitstrings, 15, rng);
+                CHECK(batch.size() == 15);
+                std::unordered_set<std::bitset<5>> bitstrings_drawn;
+                for (const auto &bitstring : batch) {
+                    CHECK(bitstrings_drawn.insert(bitstring).second);
+                    CHECK(weights[bitstring.to_ulong()] != 0);
+                }
+            }
+            CHECK_THROWS_AS(sampler(batch, bitstrings, 16, rng), std::invalid_argument);
+        }
+        SUBCASE("Parallel batches do not depend on the number of threads")
+        {
+            Qiskit::addon::sqd::ParallelOptions options;
+            options.seed = 42;
+            options.num_threads = 1;
+            const auto expected = Qiskit::addon::sqd::subsample_multiple_batches(
+                bitstrings, weights, samples_per_batch, 9, options, method
+            );
+            CHECK(expected.size() == 9);
+            for (const auto &batch : expected) {
+                CHECK(batch.size() == samples_per_batch);
+            }
+            for (unsigned int num_threads : {2u, 4u}) {
+                options.num_threads = num_threads;
+                CHECK(
+                    Qiskit::addon::sqd::subsample_multiple_batches(
+                        bitstrings, weights, samples_per_batch, 9, options, method
+                    ) == expected
+                );
+            }
+        }
+    }
+}
+
+TEST_CASE("Subsample indices")
+{
+    std::vector<std::bitset<5>> bitstrings;
+    std::vector<double> weights;
+    for (unsigned int i = 0; i < 20; ++i) {
+        bitstrings.emplace_back(i);
+        weights.push_back(i % 4);
+    }
+    constexpr unsigned int samples_per_batch = 12;
+    constexpr unsigned int num_batches = 5;
+
+    SUBCASE("Single batch")
+    {
+        std::mt19937 rng1, rng2;
+        std::vector<std::uint32_t> indices;
+        Qiskit::addon::sqd::subsample_indices(
+            indices, weights, samples_per_batch, rng1
+        );
+        const auto batch =
+            Qiskit::addon::sqd::subsample(bitstrings, weights, samples_per_batch, rng2);
+        REQUIRE(indices.size() == samples_per_batch);
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            CHECK(bitstrings[indices[i]] == batch[i]);
+        }
+    }
+    SUBCASE("Multiple batches")
+    {
+        std::mt19937 rng1, rng2;
+        const auto index_batches =
+            Qiskit::addon::sqd::subsample_multiple_batches_indices(
+                weights, samples_per_batch, num_batches, rng1
+            );
+        const auto batches = Qiskit::addon::sqd::subsample_multiple_batches(
+            bitstrings, weights, samples_per_batch, num_batches, rng2
+        );
+        REQUIRE(index_batches.size() == num_batches);
+        for (std::size_t b = 0; b < num_batches; ++b) {
+            REQUIRE(index_batches[b].size() == samples_per_batch);
+            for (std::size_t i = 0; i < samples_per_batch; ++i) {
+                CHECK(bitstrings[index_batches[b][i]] == batches[b][i]);
+            }
+        }
+    }
+    SUBCASE("Multiple batches using multiple threads")
+    {
+        Qiskit::addon::sqd::ParallelOptions options;
+        options.seed = 7;
+        options.num_threads = 3;
+        std::vector<std::vector<std::uint32_t>> index_batches;
+        Qiskit::addon::sqd::subsample_multiple_batches_indices(
+            index_batches, weights, samples_per_batch, num_batches, options
+        );
+        const auto batches = Qiskit::addon::sqd::subsample_multiple_batches(
+            bitstrings, weights, samples_per_batch, num_batches, options
+        );
+        REQUIRE(index_batches.size() == num_batches);
+        for (std::size_t b = 0; b < num_batches; ++b) {
+            REQUIRE(index_batches[b].size() == samples_per_batch);
+            for (std::size_t i = 0; i < samples_per_batch; ++i) {
+                CHECK(bitstrings[index_batches[b][i]] == batches[b][i]);
+            }
+        }
+    }
+    SUBCASE("Index type too narrow")
+    {
+        std::mt19937 rng;
+        const std::vector<double> many_weights(300, 1.0);
+        std::vector<std::uint8_t> indices;
+        CHECK_THROWS_AS(
+            Qiskit::addon::sqd::subsample_indices(indices, many_weights, 1, rng),
+            std::invalid_argument
+        );
+    }
+}